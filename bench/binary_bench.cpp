@@ -0,0 +1,257 @@
+/*
+
+  MIT License
+
+  Copyright (c) 2025 Yafiyogi
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+#include <bit>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "benchmark/benchmark.h"
+
+#include "yy_mqtt/yy_mqtt_types.h"
+
+#include "yy_prometheus/yy_prometheus_metric_data.h"
+
+#include "mqtt_handler_binary.h"
+#include "mqtt_handler_json.h"
+#include "prometheus_metric.h"
+
+// Compares the 'cbor' & 'msgpack' handlers with the 'json' handler,
+// extracting the same pointers from the same document. The pointers'
+// metric lists are empty, so only the cost of finding the values is
+// measured.
+
+namespace {
+
+using namespace std::string_view_literals;
+using namespace yafiyogi;
+using namespace yafiyogi::mqtt_bridge;
+
+constexpr std::string_view plug_json{R"({"child_lock":"UNLOCK","current":0.42,"energy":112.87,"indicator_mode":"off/on","linkquality":148,"power":91,"power_outage_memory":"restore","state":"ON","voltage":241})"};
+
+constexpr std::string_view plug_pointers[] = {
+  "/current"sv,
+  "/energy"sv,
+  "/power"sv,
+  "/state"sv,
+  "/voltage"sv
+};
+
+const boost::json::parse_options g_json_options{ .numbers = boost::json::number_precision::none};
+const yy_mqtt::TopicLevelsView g_levels{};
+const TopicFilter g_filter{};
+const TopicMatch g_match{g_levels, g_filter};
+
+// Just enough of an encoder for the plug document.
+class Encoder final
+{
+  public:
+    explicit Encoder(binary::Format p_format) noexcept:
+      m_format(p_format)
+    {
+    }
+
+    Encoder & map(std::uint64_t p_size)
+    {
+      if(binary::Format::Cbor == m_format)
+      {
+        head(5, p_size);
+      }
+      else if(p_size < 16)
+      {
+        byte(0x80 | p_size);
+      }
+      else
+      {
+        byte(0xde);
+        be(p_size, 2);
+      }
+
+      return *this;
+    }
+
+    Encoder & str(std::string_view p_str)
+    {
+      if(binary::Format::Cbor == m_format)
+      {
+        head(3, p_str.size());
+      }
+      else if(p_str.size() < 32)
+      {
+        byte(0xa0 | p_str.size());
+      }
+      else
+      {
+        byte(0xd9);
+        be(p_str.size(), 1);
+      }
+      m_data.append(p_str);
+
+      return *this;
+    }
+
+    Encoder & uint(std::uint64_t p_value)
+    {
+      if(binary::Format::Cbor == m_format)
+      {
+        head(0, p_value);
+      }
+      else if(p_value < 128)
+      {
+        byte(p_value);
+      }
+      else
+      {
+        byte(0xcf);
+        be(p_value, 8);
+      }
+
+      return *this;
+    }
+
+    Encoder & real(double p_value)
+    {
+      byte(binary::Format::Cbor == m_format ? 0xfb : 0xcb);
+      be(std::bit_cast<std::uint64_t>(p_value), 8);
+
+      return *this;
+    }
+
+    [[nodiscard]]
+    const std::string & data() const noexcept
+    {
+      return m_data;
+    }
+
+  private:
+    void byte(std::uint64_t p_byte)
+    {
+      m_data.push_back(static_cast<char>(p_byte));
+    }
+
+    void be(std::uint64_t p_value,
+            int p_size)
+    {
+      for(int shift = (p_size - 1) * 8; shift >= 0; shift -= 8)
+      {
+        byte((p_value >> shift) & 0xff);
+      }
+    }
+
+    void head(std::uint64_t p_major,
+              std::uint64_t p_arg)
+    {
+      if(p_arg < 24)
+      {
+        byte((p_major << 5) | p_arg);
+      }
+      else if(p_arg < 0x100)
+      {
+        byte((p_major << 5) | 24);
+        be(p_arg, 1);
+      }
+      else
+      {
+        byte((p_major << 5) | 27);
+        be(p_arg, 8);
+      }
+    }
+
+    binary::Format m_format;
+    std::string m_data{};
+};
+
+std::string plug_payload(binary::Format p_format)
+{
+  Encoder encoder{p_format};
+
+  encoder.map(9)
+    .str("child_lock"sv).str("UNLOCK"sv)
+    .str("current"sv).real(0.42)
+    .str("energy"sv).real(112.87)
+    .str("indicator_mode"sv).str("off/on"sv)
+    .str("linkquality"sv).uint(148)
+    .str("power"sv).uint(91)
+    .str("power_outage_memory"sv).str("restore"sv)
+    .str("state"sv).str("ON"sv)
+    .str("voltage"sv).uint(241);
+
+  return encoder.data();
+}
+
+void bench_binary(benchmark::State & p_state,
+                  binary::Format p_format)
+{
+  MqttBinaryHandler::builder_type builder{};
+  for(const auto pointer : plug_pointers)
+  {
+    std::ignore = builder.add_pointer(pointer, prometheus::Metrics{});
+  }
+
+  MqttBinaryHandler handler{"bench"sv, p_format, std::move(builder), std::size(plug_pointers)};
+  const auto payload = plug_payload(p_format);
+
+  for(auto _ : p_state)
+  {
+    handler.Event(payload, "zigbee2mqtt/bench"sv, g_match, timestamp_type{}, yy_prometheus::MetricDataVectorPtr{});
+  }
+
+  p_state.SetBytesProcessed(static_cast<int64_t>(p_state.iterations() * payload.size()));
+}
+
+void BM_binary_json_plug(benchmark::State & p_state)
+{
+  MqttJsonHandler::builder_type builder{};
+  for(const auto pointer : plug_pointers)
+  {
+    std::ignore = builder.add_pointer(pointer, prometheus::Metrics{});
+  }
+
+  MqttJsonHandler handler{"bench"sv, g_json_options, std::move(builder), std::size(plug_pointers)};
+
+  for(auto _ : p_state)
+  {
+    handler.Event(plug_json, "zigbee2mqtt/bench"sv, g_match, timestamp_type{}, yy_prometheus::MetricDataVectorPtr{});
+  }
+
+  p_state.SetBytesProcessed(static_cast<int64_t>(p_state.iterations() * plug_json.size()));
+}
+
+void BM_binary_cbor_plug(benchmark::State & p_state)
+{
+  bench_binary(p_state, binary::Format::Cbor);
+}
+
+void BM_binary_msgpack_plug(benchmark::State & p_state)
+{
+  bench_binary(p_state, binary::Format::Msgpack);
+}
+
+} // anonymous namespace
+
+BENCHMARK(BM_binary_json_plug);
+BENCHMARK(BM_binary_cbor_plug);
+BENCHMARK(BM_binary_msgpack_plug);
@@ -0,0 +1,199 @@
+/*
+
+  MIT License
+
+  Copyright (c) 2025 Yafiyogi
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+#include <string_view>
+
+#include "benchmark/benchmark.h"
+
+#include "yy_mqtt/yy_mqtt_types.h"
+
+#include "yy_prometheus/yy_prometheus_metric_data.h"
+
+#include "json_fast_scan.h"
+#include "mqtt_handler_json.h"
+#include "mqtt_handler_json_fast.h"
+#include "prometheus_metric.h"
+
+// Compares the 'json' & 'json-fast' handlers, and shape learning,
+// extracting the same pointers. The pointers' metric lists are empty,
+// so only the cost of finding the values is measured.
+
+namespace {
+
+using namespace std::string_view_literals;
+using namespace yafiyogi;
+using namespace yafiyogi::mqtt_bridge;
+
+// Zigbee2MQTT TRV & plug payloads, as configured in example.yaml.
+constexpr std::string_view trv_payload{R"({"away_mode":"OFF","battery":83,"boost_heating":"OFF","boost_heating_countdown":0,"boost_heating_countdown_time_set":300,"child_lock":"UNLOCK","comfort_temperature":20,"current_heating_setpoint":19.5,"eco_temperature":15,"force":"normal","holidays":[{"hour":6,"minute":0,"temperature":20},{"hour":22,"minute":0,"temperature":15}],"linkquality":116,"local_temperature":19.2,"local_temperature_calibration":-0.5,"max_temperature":30,"min_temperature":5,"position":25,"preset":"schedule","system_mode":"heat","update":{"installed_version":268513281,"latest_version":268513281,"state":"idle"},"valve_detection":"ON","valve_state":"OPEN","week":"5+2","window_detection":"OFF","window_open":false,"workdays":[{"hour":6,"minute":0,"temperature":20},{"hour":8,"minute":0,"temperature":16},{"hour":17,"minute":0,"temperature":20},{"hour":22,"minute":0,"temperature":15}]})"};
+constexpr std::string_view plug_payload{R"({"child_lock":"UNLOCK","current":0.42,"energy":112.87,"indicator_mode":"off/on","linkquality":148,"power":91,"power_outage_memory":"restore","state":"ON","update":{"installed_version":192,"latest_version":192,"state":"idle"},"voltage":241})"};
+
+constexpr std::string_view trv_pointers[] = {
+  "/battery"sv,
+  "/local_temperature"sv,
+  "/local_temperature_calibration"sv,
+  "/current_heating_setpoint"sv,
+  "/position"sv,
+  "/valve_state"sv
+};
+
+constexpr std::string_view plug_pointers[] = {
+  "/current"sv,
+  "/energy"sv,
+  "/power"sv,
+  "/state"sv,
+  "/voltage"sv
+};
+
+const boost::json::parse_options g_json_options{ .numbers = boost::json::number_precision::none};
+const yy_mqtt::TopicLevelsView g_levels{};
+const TopicFilter g_filter{};
+const TopicMatch g_match{g_levels, g_filter};
+
+template<typename Builder, size_t N>
+void add_pointers(Builder & p_builder,
+                  const std::string_view (&p_pointers)[N])
+{
+  for(const auto pointer : p_pointers)
+  {
+    std::ignore = p_builder.add_pointer(pointer, prometheus::Metrics{});
+  }
+}
+
+template<size_t N>
+void bench_json(benchmark::State & p_state,
+                std::string_view p_payload,
+                const std::string_view (&p_pointers)[N])
+{
+  MqttJsonHandler::builder_type builder{};
+  add_pointers(builder, p_pointers);
+
+  MqttJsonHandler handler{"bench"sv, g_json_options, std::move(builder), N};
+
+  for(auto _ : p_state)
+  {
+    handler.Event(p_payload, "zigbee2mqtt/bench"sv, g_match, timestamp_type{}, yy_prometheus::MetricDataVectorPtr{});
+  }
+
+  p_state.SetBytesProcessed(static_cast<int64_t>(p_state.iterations() * p_payload.size()));
+}
+
+template<size_t N>
+void bench_json_shape(benchmark::State & p_state,
+                      std::string_view p_payload,
+                      const std::string_view (&p_pointers)[N])
+{
+  MqttJsonHandler::builder_type builder{};
+  add_pointers(builder, p_pointers);
+
+  MqttJsonHandler handler{"bench"sv, g_json_options, std::move(builder), N};
+  std::ignore = handler.LearnShapes(MqttJsonHandler::default_shape_cache_size);
+
+  for(auto _ : p_state)
+  {
+    handler.Event(p_payload, "zigbee2mqtt/bench"sv, g_match, timestamp_type{}, yy_prometheus::MetricDataVectorPtr{});
+  }
+
+  p_state.SetBytesProcessed(static_cast<int64_t>(p_state.iterations() * p_payload.size()));
+}
+
+template<size_t N>
+void bench_json_fast(benchmark::State & p_state,
+                     std::string_view p_payload,
+                     const std::string_view (&p_pointers)[N])
+{
+  MqttJsonFastHandler::builder_type builder{};
+  add_pointers(builder, p_pointers);
+
+  MqttJsonFastHandler handler{"bench"sv, std::move(builder), N};
+
+  for(auto _ : p_state)
+  {
+    handler.Event(p_payload, "zigbee2mqtt/bench"sv, g_match, timestamp_type{}, yy_prometheus::MetricDataVectorPtr{});
+  }
+
+  p_state.SetBytesProcessed(static_cast<int64_t>(p_state.iterations() * p_payload.size()));
+  p_state.SetLabel(std::string{json_fast::structural_index_isa()});
+}
+
+void bench_structural_index(benchmark::State & p_state,
+                            std::string_view p_payload)
+{
+  json_fast::StructuralIndex index{};
+
+  for(auto _ : p_state)
+  {
+    benchmark::DoNotOptimize(json_fast::structural_index(p_payload, index));
+  }
+
+  p_state.SetBytesProcessed(static_cast<int64_t>(p_state.iterations() * p_payload.size()));
+  p_state.SetLabel(std::string{json_fast::structural_index_isa()});
+}
+
+void BM_json_trv(benchmark::State & p_state)
+{
+  bench_json(p_state, trv_payload, trv_pointers);
+}
+
+void BM_json_fast_trv(benchmark::State & p_state)
+{
+  bench_json_fast(p_state, trv_payload, trv_pointers);
+}
+
+void BM_json_plug(benchmark::State & p_state)
+{
+  bench_json(p_state, plug_payload, plug_pointers);
+}
+
+void BM_json_fast_plug(benchmark::State & p_state)
+{
+  bench_json_fast(p_state, plug_payload, plug_pointers);
+}
+
+void BM_json_shape_trv(benchmark::State & p_state)
+{
+  bench_json_shape(p_state, trv_payload, trv_pointers);
+}
+
+void BM_json_shape_plug(benchmark::State & p_state)
+{
+  bench_json_shape(p_state, plug_payload, plug_pointers);
+}
+
+void BM_structural_index_trv(benchmark::State & p_state)
+{
+  bench_structural_index(p_state, trv_payload);
+}
+
+} // anonymous namespace
+
+BENCHMARK(BM_json_trv);
+BENCHMARK(BM_json_fast_trv);
+BENCHMARK(BM_json_plug);
+BENCHMARK(BM_json_fast_plug);
+BENCHMARK(BM_json_shape_trv);
+BENCHMARK(BM_json_shape_plug);
+BENCHMARK(BM_structural_index_trv);
@@ -0,0 +1,114 @@
+/*
+
+  MIT License
+
+  Copyright (c) 2025 Yafiyogi
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "re2/re2.h"
+
+#include "yy_mqtt/yy_mqtt_types.h"
+
+#include "yy_prometheus/yy_prometheus_metric_data.h"
+
+#include "mqtt_handler_text.h"
+#include "prometheus_metric.h"
+
+// Compares the 'text' handler's single RE2::Set pass with matching each
+// property's pattern in turn. The patterns' metric lists are empty, so
+// only the cost of finding the values is measured.
+
+namespace {
+
+using namespace std::string_view_literals;
+using namespace yafiyogi;
+using namespace yafiyogi::mqtt_bridge;
+
+constexpr std::string_view sensor_payload{"T=21.5 H=40 P=1012 CO2=612 VOC=87 PM25=4 LUX=312 BAT=3.02 RSSI=-71"sv};
+
+// Patterns as made for the properties 'T', 'H', 'P', 'CO2' & 'BAT'.
+constexpr std::string_view sensor_patterns[] = {
+  R"((?:^|[\s,;&])T\s*[=:]\s*([^\s,;&]+))"sv,
+  R"((?:^|[\s,;&])H\s*[=:]\s*([^\s,;&]+))"sv,
+  R"((?:^|[\s,;&])P\s*[=:]\s*([^\s,;&]+))"sv,
+  R"((?:^|[\s,;&])CO2\s*[=:]\s*([^\s,;&]+))"sv,
+  R"((?:^|[\s,;&])BAT\s*[=:]\s*([^\s,;&]+))"sv
+};
+
+const yy_mqtt::TopicLevelsView g_levels{};
+const TopicFilter g_filter{};
+const TopicMatch g_match{g_levels, g_filter};
+
+void BM_text_set(benchmark::State & p_state)
+{
+  MqttTextHandler::builder_type builder{};
+  for(const auto pattern : sensor_patterns)
+  {
+    std::ignore = builder.add_pattern(pattern, prometheus::Metrics{});
+  }
+
+  MqttTextHandler handler{"bench"sv, std::move(builder), std::size(sensor_patterns)};
+
+  for(auto _ : p_state)
+  {
+    handler.Event(sensor_payload, "sensors/bench"sv, g_match, timestamp_type{}, yy_prometheus::MetricDataVectorPtr{});
+  }
+
+  p_state.SetBytesProcessed(static_cast<int64_t>(p_state.iterations() * sensor_payload.size()));
+}
+
+void BM_text_per_pattern(benchmark::State & p_state)
+{
+  re2::RE2::Options options{};
+  options.set_log_errors(false);
+
+  std::vector<std::unique_ptr<re2::RE2>> regexes{};
+  for(const auto pattern : sensor_patterns)
+  {
+    regexes.emplace_back(std::make_unique<re2::RE2>(pattern, options));
+  }
+
+  re2::StringPiece value{};
+  for(auto _ : p_state)
+  {
+    for(const auto & regex : regexes)
+    {
+      if(re2::RE2::PartialMatch(sensor_payload, *regex, &value))
+      {
+        benchmark::DoNotOptimize(value);
+      }
+    }
+  }
+
+  p_state.SetBytesProcessed(static_cast<int64_t>(p_state.iterations() * sensor_payload.size()));
+}
+
+} // anonymous namespace
+
+BENCHMARK(BM_text_set);
+BENCHMARK(BM_text_per_pattern);
@@ -0,0 +1,146 @@
+/*
+
+  MIT License
+
+  Copyright (c) 2025 Yafiyogi
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+#include <functional>
+#include <map>
+#include <string>
+#include <string_view>
+
+#include "benchmark/benchmark.h"
+
+#include "numeric_value.h"
+#include "value_program.h"
+
+// Compares the compiled value actions with the equivalent hand written
+// code (expressions), and an ordered map (switch mappings).
+
+namespace {
+
+using namespace std::string_view_literals;
+using namespace yafiyogi;
+using namespace yafiyogi::mqtt_bridge;
+
+constexpr std::string_view adc_expression{"value * 0.1 - 40"sv};
+
+const values::Switch::Mappings state_mappings{
+  {"online", "1"},
+  {"offline", "0"},
+  {"ON", "1"},
+  {"OFF", "0"},
+  {"OPEN", "1"},
+  {"CLOSED", "0"},
+  {"heat", "1"},
+  {"idle", "0"}
+};
+
+constexpr std::string_view state_keys[] = {"online"sv, "OFF"sv, "heat"sv, "unknown"sv};
+
+values::Expression compile(std::string_view p_source)
+{
+  std::string error{};
+
+  return values::Expression::Compile(p_source, error).value();
+}
+
+void BM_value_expression(benchmark::State & p_state)
+{
+  const auto expression = compile(adc_expression);
+  double value = 512.0;
+
+  for(auto _ : p_state)
+  {
+    benchmark::DoNotOptimize(value);
+    double result = expression.Evaluate(value);
+    benchmark::DoNotOptimize(result);
+  }
+}
+
+void BM_value_expression_native(benchmark::State & p_state)
+{
+  double value = 512.0;
+
+  for(auto _ : p_state)
+  {
+    benchmark::DoNotOptimize(value);
+    double result = value * 0.1 - 40;
+    benchmark::DoNotOptimize(result);
+  }
+}
+
+void BM_value_switch(benchmark::State & p_state)
+{
+  const values::Switch state_switch{state_mappings, std::string{"0"}};
+
+  for(auto _ : p_state)
+  {
+    for(const auto key : state_keys)
+    {
+      benchmark::DoNotOptimize(state_switch.Find(key));
+    }
+  }
+}
+
+void BM_value_switch_map(benchmark::State & p_state)
+{
+  std::map<std::string, std::string, std::less<>> state_map{};
+  for(const auto & [key, value] : state_mappings)
+  {
+    state_map.emplace(key, value);
+  }
+  const std::string default_value{"0"};
+
+  for(auto _ : p_state)
+  {
+    for(const auto key : state_keys)
+    {
+      auto found = state_map.find(key);
+      benchmark::DoNotOptimize(state_map.end() != found ? found->second : default_value);
+    }
+  }
+}
+
+void BM_value_program(benchmark::State & p_state)
+{
+  values::ValueProgram program{};
+  program.add_action(values::Switch{state_mappings, std::string{"0"}});
+  program.add_action(compile("value * 100"sv));
+
+  NumberBuffer buffer{};
+  for(auto _ : p_state)
+  {
+    values::Value value{"online"sv, yy_values::ValueType::String};
+    benchmark::DoNotOptimize(program.Run(value));
+    benchmark::DoNotOptimize(value.Text(buffer));
+  }
+}
+
+} // anonymous namespace
+
+BENCHMARK(BM_value_expression);
+BENCHMARK(BM_value_expression_native);
+BENCHMARK(BM_value_switch);
+BENCHMARK(BM_value_switch_map);
+BENCHMARK(BM_value_program);
@@ -0,0 +1,115 @@
+/*
+
+  MIT License
+
+  Copyright (c) 2025 Yafiyogi
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+#include "fmt/compile.h"
+#include "fmt/format.h"
+
+#include "bridge_stats.h"
+
+namespace yafiyogi::mqtt_bridge::stats {
+namespace {
+
+using namespace std::string_view_literals;
+using namespace fmt::literals;
+
+struct StatFamily final
+{
+    std::string help{};
+    StatType type = StatType::Counter;
+    std::map<std::string, StatPtr, std::less<>> stats{};
+};
+
+using StatFamilies = std::map<std::string, StatFamily, std::less<>>;
+
+std::mutex g_stats_mtx{};
+StatFamilies g_stats{};
+
+constexpr std::string_view decode_type_name(StatType p_type) noexcept
+{
+  return StatType::Gauge == p_type ? "gauge"sv : "counter"sv;
+}
+
+} // anonymous namespace
+
+StatPtr add_stat(std::string_view p_name,
+                 std::string_view p_help,
+                 StatType p_type,
+                 std::string_view p_labels)
+{
+  std::unique_lock lck{g_stats_mtx};
+
+  auto family = g_stats.find(p_name);
+  if(g_stats.end() == family)
+  {
+    family = g_stats.emplace(std::string{p_name},
+                             StatFamily{std::string{p_help}, p_type, {}}).first;
+  }
+
+  auto & family_stats = family->second.stats;
+  auto stat = family_stats.find(p_labels);
+  if(family_stats.end() == stat)
+  {
+    stat = family_stats.emplace(std::string{p_labels}, std::make_shared<Stat>()).first;
+  }
+
+  return stat->second;
+}
+
+void format_stats(StatsBuffer & p_buffer)
+{
+  std::unique_lock lck{g_stats_mtx};
+
+  auto out = std::back_inserter(p_buffer);
+  for(const auto & [name, family] : g_stats)
+  {
+    out = fmt::format_to(out,
+                         "# HELP {} {}\n# TYPE {} {}\n"_cf,
+                         name,
+                         family.help,
+                         name,
+                         decode_type_name(family.type));
+
+    for(const auto & [labels, stat] : family.stats)
+    {
+      if(labels.empty())
+      {
+        out = fmt::format_to(out, "{} {}\n"_cf, name, stat->Value());
+      }
+      else
+      {
+        out = fmt::format_to(out, "{}{{{}}} {}\n"_cf, name, labels, stat->Value());
+      }
+    }
+  }
+}
+
+} // namespace yafiyogi::mqtt_bridge::stats
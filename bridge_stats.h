@@ -0,0 +1,101 @@
+/*
+
+  MIT License
+
+  Copyright (c) 2025 Yafiyogi
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <cstdint>
+
+#include <atomic>
+#include <memory>
+#include <string_view>
+
+#include "yy_cpp/yy_vector.h"
+
+namespace yafiyogi::mqtt_bridge::stats {
+
+// Internal statistics published alongside the bridge's metrics.
+
+enum class StatType:uint8_t {Counter, Gauge};
+
+class Stat final
+{
+  public:
+    constexpr Stat() noexcept = default;
+    Stat(const Stat &) = delete;
+    Stat(Stat &&) = delete;
+
+    Stat & operator=(const Stat &) = delete;
+    Stat & operator=(Stat &&) = delete;
+
+    void Add(std::uint64_t p_value = 1) noexcept
+    {
+      m_value.fetch_add(p_value, std::memory_order_relaxed);
+    }
+
+    void Sub(std::uint64_t p_value = 1) noexcept
+    {
+      m_value.fetch_sub(p_value, std::memory_order_relaxed);
+    }
+
+    void Set(std::uint64_t p_value) noexcept
+    {
+      m_value.store(p_value, std::memory_order_relaxed);
+    }
+
+    // High watermark.
+    void Max(std::uint64_t p_value) noexcept
+    {
+      auto value = m_value.load(std::memory_order_relaxed);
+
+      while((value < p_value)
+            && !m_value.compare_exchange_weak(value, p_value, std::memory_order_relaxed))
+      {
+      }
+    }
+
+    [[nodiscard]]
+    std::uint64_t Value() const noexcept
+    {
+      return m_value.load(std::memory_order_relaxed);
+    }
+
+  private:
+    std::atomic<std::uint64_t> m_value{0};
+};
+
+using StatPtr = std::shared_ptr<Stat>;
+using StatsBuffer = yy_quad::simple_vector<char, yy_data::ClearAction::Keep>;
+
+// Returns the stat for name & labels, creating it if needed. Labels are
+// in exposition format, e.g. 'ingest="0",handler="trv"'.
+StatPtr add_stat(std::string_view p_name,
+                 std::string_view p_help,
+                 StatType p_type,
+                 std::string_view p_labels = std::string_view{});
+
+void format_stats(StatsBuffer & p_buffer);
+
+} // namespace yafiyogi::mqtt_bridge::stats
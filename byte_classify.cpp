@@ -0,0 +1,71 @@
+/*
+
+  MIT License
+
+  Copyright (c) 2025 Yafiyogi
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+#include <string_view>
+
+#include "byte_classify.h"
+
+namespace yafiyogi::mqtt_bridge::byte_classify {
+
+using namespace std::string_view_literals;
+
+Isa cpu_isa() noexcept
+{
+#if defined(MQTT_BRIDGE_BYTE_CLASSIFY_X86)
+  __builtin_cpu_init();
+
+  if(__builtin_cpu_supports("avx2"))
+  {
+    return Isa::Avx2;
+  }
+
+  if(__builtin_cpu_supports("sse4.2"))
+  {
+    return Isa::Sse42;
+  }
+#endif
+
+  return Isa::Scalar;
+}
+
+std::string_view isa_name(Isa p_isa) noexcept
+{
+  switch(p_isa)
+  {
+    case Isa::Avx2:
+      return "avx2"sv;
+
+    case Isa::Sse42:
+      return "sse4.2"sv;
+
+    default:
+      break;
+  }
+
+  return "scalar"sv;
+}
+
+} // namespace yafiyogi::mqtt_bridge::byte_classify
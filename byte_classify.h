@@ -0,0 +1,258 @@
+/*
+
+  MIT License
+
+  Copyright (c) 2025 Yafiyogi
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define MQTT_BRIDGE_BYTE_CLASSIFY_X86 1
+#endif
+
+#include "yy_cpp/yy_types.hpp"
+
+namespace yafiyogi::mqtt_bridge::byte_classify {
+
+inline constexpr size_type block_size = 64;
+
+// Classes of bytes to find in a block, e.g. JSON's quotes, backslashes
+// & structural characters, or a payload's delimiters. The number of
+// bytes in each class is fixed, so the classifiers are unrolled. The
+// bytes themselves are set at run time; repeat a byte to fill an
+// unused slot.
+template<size_type... ClassSizes>
+struct ByteSet final
+{
+    static constexpr size_type class_count = sizeof...(ClassSizes);
+    static constexpr std::array<size_type, class_count> class_sizes{ClassSizes...};
+    static constexpr size_type byte_count = (ClassSizes + ...);
+
+    // The bytes of each class in turn.
+    std::array<char, byte_count> bytes{};
+};
+
+// Bit n of masks[c] is set if byte n of the block is in class c.
+template<typename Set>
+using Masks = std::array<std::uint64_t, Set::class_count>;
+
+template<typename Set>
+using ClassifyFn = Masks<Set> (*)(const char * p_block,
+                                  const Set & p_set) noexcept;
+
+template<typename Set>
+struct Classifier final
+{
+    ClassifyFn<Set> classify = nullptr;
+    // "avx2", "sse4.2" or "scalar".
+    std::string_view isa{};
+};
+
+enum class Isa:uint8_t {Scalar, Sse42, Avx2};
+
+// The widest ISA the CPU supports.
+[[nodiscard]]
+Isa cpu_isa() noexcept;
+
+[[nodiscard]]
+std::string_view isa_name(Isa p_isa) noexcept;
+
+namespace detail {
+
+// Index of the first byte of class Class.
+template<typename Set, size_type Class>
+inline constexpr size_type class_first = []<size_type... Prev>(std::index_sequence<Prev...>) {
+  return (size_type{0} + ... + Set::class_sizes[Prev]);
+}(std::make_index_sequence<Class>{});
+
+template<typename Set>
+Masks<Set> classify_scalar(const char * p_block,
+                           const Set & p_set) noexcept
+{
+  Masks<Set> masks{};
+
+  for(size_type idx = 0; idx < block_size; ++idx)
+  {
+    const char ch = p_block[idx];
+    size_type byte = 0;
+
+    for(size_type cls = 0; cls < Set::class_count; ++cls)
+    {
+      for(const size_type end = byte + Set::class_sizes[cls]; byte < end; ++byte)
+      {
+        if(ch == p_set.bytes[byte])
+        {
+          masks[cls] |= std::uint64_t{1} << idx;
+        }
+      }
+    }
+  }
+
+  return masks;
+}
+
+#if defined(MQTT_BRIDGE_BYTE_CLASSIFY_X86)
+
+template<typename Set, size_type Class>
+__attribute__((target("sse4.2"), always_inline))
+inline std::uint64_t find_sse42(__m128i p_chunk,
+                                const __m128i * p_wanted) noexcept
+{
+  constexpr size_type first = class_first<Set, Class>;
+
+  __m128i found = _mm_cmpeq_epi8(p_chunk, p_wanted[first]);
+  for(size_type byte = first + 1; byte < first + Set::class_sizes[Class]; ++byte)
+  {
+    found = _mm_or_si128(found, _mm_cmpeq_epi8(p_chunk, p_wanted[byte]));
+  }
+
+  return static_cast<std::uint16_t>(_mm_movemask_epi8(found));
+}
+
+template<typename Set, size_type... Class>
+__attribute__((target("sse4.2"), always_inline))
+inline void classify_sse42(__m128i p_chunk,
+                           const __m128i * p_wanted,
+                           size_type p_offset,
+                           Masks<Set> & p_masks,
+                           std::index_sequence<Class...>) noexcept
+{
+  ((p_masks[Class] |= find_sse42<Set, Class>(p_chunk, p_wanted) << p_offset), ...);
+}
+
+template<typename Set>
+__attribute__((target("sse4.2")))
+Masks<Set> classify_sse42(const char * p_block,
+                          const Set & p_set) noexcept
+{
+  __m128i wanted[Set::byte_count];
+  for(size_type byte = 0; byte < Set::byte_count; ++byte)
+  {
+    wanted[byte] = _mm_set1_epi8(p_set.bytes[byte]);
+  }
+
+  Masks<Set> masks{};
+
+  for(size_type offset = 0; offset < block_size; offset += 16)
+  {
+    const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p_block + offset));
+
+    classify_sse42<Set>(chunk, wanted, offset, masks, std::make_index_sequence<Set::class_count>{});
+  }
+
+  return masks;
+}
+
+template<typename Set, size_type Class>
+__attribute__((target("avx2"), always_inline))
+inline std::uint64_t find_avx2(__m256i p_chunk,
+                               const __m256i * p_wanted) noexcept
+{
+  constexpr size_type first = class_first<Set, Class>;
+
+  __m256i found = _mm256_cmpeq_epi8(p_chunk, p_wanted[first]);
+  for(size_type byte = first + 1; byte < first + Set::class_sizes[Class]; ++byte)
+  {
+    found = _mm256_or_si256(found, _mm256_cmpeq_epi8(p_chunk, p_wanted[byte]));
+  }
+
+  return static_cast<std::uint32_t>(_mm256_movemask_epi8(found));
+}
+
+template<typename Set, size_type... Class>
+__attribute__((target("avx2"), always_inline))
+inline void classify_avx2(__m256i p_chunk,
+                          const __m256i * p_wanted,
+                          size_type p_offset,
+                          Masks<Set> & p_masks,
+                          std::index_sequence<Class...>) noexcept
+{
+  ((p_masks[Class] |= find_avx2<Set, Class>(p_chunk, p_wanted) << p_offset), ...);
+}
+
+template<typename Set>
+__attribute__((target("avx2")))
+Masks<Set> classify_avx2(const char * p_block,
+                         const Set & p_set) noexcept
+{
+  __m256i wanted[Set::byte_count];
+  for(size_type byte = 0; byte < Set::byte_count; ++byte)
+  {
+    wanted[byte] = _mm256_set1_epi8(p_set.bytes[byte]);
+  }
+
+  Masks<Set> masks{};
+
+  for(size_type offset = 0; offset < block_size; offset += 32)
+  {
+    const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p_block + offset));
+
+    classify_avx2<Set>(chunk, wanted, offset, masks, std::make_index_sequence<Set::class_count>{});
+  }
+
+  return masks;
+}
+
+#endif
+
+template<typename Set>
+Classifier<Set> select_classifier() noexcept
+{
+  const auto isa = cpu_isa();
+
+  switch(isa)
+  {
+#if defined(MQTT_BRIDGE_BYTE_CLASSIFY_X86)
+    case Isa::Avx2:
+      return Classifier<Set>{&classify_avx2<Set>, isa_name(isa)};
+
+    case Isa::Sse42:
+      return Classifier<Set>{&classify_sse42<Set>, isa_name(isa)};
+#endif
+
+    default:
+      break;
+  }
+
+  return Classifier<Set>{&classify_scalar<Set>, isa_name(Isa::Scalar)};
+}
+
+} // namespace detail
+
+// The fastest classifier for Set the CPU supports, chosen on first use.
+template<typename Set>
+[[nodiscard]]
+const Classifier<Set> & classifier() noexcept
+{
+  static const Classifier<Set> g_classifier{detail::select_classifier<Set>()};
+
+  return g_classifier;
+}
+
+} // namespace yafiyogi::mqtt_bridge::byte_classify
@@ -24,15 +24,24 @@
 
 */
 
+#include <algorithm>
 #include <string>
+#include <string_view>
 
+#include "fmt/compile.h"
+#include "fmt/format.h"
 #include "spdlog/spdlog.h"
 
+#include "yy_cpp/yy_make_lookup.h"
+#include "yy_cpp/yy_string_case.h"
+#include "yy_cpp/yy_string_util.h"
 #include "yy_cpp/yy_yaml_util.h"
 
 #include "configure_mqtt_handlers.h"
 #include "configure_mqtt_topics.h"
+#include "configure_prometheus.h"
 #include "mqtt_handler.h"
+#include "mqtt_handler_sparkplug.h"
 #include "prometheus_config.h"
 
 #include "configure_mqtt.h"
@@ -41,8 +50,151 @@ namespace yafiyogi::mqtt_bridge {
 
 using namespace std::string_literals;
 using namespace std::string_view_literals;
+using namespace fmt::literals;
+
+namespace {
+
+constexpr auto overload_policies =
+  yy_data::make_lookup<std::string_view, OverloadPolicy>(OverloadPolicy::Block,
+                                                         {{"block"sv, OverloadPolicy::Block},
+                                                          {"drop-newest"sv, OverloadPolicy::DropNewest},
+                                                          {"drop-oldest"sv, OverloadPolicy::DropOldest}});
+
+constexpr std::string_view overload_name(OverloadPolicy p_overload) noexcept
+{
+  switch(p_overload)
+  {
+    case OverloadPolicy::DropNewest:
+      return "drop-newest"sv;
+
+    case OverloadPolicy::DropOldest:
+      return "drop-oldest"sv;
+
+    case OverloadPolicy::Block:
+      [[fallthrough]];
+    default:
+      return "block"sv;
+  }
+}
+
+mqtt_pipeline_config configure_pipeline(const YAML::Node & yaml_pipeline)
+{
+  mqtt_pipeline_config pipeline{};
+
+  if(yaml_pipeline)
+  {
+    pipeline.workers = yy_util::yaml_get_value(yaml_pipeline["workers"sv], pipeline.workers);
+    pipeline.queue_size = std::max(yy_util::yaml_get_value(yaml_pipeline["queue_size"sv], pipeline.queue_size),
+                                   size_type{2});
+
+    std::string overload = yy_util::to_lower(yy_util::trim(yy_util::yaml_get_value(yaml_pipeline["overload"sv], "block"sv)));
+    pipeline.overload = overload_policies.lookup(overload);
+
+    if(auto yaml_retained = yaml_pipeline["retained"sv];
+       yaml_retained)
+    {
+      auto & retained = pipeline.retained;
+
+      retained.rate = yy_util::yaml_get_value(yaml_retained["rate"sv], retained.rate);
+      retained.burst = std::max(yy_util::yaml_get_value(yaml_retained["burst"sv], retained.burst),
+                                size_type{1});
+      retained.queue_size = std::max(yy_util::yaml_get_value(yaml_retained["queue_size"sv], retained.queue_size),
+                                     size_type{2});
+    }
+  }
+
+  if(0 == pipeline.workers)
+  {
+    spdlog::info(" MQTT pipeline off"sv);
+  }
+  else
+  {
+    spdlog::info(" MQTT pipeline workers=[{}] queue_size=[{}] overload=[{}]"sv,
+                 pipeline.workers,
+                 pipeline.queue_size,
+                 overload_name(pipeline.overload));
+
+    if(0 != pipeline.retained.rate)
+    {
+      spdlog::info(" MQTT pipeline retained rate=[{}/s] burst=[{}] queue_size=[{}]"sv,
+                   pipeline.retained.rate,
+                   pipeline.retained.burst,
+                   pipeline.retained.queue_size);
+    }
+  }
+
+  return pipeline;
+}
+
+mqtt_subscribe_config configure_subscribe(const YAML::Node & yaml_subscribe)
+{
+  mqtt_subscribe_config subscribe{};
+
+  if(yaml_subscribe)
+  {
+    // A filter too long for a packet is sent in a packet of its own.
+    subscribe.max_packet_size = std::max(yy_util::yaml_get_value(yaml_subscribe["max_packet_size"sv], subscribe.max_packet_size),
+                                         size_type{1024});
+    subscribe.max_outstanding = std::max(yy_util::yaml_get_value(yaml_subscribe["max_outstanding"sv], subscribe.max_outstanding),
+                                         size_type{1});
+  }
+
+  spdlog::info(" MQTT subscribe max_packet_size=[{}] max_outstanding=[{}]"sv,
+               subscribe.max_packet_size,
+               subscribe.max_outstanding);
+
+  return subscribe;
+}
+
+constexpr std::string_view g_default_share_group{"mqtt_bridge"};
+
+// MQTT5 servers don't send retained messages to shared subscriptions,
+// so topics only published retained (e.g. availability) have no state
+// until they're next published.
+void warn_shared_subscriptions(const Subscriptions & p_subscriptions,
+                               std::string_view p_share_group)
+{
+  if(std::ranges::any_of(p_subscriptions, [](const auto & sub) { return !sub.exclusive; }))
+  {
+    spdlog::warn(" MQTT shared subscriptions aren't sent retained messages."
+                 " Set 'shared: false' on topics published retained only."sv);
+  }
+
+  for(const auto & sub : p_subscriptions)
+  {
+    if(!sub.exclusive)
+    {
+      std::string_view filter{sub.filter};
+      if(constexpr std::string_view share_prefix{"$share/"};
+         filter.starts_with(share_prefix))
+      {
+        filter.remove_prefix(share_prefix.size());
+        filter.remove_prefix(std::min(filter.find('/'), filter.size() - 1) + 1);
+      }
+
+      if(filter.starts_with(MqttSparkplugHandler::topic_namespace))
+      {
+        spdlog::warn(" MQTT sparkplug topic [{}] is shared. A node's births & data"
+                     " may be handled out of order. Set 'shared: false'."sv,
+                     sub.filter);
+      }
+      continue;
+    }
+
+    auto shared_filter{fmt::format("$share/{}/{}"_cf, p_share_group, sub.filter)};
+    if(std::ranges::binary_search(p_subscriptions, shared_filter, {}, &Subscription::filter))
+    {
+      spdlog::warn(" MQTT topic [{}] is subscribed to shared and not shared."
+                   " The first connection handles its messages twice."sv,
+                   sub.filter);
+    }
+  }
+}
+
+} // anonymous namespace
 
 mqtt_config configure_mqtt(const YAML::Node & yaml_mqtt,
+                           const YAML::Node & yaml_prometheus,
                            prometheus::config & p_prometheus_config)
 {
   const auto yaml_host = yaml_mqtt["host"sv];
@@ -58,15 +210,71 @@ mqtt_config configure_mqtt(const YAML::Node & yaml_mqtt,
 
   spdlog::info(" MQTT host=[{}] port=[{}]"sv, host, port);
 
+  const size_type connections = std::max(yy_util::yaml_get_value(yaml_mqtt["connections"sv], size_type{1}),
+                                         size_type{1});
+  std::string_view share_group{};
+
+  if(connections > 1)
+  {
+    share_group = yy_util::trim(yy_util::yaml_get_value(yaml_mqtt["share_group"sv], g_default_share_group));
+    spdlog::info(" MQTT connections=[{}] share_group=[{}]"sv, connections, share_group);
+  }
+
+  const int qos = std::clamp(yy_util::yaml_get_value(yaml_mqtt["qos"sv], 0), 0, 2);
+  const int receive_maximum = std::clamp(yy_util::yaml_get_value(yaml_mqtt["receive_maximum"sv], 0), 0, 65535);
+  spdlog::info(" MQTT qos=[{}] receive_maximum=[{}]"sv, qos, receive_maximum);
+
+  auto subscribe{configure_subscribe(yaml_mqtt["subscribe"sv])};
+  auto pipeline{configure_pipeline(yaml_mqtt["pipeline"sv])};
+  const size_type ingest_count = connections * std::max(pipeline.workers, size_type{1});
+
+  const size_type route_cache_size = std::max(yy_util::yaml_get_value(yaml_mqtt["route_cache_size"sv],
+                                                                      mqtt_ingest_config::default_route_cache_size),
+                                              size_type{1});
+  spdlog::info(" MQTT route cache size=[{}]"sv, route_cache_size);
+
+  mqtt_ingest_configs ingests{};
+  ingests.reserve(ingest_count);
+
   auto handlers{configure_mqtt_handlers(yaml_mqtt["handlers"sv], p_prometheus_config)};
 
-  auto [subscriptions, topics] = configure_mqtt_topics(yaml_mqtt["topics"sv], handlers);
+  auto [subscriptions, topics] = configure_mqtt_topics(yaml_mqtt["topics"sv], handlers, share_group, qos);
+
+  if(connections > 1)
+  {
+    warn_shared_subscriptions(subscriptions, share_group);
+  }
+
+  ingests.emplace_back(mqtt_ingest_config{0,
+                                          std::move(handlers),
+                                          std::move(topics),
+                                          route_cache_size});
+
+  // Handlers & metrics aren't shareable between threads, so
+  // configure a set for each additional connection/worker.
+  for(size_type worker = 1; worker < ingest_count; ++worker)
+  {
+    spdlog::info(" Configuring MQTT worker [{}]."sv, worker);
+
+    prometheus::config worker_prometheus_config{.metrics = prometheus::configure_metrics(yaml_prometheus)};
+    auto worker_handlers{configure_mqtt_handlers(yaml_mqtt["handlers"sv], worker_prometheus_config)};
+    auto worker_topics{configure_mqtt_topics(yaml_mqtt["topics"sv], worker_handlers, share_group, qos)};
+
+    ingests.emplace_back(mqtt_ingest_config{worker,
+                                            std::move(worker_handlers),
+                                            std::move(worker_topics.topics),
+                                            route_cache_size});
+  }
 
   return mqtt_config{std::string{host},
                      port,
-                     std::move(handlers),
+                     connections,
+                     std::string{share_group},
+                     receive_maximum,
+                     subscribe,
+                     pipeline,
                      std::move(subscriptions),
-                     std::move(topics)};
+                     std::move(ingests)};
 }
 
 } // namespace yafiyogi::mqtt_bridge
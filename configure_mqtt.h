@@ -26,25 +26,65 @@
 
 #pragma once
 
+#include "yy_cpp/yy_types.hpp"
+#include "yy_cpp/yy_vector.h"
+
 #include "yy_mqtt/yy_mqtt_constants.h"
 
 #include "yy_tp_util/yaml_fwd.h"
 
+#include "mqtt_handler_fwd.h"
+#include "mqtt_ingest.h"
+#include "mqtt_pipeline.h"
 #include "mqtt_topics.h"
 #include "prometheus_config_fwd.h"
 
 namespace yafiyogi::mqtt_bridge {
 
+struct mqtt_pipeline_config final
+{
+    static constexpr size_type default_queue_size = 4096;
+
+    // Zero workers processes messages on the MQTT network thread.
+    size_type workers = 0;
+    size_type queue_size = default_queue_size;
+    OverloadPolicy overload = OverloadPolicy::Block;
+    RetainedConfig retained{};
+};
+
+// Subscriptions are sent in SUBSCRIBE packets of up to
+// 'max_packet_size' bytes (or the server's maximum packet size if
+// smaller), with up to 'max_outstanding' packets waiting for their
+// SUBACK.
+struct mqtt_subscribe_config final
+{
+    static constexpr size_type default_max_packet_size = 65536;
+    static constexpr size_type default_max_outstanding = 16;
+
+    size_type max_packet_size = default_max_packet_size;
+    size_type max_outstanding = default_max_outstanding;
+};
+
 struct mqtt_config final
 {
     std::string host{};
     int port = yy_mqtt::mqtt_default_port;
-    MqttHandlerStore handlers{};
+    // Connections > 1 subscribe using MQTT5 shared subscriptions, so
+    // the broker load balances messages between the connections.
+    size_type connections = 1;
+    std::string share_group{};
+    // MQTT5 receive maximum: QoS 1 & 2 messages the broker may have in
+    // flight to a connection. Zero leaves the broker's default.
+    int receive_maximum = 0;
+    mqtt_subscribe_config subscribe{};
+    mqtt_pipeline_config pipeline{};
     Subscriptions subscriptions{};
-    Topics topics{};
+    // One per connection, or per worker when the pipeline is on.
+    mqtt_ingest_configs ingests{};
 };
 
 mqtt_config configure_mqtt(const YAML::Node & yaml_mqtt,
+                           const YAML::Node & yaml_prometheus,
                            prometheus::config & prometheus_config);
 
 } // namespace yafiyogi::mqtt_bridge
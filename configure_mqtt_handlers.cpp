@@ -24,11 +24,16 @@
 
 */
 
+#include <algorithm>
 #include <memory>
+#include <optional>
 #include <string_view>
+#include <tuple>
+#include <vector>
 
 #include "fmt/format.h"
 #include "fmt/compile.h"
+#include "re2/re2.h"
 #include "spdlog/spdlog.h"
 
 #include "yy_cpp/yy_flat_set.h"
@@ -40,7 +45,12 @@
 #include "yy_values/yy_values_metric_id_fmt.hpp"
 
 #include "mqtt_handler.h"
+#include "mqtt_handler_binary.h"
+#include "mqtt_handler_delimited.h"
 #include "mqtt_handler_json.h"
+#include "mqtt_handler_json_fast.h"
+#include "mqtt_handler_sparkplug.h"
+#include "mqtt_handler_text.h"
 #include "mqtt_handler_value.h"
 #include "prometheus_config.h"
 
@@ -57,7 +67,13 @@ const boost::json::parse_options g_json_options{ .numbers = boost::json::number_
 
 constexpr auto handler_types =
   yy_data::make_lookup<std::string_view, MqttHandler::type>(MqttHandler::type::Json,
-                                                            {{"json"sv, MqttHandler::type::Json},
+                                                            {{"cbor"sv, MqttHandler::type::Cbor},
+                                                             {"csv"sv, MqttHandler::type::Csv},
+                                                             {"json"sv, MqttHandler::type::Json},
+                                                             {"json-fast"sv, MqttHandler::type::JsonFast},
+                                                             {"logfmt"sv, MqttHandler::type::Logfmt},
+                                                             {"msgpack"sv, MqttHandler::type::Msgpack},
+                                                             {"sparkplug"sv, MqttHandler::type::Sparkplug},
                                                              {"text"sv, MqttHandler::type::Text},
                                                              {"value"sv, MqttHandler::type::Value}});
 
@@ -69,104 +85,456 @@ MqttHandler::type decode_type(const YAML::Node & yaml_type)
   return handler_types.lookup(type_name);
 }
 
-MqttHandlerPtr configure_json_handler(std::string_view p_id,
-                                      const YAML::Node & yaml_json_handler,
-                                      prometheus::MetricsMap & prometheus_metrics)
+constexpr auto decode_stages =
+  yy_data::make_lookup<std::string_view, decode::Stage>(decode::Stage::None,
+                                                        {{"base64"sv, decode::Stage::Base64},
+                                                         {"deflate"sv, decode::Stage::Deflate},
+                                                         {"gzip"sv, decode::Stage::Gzip},
+                                                         {"zlib"sv, decode::Stage::Zlib}});
+
+// Reads a handler's 'decode' stages: a stage name, or a sequence of
+// stage names. Returns std::nullopt if a stage is unknown, or there are
+// too many stages.
+std::optional<decode::Chain> configure_decode(const YAML::Node & yaml_decode)
 {
-  MqttHandlerPtr mqtt_json_handler{};
-  auto yaml_properties = yaml_json_handler["properties"sv];
-  if(yaml_properties && (0 != yaml_properties.size()))
+  decode::Chain chain{};
+
+  auto do_add_stage = [&chain](const YAML::Node & yaml_stage) {
+    std::string stage_name = yy_util::to_lower(yy_util::trim(yy_util::yaml_get_value<std::string_view>(yaml_stage)));
+
+    if(const auto stage = decode_stages.lookup(stage_name);
+       decode::Stage::None == stage)
+    {
+      spdlog::error("Unknown decode stage [{}] [line {}]."sv,
+                    stage_name,
+                    yaml_stage.Mark().line + 1);
+      return false;
+    }
+    else if(!chain.add_stage(stage))
+    {
+      spdlog::error("Too many decode stages, the maximum is [{}] [line {}]."sv,
+                    decode::Chain::max_stages,
+                    yaml_stage.Mark().line + 1);
+      return false;
+    }
+
+    return true;
+  };
+
+  if(yaml_decode)
   {
-    MqttJsonHandler::builder_type json_pointer_builder{};
-    int metrics_count = 0;
-    std::string json_pointer{};
-    std::string_view property{};
-
-    auto do_add_property = [&property, &json_pointer, &json_pointer_builder, &metrics_count]
-                           (auto visitor_prometheus_metrics, auto /* pos */) {
-      if(nullptr != visitor_prometheus_metrics)
+    if(yaml_decode.IsSequence())
+    {
+      for(const auto & yaml_stage : yaml_decode)
       {
-        auto [builder_metrics, added] = json_pointer_builder.add_pointer(json_pointer,
-                                                                         prometheus::Metrics{});
-        if(nullptr != builder_metrics)
+        if(!do_add_stage(yaml_stage))
         {
-          for(auto & metric : *visitor_prometheus_metrics)
+          return std::nullopt;
+        }
+      }
+    }
+    else if(!do_add_stage(yaml_decode))
+    {
+      return std::nullopt;
+    }
+  }
+
+  return chain;
+}
+
+// Adds the handler's property paths (e.g. json pointers) & their
+// metrics using p_add_path(path, metrics). Properties are a sequence of
+// property names, or a map of paths to property names. p_make_path()
+// makes the path of a property name, or normalizes a configured path.
+// Returns the number of metrics added.
+template<typename AddPath,
+         typename MakePath>
+int configure_property_paths(std::string_view p_id,
+                             const YAML::Node & yaml_properties,
+                             prometheus::MetricsMap & prometheus_metrics,
+                             AddPath && p_add_path,
+                             MakePath && p_make_path)
+{
+  int metrics_count = 0;
+  std::string path{};
+  std::string_view property{};
+
+  auto do_add_property = [&property, &path, &p_add_path, &metrics_count]
+                         (auto visitor_prometheus_metrics, auto /* pos */) {
+    if(nullptr != visitor_prometheus_metrics)
+    {
+      auto [builder_metrics, added] = p_add_path(path, prometheus::Metrics{});
+      if(nullptr != builder_metrics)
+      {
+        for(auto & metric : *visitor_prometheus_metrics)
+        {
+          if(metric && (metric->Property() == property))
           {
-            if(metric && (metric->Property() == property))
-            {
-              ++metrics_count;
-              spdlog::info("       metric [{}] added."sv,
-                           metric->Id());
-              builder_metrics->emplace_back(std::move(metric));
-            }
+            ++metrics_count;
+            spdlog::info("       metric [{}] added."sv,
+                         metric->Id());
+            builder_metrics->emplace_back(std::move(metric));
           }
         }
       }
-    };
+    }
+  };
 
-    yy_data::flat_set<std::string_view> properties{};
-    properties.reserve(yaml_properties.size());
+  yy_data::flat_set<std::string_view> properties{};
+  properties.reserve(yaml_properties.size());
 
-    spdlog::trace("        [line {}]."sv,
-                  yaml_properties.Mark().line + 1);
-    if(const bool is_sequence = yaml_properties.IsSequence();
-       is_sequence || yaml_properties.IsMap())
+  spdlog::trace("        [line {}]."sv,
+                yaml_properties.Mark().line + 1);
+  if(const bool is_sequence = yaml_properties.IsSequence();
+     is_sequence || yaml_properties.IsMap())
+  {
+    for(const auto & yaml_property : yaml_properties)
     {
-      for(const auto & yaml_property : yaml_properties)
+      if(is_sequence && yaml_property.IsScalar())
+      {
+        property = yy_util::trim(yaml_property.as<std::string_view>());
+        path = p_make_path(property, true);
+      }
+      else if(!is_sequence)
+      {
+        property = yy_util::trim(yy_util::yaml_get_value<std::string_view>(yaml_property.second));
+        path = p_make_path(yy_util::trim(yy_util::yaml_get_value<std::string_view>(yaml_property.first)), false);
+      }
+
+      spdlog::info("     - property [{}] path=[{}]:"sv,
+                   property,
+                   path);
+
+      if(!path.empty()
+         && !property.empty())
       {
-        if(is_sequence && yaml_property.IsScalar())
+        // Avoid duplicates.
+        if(auto [ignore, inserted] = properties.emplace(property);
+           inserted)
         {
-          property = yy_util::trim(yaml_property.as<std::string_view>());
-          json_pointer = yy_json::json_pointer_trim(fmt::format("/{}"_cf, property));
+          std::ignore = prometheus_metrics.find_value(do_add_property, p_id);
         }
-        else if(!is_sequence)
+        else
         {
-          property = yy_util::trim(yy_util::yaml_get_value<std::string_view>(yaml_property.second));
-          json_pointer = yy_json::json_pointer_trim(yy_util::trim(yy_util::yaml_get_value<std::string_view>(yaml_property.first)));
+          spdlog::warn("   * already added!"sv);
         }
+      }
+    }
+  }
+
+  return metrics_count;
+}
+
+std::string make_json_pointer(std::string_view p_path,
+                              bool p_is_property)
+{
+  if(p_is_property)
+  {
+    return yy_json::json_pointer_trim(fmt::format("/{}"_cf, p_path));
+  }
+
+  return yy_json::json_pointer_trim(p_path);
+}
 
-        spdlog::info("     - property [{}] path=[{}]:"sv,
-                     property,
-                     json_pointer);
+template<typename Builder>
+int configure_json_pointers(std::string_view p_id,
+                            const YAML::Node & yaml_properties,
+                            prometheus::MetricsMap & prometheus_metrics,
+                            Builder & p_builder)
+{
+  auto add_pointer = [&p_builder](std::string_view p_pointer, prometheus::Metrics && p_metrics) {
+    return p_builder.add_pointer(p_pointer, std::move(p_metrics));
+  };
 
-        if(!json_pointer.empty()
-           && !property.empty())
+  return configure_property_paths(p_id, yaml_properties, prometheus_metrics, add_pointer, make_json_pointer);
+}
+
+MqttHandlerPtr configure_json_handler(std::string_view p_id,
+                                      const YAML::Node & yaml_json_handler,
+                                      prometheus::MetricsMap & prometheus_metrics)
+{
+  MqttHandlerPtr mqtt_json_handler{};
+  auto yaml_properties = yaml_json_handler["properties"sv];
+  if(yaml_properties && (0 != yaml_properties.size()))
+  {
+    MqttJsonHandler::builder_type json_pointers{};
+
+    if(const int metrics_count = configure_json_pointers(p_id, yaml_properties, prometheus_metrics, json_pointers);
+       metrics_count > 0)
+    {
+      if(std::ranges::any_of(json_pointers, [](const auto & json_pointer) {
+        return json_fast::PointerTree::has_wildcard(json_pointer.pointer);
+      }))
+      {
+        // The json pointer automaton only matches fixed pointers.
+        spdlog::warn("   - wildcard properties: using a 'json-fast' handler,"
+                     " not combined with other 'json' handlers."sv);
+
+        for(const auto option : {"learn_shape"sv, "shape_cache_size"sv})
+        {
+          if(yaml_json_handler[option])
+          {
+            spdlog::warn("   * ignoring [{}] [line {}]: not used by 'json-fast' handlers!"sv,
+                         option,
+                         yaml_json_handler[option].Mark().line + 1);
+          }
+        }
+
+        MqttJsonFastHandler::builder_type pointer_tree{};
+        for(const auto & [pointer, metrics] : json_pointers)
+        {
+          prometheus::Metrics pointer_metrics{};
+          pointer_metrics.reserve(metrics.size());
+          for(const auto & metric : metrics)
+          {
+            pointer_metrics.emplace_back(metric);
+          }
+
+          if(auto [tree_metrics, added] = pointer_tree.add_pointer(pointer, std::move(pointer_metrics));
+             nullptr == tree_metrics)
+          {
+            spdlog::warn("   * invalid path [{}]!"sv, pointer);
+          }
+        }
+
+        mqtt_json_handler = std::make_unique<MqttJsonFastHandler>(p_id,
+                                                                  std::move(pointer_tree),
+                                                                  metrics_count);
+      }
+      else
+      {
+        auto json_handler = std::make_unique<MqttJsonHandler>(p_id,
+                                                              g_json_options,
+                                                              std::move(json_pointers),
+                                                              metrics_count);
+
+        if(yy_util::yaml_get_value(yaml_json_handler["learn_shape"sv], false))
         {
-          // Avoid duplicates.
-          if(auto [ignore, inserted] = properties.emplace(property);
-             inserted)
+          const size_type shape_cache_size = std::max(yy_util::yaml_get_value(yaml_json_handler["shape_cache_size"sv],
+                                                                               MqttJsonHandler::default_shape_cache_size),
+                                                      size_type{1});
+
+          if(json_handler->LearnShapes(shape_cache_size))
           {
-            std::ignore = prometheus_metrics.find_value(do_add_property, p_id);
+            spdlog::info("   - learn payload shapes cache size=[{}]"sv, shape_cache_size);
           }
           else
           {
-            spdlog::warn("   * already added!"sv);
+            spdlog::warn("   * can't learn shapes: properties must be top level json keys!"sv);
           }
         }
+
+        mqtt_json_handler = std::move(json_handler);
       }
     }
+  }
 
-    if(metrics_count > 0)
+  return mqtt_json_handler;
+}
+
+MqttHandlerPtr configure_json_fast_handler(std::string_view p_id,
+                                           const YAML::Node & yaml_json_handler,
+                                           prometheus::MetricsMap & prometheus_metrics)
+{
+  MqttHandlerPtr mqtt_json_handler{};
+  auto yaml_properties = yaml_json_handler["properties"sv];
+  if(yaml_properties && (0 != yaml_properties.size()))
+  {
+    MqttJsonFastHandler::builder_type json_pointers{};
+
+    if(const int metrics_count = configure_json_pointers(p_id, yaml_properties, prometheus_metrics, json_pointers);
+       metrics_count > 0)
     {
-      auto create_json_pointer_config = [&json_pointer_builder]() {
-        return json_pointer_builder.create(g_json_options.max_depth);
-      };
+      spdlog::info("   - structural index [{}]"sv, json_fast::structural_index_isa());
 
-      mqtt_json_handler = std::make_unique<MqttJsonHandler>(p_id,
-                                                            g_json_options,
-                                                            create_json_pointer_config(),
-                                                            metrics_count);
+      mqtt_json_handler = std::make_unique<MqttJsonFastHandler>(p_id,
+                                                                std::move(json_pointers),
+                                                                metrics_count);
     }
   }
 
   return mqtt_json_handler;
 }
 
-MqttHandlerPtr configure_text_handler(std::string_view /* p_id */,
-                                      const YAML::Node & /* yaml_text_handler */,
-                                      prometheus::MetricsMap & /* prometheus_metrics */)
+MqttHandlerPtr configure_binary_handler(std::string_view p_id,
+                                        const YAML::Node & yaml_binary_handler,
+                                        prometheus::MetricsMap & prometheus_metrics,
+                                        MqttBinaryHandler::Format p_format)
+{
+  MqttHandlerPtr mqtt_binary_handler{};
+  auto yaml_properties = yaml_binary_handler["properties"sv];
+  if(yaml_properties && (0 != yaml_properties.size()))
+  {
+    MqttBinaryHandler::builder_type json_pointers{};
+
+    if(const int metrics_count = configure_json_pointers(p_id, yaml_properties, prometheus_metrics, json_pointers);
+       metrics_count > 0)
+    {
+      mqtt_binary_handler = std::make_unique<MqttBinaryHandler>(p_id,
+                                                                p_format,
+                                                                std::move(json_pointers),
+                                                                metrics_count);
+    }
+  }
+
+  return mqtt_binary_handler;
+}
+
+// A property name matches 'name=value' or 'name: value'.
+std::string make_text_pattern(std::string_view p_path,
+                              bool p_is_property)
+{
+  if(p_is_property)
+  {
+    return fmt::format(R"((?:^|[\s,;&]){}\s*[=:]\s*([^\s,;&]+))"_cf,
+                       re2::RE2::QuoteMeta(p_path));
+  }
+
+  return std::string{p_path};
+}
+
+MqttHandlerPtr configure_text_handler(std::string_view p_id,
+                                      const YAML::Node & yaml_text_handler,
+                                      prometheus::MetricsMap & prometheus_metrics)
+{
+  MqttHandlerPtr mqtt_text_handler{};
+  auto yaml_properties = yaml_text_handler["properties"sv];
+  if(yaml_properties && (0 != yaml_properties.size()))
+  {
+    MqttTextHandler::builder_type patterns{};
+    std::string error{};
+
+    auto add_pattern = [&patterns, &error](std::string_view p_pattern, prometheus::Metrics && p_metrics) {
+      if(!MqttTextHandler::ValidPattern(p_pattern, error))
+      {
+        spdlog::warn("   * invalid pattern [{}] {}!"sv, p_pattern, error);
+        return std::tuple<prometheus::Metrics *, bool>{nullptr, false};
+      }
+
+      return patterns.add_pattern(p_pattern, std::move(p_metrics));
+    };
+
+    if(const int metrics_count = configure_property_paths(p_id, yaml_properties, prometheus_metrics, add_pattern, make_text_pattern);
+       metrics_count > 0)
+    {
+      mqtt_text_handler = std::make_unique<MqttTextHandler>(p_id,
+                                                            std::move(patterns),
+                                                            metrics_count);
+    }
+  }
+
+  return mqtt_text_handler;
+}
+
+std::string make_field_name(std::string_view p_path,
+                            bool /* p_is_property */)
+{
+  return std::string{p_path};
+}
+
+std::vector<std::string> configure_names(const YAML::Node & yaml_names)
 {
-  return MqttHandlerPtr{};
+  std::vector<std::string> names{};
+
+  if(yaml_names && yaml_names.IsSequence())
+  {
+    names.reserve(yaml_names.size());
+    for(const auto & yaml_name : yaml_names)
+    {
+      names.emplace_back(yy_util::trim(yy_util::yaml_get_value<std::string_view>(yaml_name)));
+    }
+  }
+
+  return names;
+}
+
+MqttHandlerPtr configure_delimited_handler(std::string_view p_id,
+                                           const YAML::Node & yaml_delimited_handler,
+                                           prometheus::MetricsMap & prometheus_metrics,
+                                           MqttDelimitedHandler::Format p_format)
+{
+  MqttHandlerPtr mqtt_delimited_handler{};
+  auto yaml_properties = yaml_delimited_handler["properties"sv];
+  if(yaml_properties && (0 != yaml_properties.size()))
+  {
+    char separator = MqttDelimitedHandler::default_separator;
+    if(MqttDelimitedHandler::Format::Csv == p_format)
+    {
+      // Not trimmed, so a tab may be the separator.
+      const auto yaml_separator = yy_util::yaml_get_value<std::string_view>(yaml_delimited_handler["separator"sv]);
+      if(1 == yaml_separator.size())
+      {
+        separator = yaml_separator[0];
+      }
+
+      if((1 < yaml_separator.size())
+         || ('"' == separator) || ('\n' == separator) || ('\r' == separator))
+      {
+        spdlog::warn("   * invalid separator [{}], using [{}]!"sv, yaml_separator, MqttDelimitedHandler::default_separator);
+        separator = MqttDelimitedHandler::default_separator;
+      }
+    }
+
+    const auto columns = configure_names(yaml_delimited_handler["columns"sv]);
+    MqttDelimitedHandler::builder_type fields{};
+
+    auto add_field = [&fields](std::string_view p_name, prometheus::Metrics && p_metrics) {
+      return fields.add_field(p_name, std::move(p_metrics));
+    };
+
+    if(const int metrics_count = configure_property_paths(p_id, yaml_properties, prometheus_metrics, add_field, make_field_name);
+       metrics_count > 0)
+    {
+      for(const auto & label : configure_names(yaml_delimited_handler["labels"sv]))
+      {
+        spdlog::info("     - label [{}]"sv, label);
+        fields.add_label(label);
+      }
+
+      if(MqttDelimitedHandler::Format::Csv == p_format)
+      {
+        spdlog::info("   - separator [{}] columns [{}]"sv,
+                     separator,
+                     columns.empty() ? "header"sv : "configured"sv);
+      }
+      spdlog::info("   - delimiter scanner [{}]"sv, delimited::delimiter_scanner_isa());
+
+      mqtt_delimited_handler = std::make_unique<MqttDelimitedHandler>(p_id,
+                                                                      p_format,
+                                                                      separator,
+                                                                      columns,
+                                                                      std::move(fields),
+                                                                      metrics_count);
+    }
+  }
+
+  return mqtt_delimited_handler;
+}
+
+MqttHandlerPtr configure_sparkplug_handler(std::string_view p_id,
+                                           const YAML::Node & yaml_sparkplug_handler,
+                                           prometheus::MetricsMap & prometheus_metrics)
+{
+  MqttHandlerPtr mqtt_sparkplug_handler{};
+  auto yaml_properties = yaml_sparkplug_handler["properties"sv];
+  if(yaml_properties && (0 != yaml_properties.size()))
+  {
+    MqttSparkplugHandler::builder_type names{};
+
+    auto add_name = [&names](std::string_view p_name, prometheus::Metrics && p_metrics) {
+      return names.add_name(p_name, std::move(p_metrics));
+    };
+
+    if(const int metrics_count = configure_property_paths(p_id, yaml_properties, prometheus_metrics, add_name, make_field_name);
+       metrics_count > 0)
+    {
+      mqtt_sparkplug_handler = std::make_unique<MqttSparkplugHandler>(p_id,
+                                                                      std::move(names),
+                                                                      metrics_count);
+    }
+  }
+
+  return mqtt_sparkplug_handler;
 }
 
 MqttHandlerPtr configure_value_handler(std::string_view p_id,
@@ -205,8 +573,120 @@ MqttHandlerPtr configure_value_handler(std::string_view p_id,
   return handler;
 }
 
+bool learns_shapes(const MqttHandler & p_handler) noexcept
+{
+  return 0 != static_cast<const MqttJsonHandler &>(p_handler).ShapeCacheSize();
+}
+
+MqttHandlerPtr merge_json_handler_group(std::string_view p_id,
+                                        const MqttHandlerList & p_handlers)
+{
+  MqttJsonHandler::builder_type json_pointers{};
+  size_type metrics_count = 0;
+  size_type shape_cache_size = 0;
+
+  for(const auto & handler : p_handlers)
+  {
+    const auto & json_handler = static_cast<const MqttJsonHandler &>(*handler);
+
+    json_pointers.merge(json_handler.Pointers());
+    metrics_count += handler->MetricCount();
+    shape_cache_size = std::max(shape_cache_size, json_handler.ShapeCacheSize());
+  }
+
+  auto mqtt_json_handler = std::make_unique<MqttJsonHandler>(p_id,
+                                                             g_json_options,
+                                                             std::move(json_pointers),
+                                                             metrics_count);
+  mqtt_json_handler->SkipUnchanged(p_handlers[0]->SkipUnchanged());
+  mqtt_json_handler->Lazy(p_handlers[0]->Lazy());
+  mqtt_json_handler->Decode(p_handlers[0]->Decode());
+
+  if((0 != shape_cache_size)
+     && !mqtt_json_handler->LearnShapes(shape_cache_size))
+  {
+    spdlog::warn("   * can't learn shapes: properties must be top level json keys!"sv);
+  }
+
+  return mqtt_json_handler;
+}
+
 } // anonymous namespace
 
+MqttHandlerList merge_json_handlers(const MqttHandlerList & p_handlers,
+                                    MqttHandlerStore & handlers_store)
+{
+  // Json handlers grouped by 'skip_unchanged', 'lazy', 'decode' & whether
+  // they learn shapes, so handlers learning shapes aren't merged with
+  // handlers whose properties can't be learnt.
+  std::vector<MqttHandlerList> json_groups{};
+  MqttHandlerList handlers{};
+  handlers.reserve(p_handlers.size());
+
+  for(const auto & handler : p_handlers)
+  {
+    if(MqttHandler::type::Json == handler->Type())
+    {
+      auto same_group = [&handler](const MqttHandlerList & p_group) {
+        const auto & first = *p_group[0];
+
+        return (first.SkipUnchanged() == handler->SkipUnchanged())
+          && (first.Lazy() == handler->Lazy())
+          && (first.Decode() == handler->Decode())
+          && (learns_shapes(first) == learns_shapes(*handler));
+      };
+
+      if(auto group = std::ranges::find_if(json_groups, same_group);
+         json_groups.end() != group)
+      {
+        group->emplace_back(handler);
+      }
+      else
+      {
+        json_groups.emplace_back().emplace_back(handler);
+      }
+    }
+    else
+    {
+      handlers.emplace_back(handler);
+    }
+  }
+
+  for(const auto & group : json_groups)
+  {
+    if(1 == group.size())
+    {
+      handlers.emplace_back(group[0]);
+    }
+    else if(group.size() > 1)
+    {
+      std::string id{group[0]->Id()};
+      for(size_type idx = 1; idx < group.size(); ++idx)
+      {
+        id = fmt::format("{}+{}"_cf, id, group[idx]->Id());
+      }
+
+      MqttHandler * merged = nullptr;
+      auto do_find_handler = [&merged](auto store_handler, auto /* pos */) {
+        merged = store_handler->get();
+      };
+
+      if(!handlers_store.find_value(do_find_handler, id).found)
+      {
+        spdlog::info("   - combining json handlers [{}]."sv, id);
+
+        auto handler = merge_json_handler_group(id, group);
+        merged = handler.get();
+        std::ignore = handlers_store.emplace(std::move(id), std::move(handler));
+      }
+
+      handlers.emplace_back(merged);
+    }
+  }
+
+  return handlers;
+}
+
 MqttHandlerStore configure_mqtt_handlers(const YAML::Node & yaml_handlers,
                                          prometheus::config & prometheus_config)
 {
@@ -229,6 +709,23 @@ MqttHandlerStore configure_mqtt_handlers(const YAML::Node & yaml_handlers,
       spdlog::trace("  [line {}]."sv, yaml_handler.Mark().line + 1);
       MqttHandlerPtr handler;
 
+      // Skipping unchanged payloads, or only handling the latest, would
+      // drop values from metrics observing every value. Found before
+      // the handler takes its metrics.
+      std::string observing_metric{};
+      std::ignore = prometheus_config.metrics.find_value([&observing_metric](auto p_metrics, auto /* pos */) {
+        if(nullptr != p_metrics)
+        {
+          if(auto found = std::ranges::find_if(*p_metrics, [](const auto & metric) {
+            return metric && metric->ObservesEveryValue();
+          });
+             p_metrics->end() != found)
+          {
+            observing_metric = (*found)->Id().Name();
+          }
+        }
+      }, l_id);
+
       spdlog::info("   - type [{}]"sv, yaml_handler["type"sv].as<std::string_view>());
       switch(type)
       {
@@ -236,6 +733,10 @@ MqttHandlerStore configure_mqtt_handlers(const YAML::Node & yaml_handlers,
           handler = configure_json_handler(l_id, yaml_handler, prometheus_config.metrics);
           break;
 
+        case MqttHandler::type::JsonFast:
+          handler = configure_json_fast_handler(l_id, yaml_handler, prometheus_config.metrics);
+          break;
+
         case MqttHandler::type::Text:
           handler = configure_text_handler(l_id, yaml_handler, prometheus_config.metrics);
           break;
@@ -243,10 +744,77 @@ MqttHandlerStore configure_mqtt_handlers(const YAML::Node & yaml_handlers,
         case MqttHandler::type::Value:
           handler = configure_value_handler(l_id, yaml_handler, prometheus_config.metrics);
           break;
+
+        case MqttHandler::type::Csv:
+          handler = configure_delimited_handler(l_id, yaml_handler, prometheus_config.metrics, MqttDelimitedHandler::Format::Csv);
+          break;
+
+        case MqttHandler::type::Logfmt:
+          handler = configure_delimited_handler(l_id, yaml_handler, prometheus_config.metrics, MqttDelimitedHandler::Format::Logfmt);
+          break;
+
+        case MqttHandler::type::Cbor:
+          handler = configure_binary_handler(l_id, yaml_handler, prometheus_config.metrics, MqttBinaryHandler::Format::Cbor);
+          break;
+
+        case MqttHandler::type::Msgpack:
+          handler = configure_binary_handler(l_id, yaml_handler, prometheus_config.metrics, MqttBinaryHandler::Format::Msgpack);
+          break;
+
+        case MqttHandler::type::Sparkplug:
+          handler = configure_sparkplug_handler(l_id, yaml_handler, prometheus_config.metrics);
+          break;
+      }
+
+      if(handler)
+      {
+        if(auto chain = configure_decode(yaml_handler["decode"sv]);
+           !chain.has_value())
+        {
+          handler.reset();
+        }
+        else if(!chain->empty())
+        {
+          for(auto stage : *chain)
+          {
+            spdlog::info("   - decode [{}]"sv, decode::stage_name(stage));
+          }
+          handler->Decode(*chain);
+        }
       }
 
       if(handler)
       {
+        if(const bool skip_unchanged = yy_util::yaml_get_value(yaml_handler["skip_unchanged"sv], false);
+           skip_unchanged)
+        {
+          if(!observing_metric.empty())
+          {
+            spdlog::warn("   * ignoring 'skip_unchanged': metric [{}] observes every value!"sv,
+                         observing_metric);
+          }
+          else
+          {
+            spdlog::info("   - skip unchanged payloads"sv);
+            handler->SkipUnchanged(skip_unchanged);
+          }
+        }
+
+        if(const bool lazy = yy_util::yaml_get_value(yaml_handler["lazy"sv], false);
+           lazy)
+        {
+          if(!observing_metric.empty())
+          {
+            spdlog::warn("   * ignoring 'lazy': metric [{}] observes every value!"sv,
+                         observing_metric);
+          }
+          else
+          {
+            spdlog::info("   - lazy"sv);
+            handler->Lazy(lazy);
+          }
+        }
+
         if(auto id = handler->Id();
            !id.empty())
         {
@@ -36,4 +36,11 @@ namespace yafiyogi::mqtt_bridge {
 MqttHandlerStore configure_mqtt_handlers(const YAML::Node & yaml_handlers,
                                          prometheus::config & prometheus_config);
 
+// Combines the 'json' handlers in p_handlers that have the same
+// 'skip_unchanged', 'lazy' & 'decode' settings into one handler, so a
+// payload is parsed once for all of them. Combined handlers are added to
+// handlers_store, with the ids of their handlers joined by '+'.
+MqttHandlerList merge_json_handlers(const MqttHandlerList & p_handlers,
+                                    MqttHandlerStore & handlers_store);
+
 } // namespace yafiyogi::mqtt_bridge {
@@ -24,15 +24,23 @@
 
 */
 
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <tuple>
+
+#include "fmt/format.h"
+#include "fmt/compile.h"
 #include "spdlog/spdlog.h"
 
-#include "yy_cpp/yy_find_iter_util.hpp"
+#include "yy_cpp/yy_flat_map.h"
 #include "yy_cpp/yy_flat_set.h"
 #include "yy_cpp/yy_string_util.h"
 #include "yy_cpp/yy_yaml_util.h"
 
 #include "yy_mqtt/yy_mqtt_util.h"
 
+#include "configure_mqtt_handlers.h"
 #include "mqtt_handler.h"
 
 #include "configure_mqtt_topics.h"
@@ -40,12 +48,39 @@
 namespace yafiyogi::mqtt_bridge {
 
 using namespace std::string_view_literals;
+using namespace fmt::literals;
+
+namespace {
+
+constexpr std::string_view g_share_prefix{"$share/"};
+
+// Split '$share/<group>/<filter>' into group & filter.
+std::tuple<std::string_view, std::string_view> share_split(std::string_view p_subscription) noexcept
+{
+  if(p_subscription.starts_with(g_share_prefix))
+  {
+    auto group_filter = p_subscription.substr(g_share_prefix.size());
+
+    if(auto pos = group_filter.find('/');
+       (std::string_view::npos != pos) && (0 != pos))
+    {
+      return {group_filter.substr(0, pos), group_filter.substr(pos + 1)};
+    }
+  }
+
+  return {std::string_view{}, p_subscription};
+}
+
+} // anonymous namespace
 
 mqtt_topics configure_mqtt_topics(const YAML::Node & yaml_topics,
-                                  const MqttHandlerStore & handlers_store)
+                                  MqttHandlerStore & handlers_store,
+                                  std::string_view p_share_group,
+                                  int p_default_qos)
 {
   Subscriptions subscriptions{};
-  TopicsConfig topics_config{};
+  // Handlers of each filter, over all topics.
+  yy_data::flat_map<std::string, MqttHandlerList> filter_handlers{};
 
   spdlog::info(" Configuring topics."sv);
   for(const auto & yaml_topic: yaml_topics)
@@ -69,6 +104,8 @@ mqtt_topics configure_mqtt_topics(const YAML::Node & yaml_topics,
 
       if(!mqtt_handlers.empty())
       {
+        const int qos = std::clamp(yy_util::yaml_get_value(yaml_topic["qos"sv], p_default_qos), 0, 2);
+        const bool shared = yy_util::yaml_get_value(yaml_topic["shared"sv], true);
         auto yaml_subscriptions = yaml_topic["subscriptions"sv];
         yy_data::flat_set<std::string_view> filters{};
         filters.reserve(yaml_subscriptions.size());
@@ -77,18 +114,32 @@ mqtt_topics configure_mqtt_topics(const YAML::Node & yaml_topics,
         {
           spdlog::trace("  Configuring Subscription [line {}]."sv,
                         yaml_subscription.Mark().line + 1);
-          if(auto topic = yy_mqtt::topic_trim(yaml_subscription.as<std::string_view>());
+          auto subscription = yy_mqtt::topic_trim(yaml_subscription.as<std::string_view>());
+          if(auto [ignore_group, topic] = share_split(subscription);
              yy_mqtt::TopicValidStatus::Valid == yy_mqtt::topic_validate(topic, yy_mqtt::TopicType::Filter))
           {
-            filters.emplace(topic);
+            filters.emplace(subscription);
           }
         }
 
         subscriptions.reserve(subscriptions.size() + filters.size());
         for(size_type idx = 0; idx < filters.size(); ++idx)
         {
-          auto filter = filters[idx];
-          spdlog::info("   - subscribing to topic [{}]"sv, filter);
+          // Messages are published to the plain topic, so route
+          // using the filter without the '$share/<group>/' prefix.
+          auto [group, filter] = share_split(filters[idx]);
+          std::string subscription{filters[idx]};
+          const bool exclusive = group.empty() && !p_share_group.empty() && !shared;
+
+          if(group.empty() && !p_share_group.empty() && shared)
+          {
+            subscription = fmt::format("{}{}/{}"_cf, g_share_prefix, p_share_group, filter);
+          }
+
+          spdlog::info("   - subscribing to topic [{}] qos=[{}]{}"sv,
+                       subscription,
+                       qos,
+                       exclusive ? " on the first connection"sv : ""sv);
           if(mqtt_handlers.size() == 1)
           {
             spdlog::info("     with handler:"sv);
@@ -103,17 +154,39 @@ mqtt_topics configure_mqtt_topics(const YAML::Node & yaml_topics,
             spdlog::info("     * [{}]"sv, handler->Id());
           }
 
-          topics_config.add(filter, MqttHandlerList{mqtt_handlers});
-          if(auto [pos, found] = yy_data::find_iter_pos(subscriptions, filter);
-             !found)
+          auto [filter_pos, ignore_emplaced] = filter_handlers.emplace(std::string{filter}, MqttHandlerList{});
+          auto [ignore_filter, handlers] = filter_handlers[filter_pos];
+          for(const auto & handler : mqtt_handlers)
+          {
+            if(std::ranges::find(handlers, handler) == handlers.end())
+            {
+              handlers.emplace_back(handler);
+            }
+          }
+
+          if(auto pos = std::ranges::lower_bound(subscriptions, subscription, {}, &Subscription::filter);
+             (subscriptions.end() != pos) && (pos->filter == subscription))
           {
-            subscriptions.emplace(subscriptions.begin() + pos, std::string{filter});
+            pos->qos = std::max(pos->qos, qos);
+          }
+          else
+          {
+            subscriptions.emplace(pos, Subscription{std::move(subscription), qos, exclusive});
           }
         }
       }
     }
   }
 
+  TopicsConfig topics_config{};
+  for(size_type idx = 0; idx < filter_handlers.size(); ++idx)
+  {
+    auto [filter, handlers] = filter_handlers[idx];
+
+    topics_config.add(filter, TopicHandlers{TopicFilter{idx, std::string{filter}},
+                                            merge_json_handlers(handlers, handlers_store)});
+  }
+
   return mqtt_topics{std::move(subscriptions), topics_config.create_automaton()};
 }
 
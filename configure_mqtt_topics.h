@@ -26,6 +26,8 @@
 
 #pragma once
 
+#include <string_view>
+
 #include "yy_tp_util/yaml_fwd.h"
 
 #include "yy_cpp/yy_vector.h"
@@ -41,8 +43,14 @@ struct mqtt_topics final
 };
 
 
+// A non empty share group subscribes to each filter using the MQTT5
+// shared subscription '$share/<share group>/<filter>'. Topics without a
+// 'qos' subscribe with the default QoS. 'json' handlers sharing a
+// filter are combined, adding the combined handlers to handlers.
 mqtt_topics configure_mqtt_topics(const YAML::Node & yaml_topics,
-                                  const MqttHandlerStore & handlers);
+                                  MqttHandlerStore & handlers,
+                                  std::string_view share_group,
+                                  int default_qos);
 
 
 } // namespace yafiyogi::mqtt_bridge
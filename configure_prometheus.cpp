@@ -24,6 +24,7 @@
 
 */
 
+#include <algorithm>
 #include <string>
 #include <string_view>
 
@@ -79,15 +80,21 @@ config configure_prometheus(const YAML::Node & yaml_prometheus)
 
   yy_prometheus::set_metric_style(metric_style);
 
-  auto create_metrics = [&yaml_prometheus]() {
-    auto default_timestamp{yy_prometheus::decode_metric_timestamp(yy_util::yaml_get_value(yaml_prometheus["timestamps"sv], ""sv))};
-
-    return configure_prometheus_metrics(yaml_prometheus["metrics"sv], default_timestamp);
-  };
-
   return config{std::string{uri},
                 create_options(),
-                create_metrics()};
+                configure_metrics(yaml_prometheus)};
+}
+
+MetricsMap configure_metrics(const YAML::Node & yaml_prometheus)
+{
+  auto default_timestamp{yy_prometheus::decode_metric_timestamp(yy_util::yaml_get_value(yaml_prometheus["timestamps"sv], ""sv))};
+  auto label_cache_size{std::max(yy_util::yaml_get_value(yaml_prometheus["label_cache_size"sv],
+                                                         Metric::default_label_cache_size),
+                                 size_type{1})};
+
+  return configure_prometheus_metrics(yaml_prometheus["metrics"sv],
+                                      default_timestamp,
+                                      label_cache_size);
 }
 
 } // namespace yafiyogi::mqtt_bridge::prometheus
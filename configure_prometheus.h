@@ -33,5 +33,6 @@
 namespace yafiyogi::mqtt_bridge::prometheus {
 
 config configure_prometheus(const YAML::Node & yaml_prometheus);
+MetricsMap configure_metrics(const YAML::Node & yaml_prometheus);
 
 } // namespace yafiyogi::mqtt_bridge::prometheus
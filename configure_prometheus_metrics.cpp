@@ -24,8 +24,16 @@
 
 */
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <optional>
 #include <string>
 #include <string_view>
+#include <tuple>
 
 #include "spdlog/spdlog.h"
 
@@ -50,19 +58,342 @@
 #include "yy_values/yy_value_action_keep.hpp"
 #include "yy_values/yy_value_action_switch.hpp"
 
+#include "yy_mqtt/yy_mqtt_util.h"
+
 #include "yy_prometheus/yy_prometheus_configure.h"
 
 #include "configure_prometheus_metrics.h"
+#include "distribution.h"
 #include "mqtt_handler.h"
 #include "prometheus_config.h"
 #include "prometheus_metric.h"
+#include "replace_path.h"
+#include "value_program.h"
 
 namespace yafiyogi::mqtt_bridge::prometheus {
 
 using namespace std::string_view_literals;
 
+namespace {
+
+// Compiles the 'expression' & 'switch' value actions into a value
+// program. The other value actions are returned for yy_values to
+// configure.
+std::tuple<values::ValueProgram, YAML::Node> configure_value_program(const YAML::Node & yaml_value_actions)
+{
+  values::ValueProgram program{};
+
+  if(!yy_util::yaml_is_sequence(yaml_value_actions))
+  {
+    return {std::move(program), yaml_value_actions};
+  }
+
+  YAML::Node yaml_other_actions{YAML::NodeType::Sequence};
+  std::string error{};
+
+  for(const auto & yaml_action : yaml_value_actions)
+  {
+    const std::string action = yy_util::to_lower(yy_util::trim(yy_util::yaml_get_value<std::string_view>(yaml_action["action"sv])));
+
+    if("expression"sv == action)
+    {
+      const auto source{yy_util::trim(yy_util::yaml_get_value<std::string_view>(yaml_action["expression"sv]))};
+
+      if(auto expression = values::Expression::Compile(source, error);
+         expression.has_value())
+      {
+        spdlog::info("     - expression [{}]."sv, source);
+        program.add_action(std::move(expression.value()));
+      }
+      else
+      {
+        spdlog::error("Invalid expression [{}]: {} [line {}]."sv,
+                      source,
+                      error,
+                      yaml_action.Mark().line + 1);
+      }
+    }
+    else if("switch"sv == action)
+    {
+      values::Switch::Mappings mappings{};
+
+      if(const auto & yaml_mappings = yaml_action["mappings"sv];
+         yaml_mappings && yaml_mappings.IsMap())
+      {
+        mappings.reserve(yaml_mappings.size());
+        for(const auto & yaml_mapping : yaml_mappings)
+        {
+          mappings.emplace_back(yaml_mapping.first.as<std::string>(),
+                                yaml_mapping.second.as<std::string>());
+        }
+      }
+
+      std::optional<std::string> default_value{};
+      if(auto yaml_default = yy_util::yaml_get_optional_value<std::string_view>(yaml_action["default"sv]);
+         yaml_default.has_value())
+      {
+        default_value = std::string{yaml_default.value()};
+      }
+
+      program.add_action(values::Switch{mappings, std::move(default_value)});
+    }
+    else
+    {
+      yaml_other_actions.push_back(yaml_action);
+    }
+  }
+
+  return {std::move(program), yaml_other_actions};
+}
+
+// Compiles the leading 'replace-path' label actions, which only
+// depend on the topic's levels. The other label actions are returned
+// for yy_values to configure, in order.
+std::tuple<labels::ReplacePaths, YAML::Node> configure_replace_paths(const YAML::Node & yaml_label_actions)
+{
+  labels::ReplacePaths replace_paths{};
+
+  if(!yy_util::yaml_is_sequence(yaml_label_actions))
+  {
+    return {std::move(replace_paths), yaml_label_actions};
+  }
+
+  YAML::Node yaml_other_actions{YAML::NodeType::Sequence};
+
+  for(const auto & yaml_action : yaml_label_actions)
+  {
+    const std::string action = yy_util::to_lower(yy_util::trim(yy_util::yaml_get_value<std::string_view>(yaml_action["action"sv])));
+
+    if(("replace-path"sv != action) || (0 != yaml_other_actions.size()))
+    {
+      yaml_other_actions.push_back(yaml_action);
+      continue;
+    }
+
+    const auto target{yy_util::trim(yy_util::yaml_get_value<std::string_view>(yaml_action["target"sv]))};
+    if(target.empty())
+    {
+      spdlog::error("'replace-path' without a target [line {}]."sv,
+                    yaml_action.Mark().line + 1);
+      continue;
+    }
+
+    labels::ReplacePath::Replaces replaces{};
+    for(const auto & yaml_replace : yaml_action["replace"sv])
+    {
+      std::string_view pattern{};
+      std::string_view format{};
+
+      if(yaml_replace.IsMap())
+      {
+        pattern = yy_mqtt::topic_trim(yy_util::yaml_get_value<std::string_view>(yaml_replace["pattern"sv]));
+        format = yy_util::trim(yy_util::yaml_get_value<std::string_view>(yaml_replace["format"sv]));
+      }
+      else
+      {
+        format = yy_util::trim(yaml_replace.as<std::string_view>());
+      }
+
+      if(!pattern.empty()
+         && (yy_mqtt::TopicValidStatus::Valid != yy_mqtt::topic_validate(pattern, yy_mqtt::TopicType::Filter)))
+      {
+        spdlog::error("Invalid 'replace-path' pattern [{}] [line {}]."sv,
+                      pattern,
+                      yaml_replace.Mark().line + 1);
+        continue;
+      }
+
+      spdlog::info("     - replace-path [{}] pattern [{}] format [{}]."sv, target, pattern, format);
+      replaces.emplace_back(labels::ReplacePath::Replace{std::string{pattern}, labels::PathFormat{format}});
+    }
+
+    replace_paths.emplace_back(std::string{target}, std::move(replaces));
+  }
+
+  return {std::move(replace_paths), yaml_other_actions};
+}
+
+constexpr auto aggregate_names =
+  yy_data::make_lookup<std::string_view, std::optional<distributions::Aggregate>>(std::nullopt,
+                                                                                  {{"avg"sv, distributions::Aggregate::Avg},
+                                                                                   {"count"sv, distributions::Aggregate::Count},
+                                                                                   {"last"sv, distributions::Aggregate::Last},
+                                                                                   {"max"sv, distributions::Aggregate::Max},
+                                                                                   {"min"sv, distributions::Aggregate::Min}});
+
+// Configures the distribution of a 'histogram' or 'summary' metric, or
+// of another metric with an 'aggregate' section. Returns std::nullopt
+// for other metrics.
+std::optional<distributions::DistributionConfig> configure_distribution(const YAML::Node & yaml_metric)
+{
+  static constexpr std::array g_default_buckets{0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0, 10.0};
+  static constexpr std::array g_default_quantiles{0.5, 0.9, 0.99};
+  static constexpr std::array g_default_aggregates{distributions::Aggregate::Min,
+                                                   distributions::Aggregate::Max,
+                                                   distributions::Aggregate::Avg,
+                                                   distributions::Aggregate::Count,
+                                                   distributions::Aggregate::Last};
+  static constexpr double g_min_relative_accuracy = 0.0001;
+  static constexpr double g_max_relative_accuracy = 0.5;
+  static constexpr size_type g_min_bins = 16;
+
+  const std::string type = yy_util::to_lower(yy_util::trim(yy_util::yaml_get_value<std::string_view>(yaml_metric["type"sv])));
+  distributions::DistributionConfig config{};
+
+  // Values that are NaN or out of range are ignored.
+  auto add_values = [](yy_quad::simple_vector<double> & p_values,
+                       const YAML::Node & yaml_values,
+                       double p_min,
+                       double p_max) {
+    for(const auto & yaml_value : yaml_values)
+    {
+      if(auto value = yy_util::yaml_get_optional_value<double>(yaml_value);
+         value.has_value() && (value.value() >= p_min) && (value.value() <= p_max))
+      {
+        p_values.emplace_back(value.value());
+      }
+      else
+      {
+        spdlog::warn("  ignoring value [line {}]."sv, yaml_value.Mark().line + 1);
+      }
+    }
+
+    std::ranges::sort(p_values);
+    const auto [first, last] = std::ranges::unique(p_values);
+    for(auto duplicates = last - first; duplicates > 0; --duplicates)
+    {
+      p_values.pop_back();
+    }
+  };
+
+  if("histogram"sv == type)
+  {
+    config.type = distributions::DistributionType::Histogram;
+
+    if(const auto & yaml_buckets = yaml_metric["buckets"sv];
+       yaml_buckets && yaml_buckets.IsMap())
+    {
+      // Exponential buckets: start, start * factor, start * factor^2...
+      double bucket = yy_util::yaml_get_value(yaml_buckets["start"sv], 0.0);
+      const double factor = yy_util::yaml_get_value(yaml_buckets["factor"sv], 0.0);
+      const auto count = yy_util::yaml_get_value(yaml_buckets["count"sv], size_type{0});
+
+      if((bucket > 0) && (factor > 1))
+      {
+        for(size_type idx = 0; (idx < count) && std::isfinite(bucket); ++idx)
+        {
+          config.buckets.emplace_back(bucket);
+          bucket *= factor;
+        }
+      }
+      else
+      {
+        spdlog::error("Invalid exponential buckets, start must be > 0 & factor > 1 [line {}]."sv,
+                      yaml_buckets.Mark().line + 1);
+      }
+    }
+    else if(yy_util::yaml_is_sequence(yaml_buckets))
+    {
+      add_values(config.buckets,
+                 yaml_buckets,
+                 std::numeric_limits<double>::lowest(),
+                 std::numeric_limits<double>::max());
+    }
+
+    if(config.buckets.empty())
+    {
+      for(const auto bucket : g_default_buckets)
+      {
+        config.buckets.emplace_back(bucket);
+      }
+    }
+    spdlog::info("  histogram buckets [{}]."sv, config.buckets.size());
+  }
+  else if("summary"sv == type)
+  {
+    config.type = distributions::DistributionType::Summary;
+
+    if(const auto & yaml_quantiles = yaml_metric["quantiles"sv];
+       yy_util::yaml_is_sequence(yaml_quantiles))
+    {
+      add_values(config.quantiles, yaml_quantiles, 0.0, 1.0);
+    }
+
+    if(config.quantiles.empty())
+    {
+      for(const auto quantile : g_default_quantiles)
+      {
+        config.quantiles.emplace_back(quantile);
+      }
+    }
+
+    config.relative_accuracy = std::clamp(yy_util::yaml_get_value(yaml_metric["relative_accuracy"sv],
+                                                                  distributions::DistributionConfig::default_relative_accuracy),
+                                          g_min_relative_accuracy,
+                                          g_max_relative_accuracy);
+    config.max_bins = std::max(yy_util::yaml_get_value(yaml_metric["max_bins"sv],
+                                                       distributions::DistributionConfig::default_max_bins),
+                               g_min_bins);
+    spdlog::info("  summary quantiles [{}] relative accuracy [{}]."sv,
+                 config.quantiles.size(),
+                 config.relative_accuracy);
+  }
+  else if(const auto & yaml_aggregate = yaml_metric["aggregate"sv];
+          yaml_aggregate)
+  {
+    config.type = distributions::DistributionType::Aggregate;
+    config.window = std::chrono::seconds{yy_util::yaml_get_value(yaml_aggregate["window"sv], std::int64_t{0})};
+
+    if(const auto & yaml_functions = yaml_aggregate["functions"sv];
+       yy_util::yaml_is_sequence(yaml_functions))
+    {
+      for(const auto & yaml_function : yaml_functions)
+      {
+        const auto name = yy_util::to_lower(yy_util::trim(yy_util::yaml_get_value<std::string_view>(yaml_function)));
+
+        if(auto aggregate = aggregate_names.lookup(name);
+           !aggregate.has_value())
+        {
+          spdlog::error("Unknown aggregate [{}] [line {}]."sv,
+                        name,
+                        yaml_function.Mark().line + 1);
+        }
+        else if(std::ranges::find(config.aggregates, aggregate.value()) == config.aggregates.end())
+        {
+          config.aggregates.emplace_back(aggregate.value());
+        }
+      }
+    }
+
+    if(config.aggregates.empty())
+    {
+      for(const auto aggregate : g_default_aggregates)
+      {
+        config.aggregates.emplace_back(aggregate);
+      }
+    }
+
+    if(config.window < std::chrono::seconds::zero())
+    {
+      config.window = std::chrono::seconds::zero();
+    }
+    spdlog::info("  aggregates [{}] window [{}s]."sv,
+                 config.aggregates.size(),
+                 config.window.count());
+  }
+  else
+  {
+    return std::nullopt;
+  }
+
+  return config;
+}
+
+} // anonymous namespace
+
 MetricsMap configure_prometheus_metrics(const YAML::Node & yaml_metrics,
-                                        yy_prometheus::MetricTimestamp p_default_timestamp)
+                                        yy_prometheus::MetricTimestamp p_default_timestamp,
+                                        size_type p_label_cache_size)
 {
   MetricsMap metrics{};
 
@@ -82,6 +413,13 @@ MetricsMap configure_prometheus_metrics(const YAML::Node & yaml_metrics,
       auto type{yy_prometheus::decode_metric_type_name(yy_util::yaml_get_optional_value<std::string_view>(yaml_metric["type"sv]))};
       auto unit{yy_prometheus::decode_metric_unit_name(yy_util::yaml_get_optional_value<std::string_view>(yaml_metric["unit"sv]))};
 
+      distributions::FamilyPtr distribution{};
+      if(auto distribution_config = configure_distribution(yaml_metric);
+         distribution_config.has_value())
+      {
+        distribution = distributions::add_family(metric_id.Name(), std::move(distribution_config.value()));
+      }
+
       if(yy_util::yaml_is_sequence(yaml_handlers))
       {
         for(const auto & yaml_handler : yaml_handlers)
@@ -105,14 +443,18 @@ MetricsMap configure_prometheus_metrics(const YAML::Node & yaml_metrics,
               spdlog::info("     - value [{}]."sv, property_name.value());
               spdlog::trace("        [line {}]."sv, yaml_property.Mark().line + 1);
 
-              auto create_label_actions = [&yaml_handler]() {
+              auto [replace_paths, yaml_label_actions] = configure_replace_paths(yaml_handler["label_actions"sv]);
+
+              auto create_label_actions = [&yaml_handler, &yaml_label_actions = yaml_label_actions]() {
                 spdlog::trace("        Create label actions."sv, yaml_handler.Mark().line + 1);
-                return yy_values::configure_label_actions(yaml_handler["label_actions"sv]);
+                return yy_values::configure_label_actions(yaml_label_actions);
               };
 
-              auto create_value_actions = [&yaml_handler]() {
+              auto [value_program, yaml_value_actions] = configure_value_program(yaml_handler["value_actions"sv]);
+
+              auto create_value_actions = [&yaml_handler, &yaml_value_actions = yaml_value_actions]() {
                 spdlog::trace("        Create value actions."sv, yaml_handler.Mark().line + 1);
-                return yy_values::configure_value_actions(yaml_handler["value_actions"sv]);
+                return yy_values::configure_value_actions(yaml_value_actions);
               };
 
               auto create_property_actions = [&yaml_handler]() {
@@ -125,9 +467,13 @@ MetricsMap configure_prometheus_metrics(const YAML::Node & yaml_metrics,
                                                    type,
                                                    unit,
                                                    timestamp,
+                                                   std::move(replace_paths),
                                                    create_label_actions(),
+                                                   std::move(value_program),
                                                    create_value_actions(),
-                                                   create_property_actions())};
+                                                   create_property_actions(),
+                                                   distribution,
+                                                   p_label_cache_size)};
 
               spdlog::info("     - add metric [{}] to handler [{}] property [{}]."sv,
                            metric->Id(),
@@ -33,6 +33,7 @@
 namespace yafiyogi::mqtt_bridge::prometheus {
 
 MetricsMap configure_prometheus_metrics(const YAML::Node & yaml_metrics,
-                                        yy_prometheus::MetricTimestamp default_timestamp);
+                                        yy_prometheus::MetricTimestamp default_timestamp,
+                                        size_type label_cache_size);
 
 } // namespace yafiyogi::mqtt_bridge::prometheus
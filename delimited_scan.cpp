@@ -0,0 +1,107 @@
+/*
+
+  MIT License
+
+  Copyright (c) 2025 Yafiyogi
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+#include <cstdint>
+#include <cstring>
+
+#include <algorithm>
+#include <bit>
+#include <string_view>
+
+#include "delimited_scan.h"
+
+namespace yafiyogi::mqtt_bridge::delimited {
+namespace {
+
+using byte_classify::block_size;
+
+} // anonymous namespace
+
+DelimiterScanner::DelimiterScanner(std::string_view p_delimiters) noexcept:
+  m_classify(byte_classify::classifier<Delimiters>().classify)
+{
+  p_delimiters = p_delimiters.substr(0, max_delimiters);
+
+  // Unused slots repeat a delimiter, so every compare is live.
+  const char fill = p_delimiters.empty() ? '\0' : p_delimiters[0];
+  m_delimiters.bytes.fill(fill);
+  std::copy(p_delimiters.begin(), p_delimiters.end(), m_delimiters.bytes.begin());
+}
+
+void DelimiterScanner::reset(std::string_view p_data) noexcept
+{
+  m_data = p_data;
+  m_base = 0;
+  m_mask = 0;
+
+  if(!m_data.empty())
+  {
+    load();
+  }
+}
+
+void DelimiterScanner::load() noexcept
+{
+  const char * block = m_data.data() + m_base;
+  char tail[block_size];
+
+  if((m_data.size() - m_base) < block_size)
+  {
+    // Pad the last block with '\0', which isn't a delimiter.
+    std::memset(tail, '\0', block_size);
+    std::memcpy(tail, block, m_data.size() - m_base);
+    block = tail;
+  }
+
+  m_mask = m_classify(block, m_delimiters)[0];
+}
+
+size_type DelimiterScanner::next() noexcept
+{
+  while(0 == m_mask)
+  {
+    m_base += block_size;
+    if(m_base >= m_data.size())
+    {
+      m_base = m_data.size();
+      return npos;
+    }
+
+    load();
+  }
+
+  const size_type pos = m_base + static_cast<size_type>(std::countr_zero(m_mask));
+  m_mask &= m_mask - 1;
+
+  return pos;
+}
+
+std::string_view delimiter_scanner_isa() noexcept
+{
+  return byte_classify::classifier<DelimiterScanner::Delimiters>().isa;
+}
+
+} // namespace yafiyogi::mqtt_bridge::delimited
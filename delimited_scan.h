@@ -0,0 +1,80 @@
+/*
+
+  MIT License
+
+  Copyright (c) 2025 Yafiyogi
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <string_view>
+
+#include "yy_cpp/yy_types.hpp"
+
+#include "byte_classify.h"
+
+namespace yafiyogi::mqtt_bridge::delimited {
+
+// Streams the positions of up to 'max_delimiters' delimiter characters
+// in a payload, in order. Delimiters are found 64 bytes at a time,
+// with AVX2 or SSE4.2 when the CPU supports them.
+class DelimiterScanner final
+{
+  public:
+    static constexpr size_type max_delimiters = 4;
+    static constexpr size_type npos = std::numeric_limits<size_type>::max();
+
+    using Delimiters = byte_classify::ByteSet<max_delimiters>;
+
+    // p_delimiters must not contain '\0', and is truncated to
+    // 'max_delimiters' characters.
+    explicit DelimiterScanner(std::string_view p_delimiters) noexcept;
+
+    DelimiterScanner() = delete;
+    constexpr DelimiterScanner(const DelimiterScanner &) noexcept = default;
+    constexpr DelimiterScanner(DelimiterScanner &&) noexcept = default;
+
+    constexpr DelimiterScanner & operator=(const DelimiterScanner &) noexcept = default;
+    constexpr DelimiterScanner & operator=(DelimiterScanner &&) noexcept = default;
+
+    void reset(std::string_view p_data) noexcept;
+
+    // Position of the next delimiter, or npos.
+    [[nodiscard]]
+    size_type next() noexcept;
+
+  private:
+    void load() noexcept;
+
+    Delimiters m_delimiters{};
+    byte_classify::ClassifyFn<Delimiters> m_classify = nullptr;
+    std::string_view m_data{};
+    size_type m_base = 0;
+    std::uint64_t m_mask = 0;
+};
+
+// Name of the classifier in use ("avx2", "sse4.2" or "scalar").
+std::string_view delimiter_scanner_isa() noexcept;
+
+} // namespace yafiyogi::mqtt_bridge::delimited
@@ -0,0 +1,598 @@
+/*
+
+  MIT License
+
+  Copyright (c) 2025 Yafiyogi
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <utility>
+
+#include "fmt/compile.h"
+#include "fmt/format.h"
+
+#include "numeric_value.h"
+
+#include "distribution.h"
+
+namespace yafiyogi::mqtt_bridge::distributions {
+namespace {
+
+using namespace std::string_view_literals;
+using namespace fmt::literals;
+
+// Values closer to 0 are counted as 0.
+constexpr double g_min_value = std::numeric_limits<double>::min();
+
+std::mutex g_families_mtx{};
+std::map<std::string, FamilyPtr, std::less<>> g_families{};
+
+constexpr std::string_view decode_type_name(DistributionType p_type) noexcept
+{
+  return DistributionType::Summary == p_type ? "summary"sv : "histogram"sv;
+}
+
+constexpr std::string_view decode_aggregate_name(Aggregate p_aggregate) noexcept
+{
+  switch(p_aggregate)
+  {
+    case Aggregate::Min:
+      return "min"sv;
+
+    case Aggregate::Max:
+      return "max"sv;
+
+    case Aggregate::Avg:
+      return "avg"sv;
+
+    case Aggregate::Count:
+      return "count"sv;
+
+    case Aggregate::Last:
+      [[fallthrough]];
+    default:
+      return "last"sv;
+  }
+}
+
+NumericValue aggregate_value(Aggregate p_aggregate,
+                             const Series::Window & p_window) noexcept
+{
+  switch(p_aggregate)
+  {
+    case Aggregate::Min:
+      return NumericValue{p_window.min};
+
+    case Aggregate::Max:
+      return NumericValue{p_window.max};
+
+    case Aggregate::Avg:
+      return NumericValue{p_window.sum / static_cast<double>(p_window.count)};
+
+    case Aggregate::Count:
+      return NumericValue{p_window.count};
+
+    case Aggregate::Last:
+      [[fallthrough]];
+    default:
+      return NumericValue{p_window.last};
+  }
+}
+
+} // anonymous namespace
+
+DDSketch::DDSketch(double p_relative_accuracy,
+                   size_type p_max_bins):
+  m_gamma((1 + p_relative_accuracy) / (1 - p_relative_accuracy)),
+  m_log_gamma(std::log(m_gamma)),
+  m_max_bins(std::max(p_max_bins, size_type{1})),
+  m_min(std::numeric_limits<double>::infinity()),
+  m_max(-std::numeric_limits<double>::infinity())
+{
+}
+
+void DDSketch::Add(double p_value)
+{
+  if(!std::isfinite(p_value))
+  {
+    return;
+  }
+
+  if(p_value >= g_min_value)
+  {
+    m_positive.Add(Index(p_value), m_max_bins);
+  }
+  else if(p_value <= -g_min_value)
+  {
+    m_negative.Add(Index(-p_value), m_max_bins);
+  }
+  else
+  {
+    ++m_zero;
+  }
+
+  ++m_count;
+  m_min = std::min(m_min, p_value);
+  m_max = std::max(m_max, p_value);
+}
+
+double DDSketch::Quantile(double p_quantile) const noexcept
+{
+  if(0 == m_count)
+  {
+    return std::numeric_limits<double>::quiet_NaN();
+  }
+
+  if(p_quantile <= 0)
+  {
+    return m_min;
+  }
+
+  if(p_quantile >= 1)
+  {
+    return m_max;
+  }
+
+  // An estimate is never outside the values added.
+  auto estimate = [this](double p_estimate) {
+    return std::clamp(p_estimate, m_min, m_max);
+  };
+
+  const double rank = p_quantile * static_cast<double>(m_count - 1);
+  std::uint64_t count = 0;
+
+  // Most negative first.
+  for(size_type idx = m_negative.bins.size(); idx > 0; --idx)
+  {
+    count += m_negative.bins[idx - 1];
+    if(static_cast<double>(count) > rank)
+    {
+      return estimate(-Value(m_negative.offset + static_cast<int>(idx - 1)));
+    }
+  }
+
+  count += m_zero;
+  if(static_cast<double>(count) > rank)
+  {
+    return estimate(0);
+  }
+
+  for(size_type idx = 0; idx < m_positive.bins.size(); ++idx)
+  {
+    count += m_positive.bins[idx];
+    if(static_cast<double>(count) > rank)
+    {
+      return estimate(Value(m_positive.offset + static_cast<int>(idx)));
+    }
+  }
+
+  return m_max;
+}
+
+int DDSketch::Index(double p_value) const noexcept
+{
+  return static_cast<int>(std::ceil(std::log(p_value) / m_log_gamma));
+}
+
+double DDSketch::Value(int p_index) const noexcept
+{
+  // The middle of the bin (gamma^(i-1), gamma^i], within the relative
+  // accuracy of every value in it.
+  return 2 * std::exp(p_index * m_log_gamma) / (m_gamma + 1);
+}
+
+void DDSketch::Store::Add(int p_index,
+                          size_type p_max_bins)
+{
+  const int max_bins = static_cast<int>(p_max_bins);
+
+  if(bins.empty())
+  {
+    bins.emplace_back(0);
+    offset = p_index;
+  }
+  else if(p_index < offset)
+  {
+    // Below the lowest bin there is room for: add to that bin.
+    const int top = offset + static_cast<int>(bins.size()) - 1;
+    p_index = std::max(p_index, top - max_bins + 1);
+
+    if(p_index < offset)
+    {
+      const auto grow = static_cast<size_type>(offset - p_index);
+      yy_quad::simple_vector<std::uint64_t> grown{};
+
+      grown.reserve(bins.size() + grow);
+      for(size_type idx = 0; idx < grow; ++idx)
+      {
+        grown.emplace_back(0);
+      }
+      for(const auto count : bins)
+      {
+        grown.emplace_back(count);
+      }
+      bins = std::move(grown);
+      offset = p_index;
+    }
+  }
+  else if(p_index >= (offset + static_cast<int>(bins.size())))
+  {
+    if(const int bottom = p_index - max_bins + 1;
+       bottom > offset)
+    {
+      // Collapse the bins below bottom into it.
+      const auto collapse = std::min(static_cast<size_type>(bottom - offset), bins.size());
+      const auto collapsed = std::accumulate(bins.begin(), bins.begin() + collapse, std::uint64_t{0});
+
+      std::copy(bins.begin() + collapse, bins.end(), bins.begin());
+      for(size_type idx = 0; idx < collapse; ++idx)
+      {
+        bins.pop_back();
+      }
+      if(bins.empty())
+      {
+        bins.emplace_back(0);
+      }
+      bins[0] += collapsed;
+      offset = bottom;
+    }
+
+    for(auto size = static_cast<size_type>(p_index - offset + 1); bins.size() < size; )
+    {
+      bins.emplace_back(0);
+    }
+  }
+
+  ++bins[static_cast<size_type>(p_index - offset)];
+}
+
+Series::Series(const DistributionConfig & p_config):
+  m_config(&p_config),
+  m_sketch(p_config.relative_accuracy, p_config.max_bins)
+{
+  if(DistributionType::Histogram == p_config.type)
+  {
+    m_buckets.reserve(p_config.buckets.size() + 1);
+    for(size_type idx = 0; idx <= p_config.buckets.size(); ++idx)
+    {
+      m_buckets.emplace_back(0);
+    }
+  }
+}
+
+void Series::Observe(double p_value,
+                     timestamp_type p_timestamp)
+{
+  if(std::isnan(p_value))
+  {
+    return;
+  }
+
+  std::unique_lock lck{m_mtx};
+
+  switch(m_config->type)
+  {
+    case DistributionType::Histogram:
+    {
+      const auto & buckets = m_config->buckets;
+      ++m_buckets[static_cast<size_type>(std::ranges::lower_bound(buckets, p_value) - buckets.begin())];
+      break;
+    }
+
+    case DistributionType::Summary:
+      m_sketch.Add(p_value);
+      break;
+
+    case DistributionType::Aggregate:
+      Roll(p_timestamp);
+
+      if(0 == m_window.count)
+      {
+        m_window.min = p_value;
+        m_window.max = p_value;
+      }
+      else
+      {
+        m_window.min = std::min(m_window.min, p_value);
+        m_window.max = std::max(m_window.max, p_value);
+      }
+      m_window.sum += p_value;
+      m_window.last = p_value;
+      ++m_window.count;
+      break;
+  }
+
+  m_sum += p_value;
+  ++m_count;
+}
+
+void Series::Format(Buffer & p_buffer,
+                    std::string_view p_name,
+                    std::string_view p_labels) const
+{
+  std::unique_lock lck{m_mtx};
+
+  auto out = std::back_inserter(p_buffer);
+  const std::string_view separator = p_labels.empty() ? ""sv : ","sv;
+  NumberBuffer bound{};
+  NumberBuffer value{};
+
+  if(DistributionType::Histogram == m_config->type)
+  {
+    const auto & buckets = m_config->buckets;
+    std::uint64_t count = 0;
+
+    for(size_type idx = 0; idx < buckets.size(); ++idx)
+    {
+      count += m_buckets[idx];
+      out = fmt::format_to(out,
+                           "{}_bucket{{{}{}le=\"{}\"}} {}\n"_cf,
+                           p_name,
+                           p_labels,
+                           separator,
+                           NumericValue{buckets[idx]}.Format(bound),
+                           count);
+    }
+
+    out = fmt::format_to(out,
+                         "{}_bucket{{{}{}le=\"+Inf\"}} {}\n"_cf,
+                         p_name,
+                         p_labels,
+                         separator,
+                         count + m_buckets.back());
+  }
+  else
+  {
+    for(const auto quantile : m_config->quantiles)
+    {
+      out = fmt::format_to(out,
+                           "{}{{{}{}quantile=\"{}\"}} {}\n"_cf,
+                           p_name,
+                           p_labels,
+                           separator,
+                           NumericValue{quantile}.Format(bound),
+                           NumericValue{m_sketch.Quantile(quantile)}.Format(value));
+    }
+  }
+
+  if(p_labels.empty())
+  {
+    out = fmt::format_to(out,
+                         "{}_sum {}\n{}_count {}\n"_cf,
+                         p_name,
+                         NumericValue{m_sum}.Format(value),
+                         p_name,
+                         m_count);
+  }
+  else
+  {
+    out = fmt::format_to(out,
+                         "{}_sum{{{}}} {}\n{}_count{{{}}} {}\n"_cf,
+                         p_name,
+                         p_labels,
+                         NumericValue{m_sum}.Format(value),
+                         p_name,
+                         p_labels,
+                         m_count);
+  }
+}
+
+Series::Window Series::Aggregates(timestamp_type p_now)
+{
+  std::unique_lock lck{m_mtx};
+
+  if(std::chrono::seconds::zero() == m_config->window)
+  {
+    return std::exchange(m_window, Window{});
+  }
+
+  Roll(p_now);
+
+  return m_last_window;
+}
+
+void Series::Roll(timestamp_type p_timestamp) noexcept
+{
+  if(std::chrono::seconds::zero() == m_config->window)
+  {
+    return;
+  }
+
+  // Windows are aligned to the epoch, so all series roll together.
+  if(const std::int64_t window_id = p_timestamp / m_config->window;
+     window_id > m_window_id)
+  {
+    // A window without values is empty.
+    m_last_window = (window_id == (m_window_id + 1)) ? m_window : Window{};
+    m_window = Window{};
+    m_window_id = window_id;
+  }
+}
+
+Family::Family(std::string_view p_name,
+               DistributionConfig && p_config):
+  m_name(p_name),
+  m_config(std::move(p_config))
+{
+}
+
+SeriesPtr Family::AddSeries(std::string_view p_labels)
+{
+  std::unique_lock lck{m_mtx};
+
+  auto series = m_series.find(p_labels);
+  if(m_series.end() == series)
+  {
+    series = m_series.emplace(std::string{p_labels}, std::make_shared<Series>(m_config)).first;
+  }
+
+  return series->second;
+}
+
+void Family::Format(Buffer & p_buffer,
+                    timestamp_type p_now)
+{
+  std::unique_lock lck{m_mtx};
+
+  if(m_series.empty())
+  {
+    return;
+  }
+
+  if(DistributionType::Aggregate == m_config.type)
+  {
+    FormatAggregates(p_buffer, p_now);
+    return;
+  }
+
+  fmt::format_to(std::back_inserter(p_buffer),
+                 "# TYPE {} {}\n"_cf,
+                 m_name,
+                 decode_type_name(m_config.type));
+
+  for(const auto & [labels, series] : m_series)
+  {
+    series->Format(p_buffer, m_name, labels);
+  }
+}
+
+void Family::FormatAggregates(Buffer & p_buffer,
+                              timestamp_type p_now)
+{
+  // Take each series' window once, as taking it can reset it.
+  m_windows.clear();
+  for(const auto & [labels, series] : m_series)
+  {
+    if(auto window = series->Aggregates(p_now);
+       0 != window.count)
+    {
+      m_windows.emplace_back(labels, window);
+    }
+  }
+
+  if(m_windows.empty())
+  {
+    return;
+  }
+
+  auto out = std::back_inserter(p_buffer);
+  NumberBuffer value{};
+
+  for(const auto aggregate : m_config.aggregates)
+  {
+    const auto aggregate_name = decode_aggregate_name(aggregate);
+
+    out = fmt::format_to(out,
+                         "# TYPE {}_{} gauge\n"_cf,
+                         m_name,
+                         aggregate_name);
+
+    for(const auto & [labels, window] : m_windows)
+    {
+      if(labels.empty())
+      {
+        out = fmt::format_to(out,
+                             "{}_{} {}\n"_cf,
+                             m_name,
+                             aggregate_name,
+                             aggregate_value(aggregate, window).Format(value));
+      }
+      else
+      {
+        out = fmt::format_to(out,
+                             "{}_{}{{{}}} {}\n"_cf,
+                             m_name,
+                             aggregate_name,
+                             labels,
+                             aggregate_value(aggregate, window).Format(value));
+      }
+    }
+  }
+}
+
+FamilyPtr add_family(std::string_view p_name,
+                     DistributionConfig && p_config)
+{
+  std::unique_lock lck{g_families_mtx};
+
+  auto family = g_families.find(p_name);
+  if(g_families.end() == family)
+  {
+    family = g_families.emplace(std::string{p_name},
+                                std::make_shared<Family>(p_name, std::move(p_config))).first;
+  }
+
+  return family->second;
+}
+
+void append_label(std::string & p_labels,
+                  std::string_view p_name,
+                  std::string_view p_value)
+{
+  if(!p_labels.empty())
+  {
+    p_labels.push_back(',');
+  }
+
+  p_labels.append(p_name);
+  p_labels.append("=\""sv);
+  for(const char ch : p_value)
+  {
+    switch(ch)
+    {
+      case '\\':
+        p_labels.append("\\\\"sv);
+        break;
+
+      case '"':
+        p_labels.append("\\\""sv);
+        break;
+
+      case '\n':
+        p_labels.append("\\n"sv);
+        break;
+
+      default:
+        p_labels.push_back(ch);
+        break;
+    }
+  }
+  p_labels.push_back('"');
+}
+
+void format_distributions(Buffer & p_buffer)
+{
+  const timestamp_type now{std::chrono::time_point_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now()).time_since_epoch()};
+
+  std::unique_lock lck{g_families_mtx};
+
+  for(const auto & [name, family] : g_families)
+  {
+    family->Format(p_buffer, now);
+  }
+}
+
+} // namespace yafiyogi::mqtt_bridge::distributions
@@ -0,0 +1,238 @@
+/*
+
+  MIT License
+
+  Copyright (c) 2025 Yafiyogi
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <tuple>
+
+#include "yy_cpp/yy_observer_ptr.hpp"
+#include "yy_cpp/yy_types.hpp"
+#include "yy_cpp/yy_vector.h"
+
+namespace yafiyogi::mqtt_bridge::distributions {
+
+// Histogram, summary & aggregate metrics, built from each value a
+// metric gets and published alongside the bridge's other metrics.
+
+enum class DistributionType:uint8_t {Histogram, Summary, Aggregate};
+
+// Aggregates of the values in a window, published as gauges named
+// '<metric>_<aggregate>'.
+enum class Aggregate:uint8_t {Min, Max, Avg, Count, Last};
+
+struct DistributionConfig final
+{
+    static constexpr double default_relative_accuracy = 0.01;
+    static constexpr size_type default_max_bins = 1024;
+
+    DistributionType type = DistributionType::Histogram;
+    // Histogram bucket upper bounds, ascending. '+Inf' is implied.
+    yy_quad::simple_vector<double> buckets{};
+    // Summary quantiles, from 0 to 1.
+    yy_quad::simple_vector<double> quantiles{};
+    double relative_accuracy = default_relative_accuracy;
+    size_type max_bins = default_max_bins;
+    // Aggregates published, in order.
+    yy_quad::simple_vector<Aggregate> aggregates{};
+    // Aggregates are of the values in the last complete window. Without
+    // a window they are of the values since the previous scrape.
+    std::chrono::seconds window{};
+};
+
+// DDSketch: a quantile sketch whose estimates are within a relative
+// accuracy of the true value. Values are counted in logarithmically
+// sized bins, so the bins needed only grow with the log of the
+// values' range. If a store needs more than max_bins, its lowest bins
+// are collapsed, losing accuracy on the lowest quantiles first.
+class DDSketch final
+{
+  public:
+    explicit DDSketch(double p_relative_accuracy,
+                      size_type p_max_bins);
+
+    DDSketch() = delete;
+    DDSketch(const DDSketch &) = default;
+    DDSketch(DDSketch &&) noexcept = default;
+
+    DDSketch & operator=(const DDSketch &) = default;
+    DDSketch & operator=(DDSketch &&) noexcept = default;
+
+    void Add(double p_value);
+
+    // NaN if nothing has been added.
+    [[nodiscard]]
+    double Quantile(double p_quantile) const noexcept;
+
+    [[nodiscard]]
+    constexpr std::uint64_t Count() const noexcept
+    {
+      return m_count;
+    }
+
+  private:
+    // Counts of consecutive bin indexes, from offset.
+    struct Store final
+    {
+        void Add(int p_index, size_type p_max_bins);
+
+        yy_quad::simple_vector<std::uint64_t> bins{};
+        int offset = 0;
+    };
+
+    [[nodiscard]]
+    int Index(double p_value) const noexcept;
+    [[nodiscard]]
+    double Value(int p_index) const noexcept;
+
+    double m_gamma = 0;
+    double m_log_gamma = 0;
+    size_type m_max_bins = 0;
+    Store m_positive{};
+    Store m_negative{};
+    std::uint64_t m_zero = 0;
+    std::uint64_t m_count = 0;
+    double m_min = 0;
+    double m_max = 0;
+};
+
+using Buffer = yy_quad::simple_vector<char, yy_data::ClearAction::Keep>;
+
+// The distribution of a metric's values for a set of labels. Memory
+// is fixed by the number of buckets (histograms) or aggregates, or
+// bounded by the sketch's max_bins (summaries), however many values
+// are observed. Series are shared by the ingest workers, so are locked.
+class Series final
+{
+  public:
+    struct Window final
+    {
+        double min = 0;
+        double max = 0;
+        double sum = 0;
+        double last = 0;
+        std::uint64_t count = 0;
+    };
+
+    explicit Series(const DistributionConfig & p_config);
+
+    Series() = delete;
+    Series(const Series &) = delete;
+    Series(Series &&) = delete;
+
+    Series & operator=(const Series &) = delete;
+    Series & operator=(Series &&) = delete;
+
+    void Observe(double p_value,
+                 timestamp_type p_timestamp);
+
+    // Histograms & summaries.
+    void Format(Buffer & p_buffer,
+                std::string_view p_name,
+                std::string_view p_labels) const;
+
+    // Aggregates: the window to publish at p_now. Without a window,
+    // the values since the previous call.
+    [[nodiscard]]
+    Window Aggregates(timestamp_type p_now);
+
+  private:
+    // Starts the window containing p_timestamp.
+    void Roll(timestamp_type p_timestamp) noexcept;
+
+    mutable std::mutex m_mtx{};
+    yy_data::observer_ptr<const DistributionConfig> m_config{};
+    // Histogram: the count of each bucket, not cumulative, then '+Inf'.
+    yy_quad::simple_vector<std::uint64_t> m_buckets{};
+    DDSketch m_sketch;
+    double m_sum = 0;
+    std::uint64_t m_count = 0;
+    Window m_window{};
+    Window m_last_window{};
+    std::int64_t m_window_id = 0;
+};
+
+using SeriesPtr = std::shared_ptr<Series>;
+
+// A histogram, summary or aggregate metric's series, by label.
+class Family final
+{
+  public:
+    explicit Family(std::string_view p_name,
+                    DistributionConfig && p_config);
+
+    Family() = delete;
+    Family(const Family &) = delete;
+    Family(Family &&) = delete;
+
+    Family & operator=(const Family &) = delete;
+    Family & operator=(Family &&) = delete;
+
+    // Returns the series for labels in exposition format (see
+    // append_label()), creating it if needed.
+    SeriesPtr AddSeries(std::string_view p_labels);
+
+    [[nodiscard]]
+    constexpr DistributionType Type() const noexcept
+    {
+      return m_config.type;
+    }
+
+    void Format(Buffer & p_buffer,
+                timestamp_type p_now);
+
+  private:
+    void FormatAggregates(Buffer & p_buffer,
+                          timestamp_type p_now);
+
+    std::string m_name{};
+    DistributionConfig m_config{};
+    std::mutex m_mtx{};
+    std::map<std::string, SeriesPtr, std::less<>> m_series{};
+    yy_quad::simple_vector<std::tuple<std::string_view, Series::Window>> m_windows{};
+};
+
+using FamilyPtr = std::shared_ptr<Family>;
+
+// Returns the family for a metric name, creating it if needed. Each
+// ingest worker configures its own metrics, which share the family.
+FamilyPtr add_family(std::string_view p_name,
+                     DistributionConfig && p_config);
+
+// Appends 'name="value"' to p_labels, escaping the value.
+void append_label(std::string & p_labels,
+                  std::string_view p_name,
+                  std::string_view p_value);
+
+void format_distributions(Buffer & p_buffer);
+
+} // namespace yafiyogi::mqtt_bridge::distributions
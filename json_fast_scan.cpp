@@ -0,0 +1,297 @@
+/*
+
+  MIT License
+
+  Copyright (c) 2025 Yafiyogi
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+#include <cstdint>
+#include <cstring>
+
+#include <bit>
+#include <limits>
+#include <string>
+#include <string_view>
+
+#include "byte_classify.h"
+
+#include "json_fast_scan.h"
+
+namespace yafiyogi::mqtt_bridge::json_fast {
+namespace {
+
+using byte_classify::block_size;
+
+constexpr size_type quote_class = 0;
+constexpr size_type backslash_class = 1;
+constexpr size_type structural_class = 2;
+
+// Quotes, backslashes & structural characters.
+using JsonBytes = byte_classify::ByteSet<1, 1, 6>;
+
+constexpr JsonBytes g_json_bytes{{'"', '\\', '{', '}', '[', ']', ':', ','}};
+
+// Characters preceded by an unescaped backslash. Backslashes are rare,
+// so runs are resolved a bit at a time.
+std::uint64_t find_escaped(std::uint64_t p_backslash,
+                           bool & p_escape_carry) noexcept
+{
+  std::uint64_t escaped = 0;
+
+  if(p_escape_carry)
+  {
+    escaped = 1;
+    p_backslash &= ~std::uint64_t{1};
+    p_escape_carry = false;
+  }
+
+  while(0 != p_backslash)
+  {
+    const int pos = std::countr_zero(p_backslash);
+
+    if(63 == pos)
+    {
+      p_escape_carry = true;
+      break;
+    }
+
+    // The escaped character can't start an escape.
+    escaped |= std::uint64_t{1} << (pos + 1);
+    p_backslash &= ~(std::uint64_t{3} << pos);
+  }
+
+  return escaped;
+}
+
+constexpr std::uint64_t prefix_xor(std::uint64_t p_bits) noexcept
+{
+  p_bits ^= p_bits << 1;
+  p_bits ^= p_bits << 2;
+  p_bits ^= p_bits << 4;
+  p_bits ^= p_bits << 8;
+  p_bits ^= p_bits << 16;
+  p_bits ^= p_bits << 32;
+
+  return p_bits;
+}
+
+} // anonymous namespace
+
+bool structural_index(std::string_view p_json,
+                      StructuralIndex & p_index)
+{
+  p_index.clear();
+
+  if(p_json.size() >= std::numeric_limits<std::uint32_t>::max())
+  {
+    return false;
+  }
+
+  const auto classify = byte_classify::classifier<JsonBytes>().classify;
+  bool escape_carry = false;
+  std::uint64_t in_string_carry = 0;
+  char tail[block_size];
+
+  for(size_type base = 0; base < p_json.size(); base += block_size)
+  {
+    const char * block = p_json.data() + base;
+
+    if((p_json.size() - base) < block_size)
+    {
+      // Pad the last block with spaces.
+      std::memset(tail, ' ', block_size);
+      std::memcpy(tail, block, p_json.size() - base);
+      block = tail;
+    }
+
+    const auto masks = classify(block, g_json_bytes);
+    const auto quotes = masks[quote_class] & ~find_escaped(masks[backslash_class], escape_carry);
+    // Opening quote up to, not including, the closing quote.
+    const auto in_string = prefix_xor(quotes) ^ in_string_carry;
+    in_string_carry = 0 - (in_string >> 63);
+
+    auto structurals = (masks[structural_class] & ~in_string) | quotes;
+    while(0 != structurals)
+    {
+      p_index.emplace_back(static_cast<std::uint32_t>(base + static_cast<size_type>(std::countr_zero(structurals))));
+      structurals &= structurals - 1;
+    }
+  }
+
+  return 0 == in_string_carry;
+}
+
+bool unescape(std::string_view p_raw,
+              std::string & p_str)
+{
+  auto hex4 = [&p_raw](size_type p_pos, char32_t & p_code) {
+    if((p_pos + 4) > p_raw.size())
+    {
+      return false;
+    }
+
+    p_code = 0;
+    for(size_type idx = p_pos; idx < p_pos + 4; ++idx)
+    {
+      const char ch = p_raw[idx];
+      p_code <<= 4;
+
+      if((ch >= '0') && (ch <= '9'))
+      {
+        p_code |= static_cast<char32_t>(ch - '0');
+      }
+      else if((ch >= 'a') && (ch <= 'f'))
+      {
+        p_code |= static_cast<char32_t>(ch - 'a' + 10);
+      }
+      else if((ch >= 'A') && (ch <= 'F'))
+      {
+        p_code |= static_cast<char32_t>(ch - 'A' + 10);
+      }
+      else
+      {
+        return false;
+      }
+    }
+
+    return true;
+  };
+
+  size_type pos = 0;
+  while(pos < p_raw.size())
+  {
+    const auto backslash = p_raw.find('\\', pos);
+    p_str.append(p_raw.substr(pos, backslash - pos));
+
+    if(std::string_view::npos == backslash)
+    {
+      break;
+    }
+
+    pos = backslash + 1;
+    if(pos == p_raw.size())
+    {
+      return false;
+    }
+
+    switch(p_raw[pos++])
+    {
+      case '"':
+        p_str.push_back('"');
+        break;
+
+      case '\\':
+        p_str.push_back('\\');
+        break;
+
+      case '/':
+        p_str.push_back('/');
+        break;
+
+      case 'b':
+        p_str.push_back('\b');
+        break;
+
+      case 'f':
+        p_str.push_back('\f');
+        break;
+
+      case 'n':
+        p_str.push_back('\n');
+        break;
+
+      case 'r':
+        p_str.push_back('\r');
+        break;
+
+      case 't':
+        p_str.push_back('\t');
+        break;
+
+      case 'u':
+      {
+        char32_t code = 0;
+        if(!hex4(pos, code))
+        {
+          return false;
+        }
+        pos += 4;
+
+        if((code >= 0xD800) && (code < 0xDC00))
+        {
+          // High surrogate: must be followed by an escaped low surrogate.
+          char32_t low = 0;
+          if(((pos + 2) > p_raw.size())
+             || ('\\' != p_raw[pos])
+             || ('u' != p_raw[pos + 1])
+             || !hex4(pos + 2, low)
+             || (low < 0xDC00) || (low >= 0xE000))
+          {
+            return false;
+          }
+          pos += 6;
+          code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+        }
+        else if((code >= 0xDC00) && (code < 0xE000))
+        {
+          return false;
+        }
+
+        if(code < 0x80)
+        {
+          p_str.push_back(static_cast<char>(code));
+        }
+        else if(code < 0x800)
+        {
+          p_str.push_back(static_cast<char>(0xC0 | (code >> 6)));
+          p_str.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+        }
+        else if(code < 0x10000)
+        {
+          p_str.push_back(static_cast<char>(0xE0 | (code >> 12)));
+          p_str.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+          p_str.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+        }
+        else
+        {
+          p_str.push_back(static_cast<char>(0xF0 | (code >> 18)));
+          p_str.push_back(static_cast<char>(0x80 | ((code >> 12) & 0x3F)));
+          p_str.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+          p_str.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+        }
+        break;
+      }
+
+      default:
+        return false;
+    }
+  }
+
+  return true;
+}
+
+std::string_view structural_index_isa() noexcept
+{
+  return byte_classify::classifier<JsonBytes>().isa;
+}
+
+} // namespace yafiyogi::mqtt_bridge::json_fast
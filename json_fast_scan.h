@@ -0,0 +1,58 @@
+/*
+
+  MIT License
+
+  Copyright (c) 2025 Yafiyogi
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <cstdint>
+
+#include <string>
+#include <string_view>
+
+#include "yy_cpp/yy_types.hpp"
+#include "yy_cpp/yy_vector.h"
+
+namespace yafiyogi::mqtt_bridge::json_fast {
+
+// Positions of a JSON document's unescaped quotes, and of its
+// structural characters ('{', '}', '[', ']', ':' & ',') outside
+// strings, in document order.
+using StructuralIndex = yy_quad::simple_vector<std::uint32_t, yy_data::ClearAction::Keep>;
+
+// Builds the structural index 64 bytes at a time, classifying bytes
+// with AVX2 or SSE4.2 when the CPU supports them. Returns false if the
+// document is too large to index or ends inside a string.
+bool structural_index(std::string_view p_json,
+                      StructuralIndex & p_index);
+
+// Decodes the escapes of a JSON string's contents, without the
+// quotes, appending to p_str. Returns false on a malformed escape.
+bool unescape(std::string_view p_raw,
+              std::string & p_str);
+
+// Name of the classifier in use ("avx2", "sse4.2" or "scalar").
+std::string_view structural_index_isa() noexcept;
+
+} // namespace yafiyogi::mqtt_bridge::json_fast
@@ -0,0 +1,361 @@
+/*
+
+  MIT License
+
+  Copyright (c) 2025 Yafiyogi
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+#include <cstring>
+
+#include <array>
+#include <span>
+#include <string>
+#include <string_view>
+
+#include "json_shape.h"
+
+namespace yafiyogi::mqtt_bridge {
+namespace {
+
+constexpr std::string_view whitespace{" \t\r\n"};
+// Characters that end a scalar.
+constexpr std::string_view scalar_end{",}] \t\r\n"};
+
+size_type skip_whitespace(std::string_view p_json,
+                          size_type p_pos) noexcept
+{
+  const auto pos = p_json.find_first_not_of(whitespace, p_pos);
+
+  return std::string_view::npos == pos ? p_json.size() : pos;
+}
+
+// End of the string starting at p_pos (its closing quote + 1), or npos
+// if unterminated or escaped.
+size_type string_end(std::string_view p_json,
+                     size_type p_pos) noexcept
+{
+  const auto end = p_json.find('"', p_pos + 1);
+  if((std::string_view::npos == end)
+     || (nullptr != std::memchr(p_json.data() + p_pos + 1, '\\', end - p_pos - 1)))
+  {
+    return std::string_view::npos;
+  }
+
+  return end + 1;
+}
+
+// End of the string starting at p_pos (its closing quote + 1), skipping
+// escapes, or npos if unterminated.
+size_type escaped_string_end(std::string_view p_json,
+                             size_type p_pos) noexcept
+{
+  for(size_type pos = p_pos + 1; pos < p_json.size(); ++pos)
+  {
+    if('\\' == p_json[pos])
+    {
+      ++pos;
+    }
+    else if('"' == p_json[pos])
+    {
+      return pos + 1;
+    }
+  }
+
+  return std::string_view::npos;
+}
+
+// End of the object or array starting at p_pos (its closing bracket +
+// 1), or npos if unterminated, unbalanced or nested too deeply.
+size_type nested_value_end(std::string_view p_json,
+                           size_type p_pos) noexcept
+{
+  constexpr std::string_view structural{"\"{}[]"};
+  constexpr size_type max_depth = 64;
+  std::array<char, max_depth> closers{};
+  size_type depth = 0;
+
+  size_type pos = p_pos;
+  while(std::string_view::npos != (pos = p_json.find_first_of(structural, pos)))
+  {
+    switch(const char ch = p_json[pos])
+    {
+      case '"':
+        pos = escaped_string_end(p_json, pos);
+        if(std::string_view::npos == pos)
+        {
+          return std::string_view::npos;
+        }
+        continue;
+
+      case '{':
+      case '[':
+        if(max_depth == depth)
+        {
+          return std::string_view::npos;
+        }
+        closers[depth++] = ('{' == ch) ? '}' : ']';
+        break;
+
+      default:
+        if((0 == depth) || (closers[--depth] != ch))
+        {
+          return std::string_view::npos;
+        }
+        if(0 == depth)
+        {
+          return pos + 1;
+        }
+        break;
+    }
+    ++pos;
+  }
+
+  return std::string_view::npos;
+}
+
+// End of the scalar starting at p_pos.
+size_type scalar_value_end(std::string_view p_json,
+                           size_type p_pos) noexcept
+{
+  const auto end = p_json.find_first_of(scalar_end, p_pos);
+
+  return std::string_view::npos == end ? p_json.size() : end;
+}
+
+} // anonymous namespace
+
+bool JsonShape::learn(std::string_view p_json,
+                      std::span<const std::string> p_targets)
+{
+  clear();
+  m_state = State::NotFlat;
+
+  size_type pos = skip_whitespace(p_json, 0);
+  if((pos == p_json.size()) || ('{' != p_json[pos]))
+  {
+    return false;
+  }
+
+  size_type prefix_begin = 0;
+  pos = skip_whitespace(p_json, pos + 1);
+  if((pos < p_json.size()) && ('}' == p_json[pos]))
+  {
+    // Empty object.
+    return false;
+  }
+
+  while(pos < p_json.size())
+  {
+    if('"' != p_json[pos])
+    {
+      return false;
+    }
+
+    const size_type key_end = string_end(p_json, pos);
+    if(std::string_view::npos == key_end)
+    {
+      return false;
+    }
+    const auto key = p_json.substr(pos + 1, key_end - pos - 2);
+
+    pos = skip_whitespace(p_json, key_end);
+    if((pos == p_json.size()) || (':' != p_json[pos]))
+    {
+      return false;
+    }
+
+    pos = skip_whitespace(p_json, pos + 1);
+    if(pos == p_json.size())
+    {
+      return false;
+    }
+
+    Field field{};
+    field.prefix.assign(p_json.substr(prefix_begin, pos - prefix_begin));
+
+    for(size_type idx = 0; idx < p_targets.size(); ++idx)
+    {
+      if(p_targets[idx] == key)
+      {
+        field.target = idx;
+        break;
+      }
+    }
+
+    size_type value_end = 0;
+    switch(p_json[pos])
+    {
+      case '"':
+        // Only target strings need to be free of escapes.
+        field.kind = Kind::String;
+        value_end = no_target == field.target ? escaped_string_end(p_json, pos) : string_end(p_json, pos);
+        if(std::string_view::npos == value_end)
+        {
+          return false;
+        }
+        break;
+
+      case '{':
+      case '[':
+        if(no_target != field.target)
+        {
+          return false;
+        }
+        field.kind = Kind::Nested;
+        value_end = nested_value_end(p_json, pos);
+        if(std::string_view::npos == value_end)
+        {
+          return false;
+        }
+        break;
+
+      default:
+        value_end = scalar_value_end(p_json, pos);
+        break;
+    }
+
+    m_fields.emplace_back(std::move(field));
+    prefix_begin = value_end;
+
+    pos = skip_whitespace(p_json, value_end);
+    if(pos == p_json.size())
+    {
+      return false;
+    }
+
+    if('}' == p_json[pos])
+    {
+      m_suffix.assign(p_json.substr(prefix_begin));
+      m_state = State::Learned;
+      return true;
+    }
+
+    if(',' != p_json[pos])
+    {
+      return false;
+    }
+
+    pos = skip_whitespace(p_json, pos + 1);
+  }
+
+  return false;
+}
+
+bool JsonShape::match(std::string_view p_json,
+                      Values & p_values) const
+{
+  p_values.clear();
+
+  if(State::Learned != m_state)
+  {
+    return false;
+  }
+
+  size_type pos = 0;
+  for(const auto & field : m_fields)
+  {
+    if((p_json.size() - pos) < field.prefix.size()
+       || (0 != std::memcmp(p_json.data() + pos, field.prefix.data(), field.prefix.size())))
+    {
+      return false;
+    }
+    pos += field.prefix.size();
+
+    size_type value_end = 0;
+    if(Kind::String == field.kind)
+    {
+      if((pos == p_json.size()) || ('"' != p_json[pos]))
+      {
+        return false;
+      }
+
+      if(no_target == field.target)
+      {
+        value_end = escaped_string_end(p_json, pos);
+        if(std::string_view::npos == value_end)
+        {
+          return false;
+        }
+      }
+      else
+      {
+        value_end = string_end(p_json, pos);
+        if(std::string_view::npos == value_end)
+        {
+          return false;
+        }
+
+        p_values.emplace_back(Value{field.target, p_json.substr(pos + 1, value_end - pos - 2), true});
+      }
+    }
+    else if(Kind::Nested == field.kind)
+    {
+      if((pos == p_json.size()) || (('{' != p_json[pos]) && ('[' != p_json[pos])))
+      {
+        return false;
+      }
+
+      value_end = nested_value_end(p_json, pos);
+      if(std::string_view::npos == value_end)
+      {
+        return false;
+      }
+    }
+    else
+    {
+      value_end = scalar_value_end(p_json, pos);
+      if(value_end == pos)
+      {
+        return false;
+      }
+
+      switch(p_json[pos])
+      {
+        case '"':
+        case '{':
+        case '[':
+          return false;
+
+        default:
+          break;
+      }
+
+      if(no_target != field.target)
+      {
+        p_values.emplace_back(Value{field.target, p_json.substr(pos, value_end - pos), false});
+      }
+    }
+
+    pos = value_end;
+  }
+
+  return p_json.substr(pos) == m_suffix;
+}
+
+void JsonShape::clear() noexcept
+{
+  m_fields.clear(yy_data::ClearAction::Keep);
+  m_suffix.clear();
+  m_state = State::Unknown;
+}
+
+} // namespace yafiyogi::mqtt_bridge
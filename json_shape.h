@@ -0,0 +1,102 @@
+/*
+
+  MIT License
+
+  Copyright (c) 2025 Yafiyogi
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <cstdint>
+
+#include <span>
+#include <string>
+#include <string_view>
+
+#include "yy_cpp/yy_types.hpp"
+#include "yy_cpp/yy_vector.h"
+
+namespace yafiyogi::mqtt_bridge {
+
+// Layout of a JSON object: its keys in order, and the bytes between its
+// values. Devices usually publish the same keys in the same order, with
+// the same spacing, only changing the values. A payload matches the
+// shape if the bytes between its values are the same, so its values are
+// found by comparing bytes & scanning each value, without parsing.
+// Nested objects & arrays that aren't targets (e.g. Zigbee2MQTT's
+// 'update') are skipped by matching brackets, so their contents may
+// change.
+class JsonShape final
+{
+  public:
+    static constexpr size_type no_target = static_cast<size_type>(-1);
+
+    struct Value final
+    {
+        size_type target = no_target;
+        // String contents, or a scalar's text.
+        std::string_view raw{};
+        bool is_string = false;
+    };
+
+    using Values = yy_quad::simple_vector<Value, yy_data::ClearAction::Keep>;
+
+    enum class State:uint8_t {Unknown, Learned, NotFlat};
+
+    // Learns p_json's shape. A value whose key is p_targets[idx] is a
+    // target, reported by match() with target idx. Returns false, &
+    // the state is NotFlat, if p_json isn't an object, or a target
+    // isn't a scalar or a string without escapes.
+    bool learn(std::string_view p_json,
+               std::span<const std::string> p_targets);
+
+    // Finds the target values of a payload with the learned shape.
+    // Returns false if p_json doesn't match.
+    bool match(std::string_view p_json,
+               Values & p_values) const;
+
+    [[nodiscard]]
+    constexpr State state() const noexcept
+    {
+      return m_state;
+    }
+
+    void clear() noexcept;
+
+  private:
+    enum class Kind:uint8_t {Scalar, String, Nested};
+
+    struct Field final
+    {
+        // Bytes from the end of the previous value to this value.
+        std::string prefix{};
+        size_type target = no_target;
+        Kind kind = Kind::Scalar;
+    };
+
+    yy_quad::simple_vector<Field, yy_data::ClearAction::Keep> m_fields{};
+    // Bytes after the last value.
+    std::string m_suffix{};
+    State m_state = State::Unknown;
+};
+
+} // namespace yafiyogi::mqtt_bridge
@@ -26,16 +26,15 @@
 
 #include <cstdint>
 
+#include <algorithm>
 #include <chrono>
 #include <string_view>
 
+#include "fmt/compile.h"
+#include "fmt/format.h"
 #include "spdlog/spdlog.h"
 
 #include "yy_mqtt/yy_mqtt_util.h"
-#include "yy_values/yy_values_metric_labels.hpp"
-
-#include "yy_prometheus/yy_prometheus_style.h"
-#include "yy_prometheus/yy_prometheus_cache.h"
 
 #include "configure_mqtt.h"
 #include "mqtt_handler.h"
@@ -45,19 +44,76 @@
 namespace yafiyogi::mqtt_bridge {
 
 using namespace std::string_view_literals;
+using namespace fmt::literals;
 
 mqtt_client::mqtt_client(mqtt_config & p_config,
+                         size_type p_connection,
                          yy_prometheus::MetricDataCachePtr p_metric_cache):
   mosqpp::mosquittopp(),
-  m_topics(std::move(p_config.topics)),
-  m_subscriptions(std::move(p_config.subscriptions)),
-  m_metric_cache(std::move(p_metric_cache)),
-  m_host(std::move(p_config.host)),
+  m_subscriptions(p_config.subscriptions),
+  m_max_outstanding(p_config.subscribe.max_outstanding),
+  m_max_packet_size(p_config.subscribe.max_packet_size),
+  m_first_connection(0 == p_connection),
+  m_host(p_config.host),
   m_port(p_config.port)
 {
+  const auto labels{fmt::format("connection=\"{}\""_cf, p_connection)};
+
+  m_subscribe_time = stats::add_stat("mqtt_bridge_subscribe_milliseconds"sv,
+                                     "Time from connecting to all subscriptions being acknowledged."sv,
+                                     stats::StatType::Gauge,
+                                     labels);
+  m_subscribe_failures = stats::add_stat("mqtt_bridge_subscribe_failures_total"sv,
+                                         "Subscriptions refused by the MQTT server."sv,
+                                         stats::StatType::Counter,
+                                         labels);
+  m_subscribe_failed_filters = stats::add_stat("mqtt_bridge_subscribe_failed_filters"sv,
+                                               "Subscriptions refused by the MQTT server since connecting."sv,
+                                               stats::StatType::Gauge,
+                                               labels);
+
+  CreateSubscribeChunks(m_max_packet_size);
+  m_subscribe_outstanding.reserve(m_max_outstanding);
+
+  const size_type connection_ingests = p_config.ingests.size() / std::max(p_config.connections, size_type{1});
+  const size_type first_ingest = p_connection * connection_ingests;
+  const size_type last_ingest = std::min(first_ingest + connection_ingests, p_config.ingests.size());
+
+  if(0 == p_config.pipeline.workers)
+  {
+    if(first_ingest < last_ingest)
+    {
+      m_ingest = std::make_unique<MqttIngest>(std::move(p_config.ingests[first_ingest]),
+                                              std::move(p_metric_cache));
+    }
+  }
+  else
+  {
+    MqttIngests ingests{};
+    ingests.reserve(connection_ingests);
+
+    for(size_type idx = first_ingest; idx < last_ingest; ++idx)
+    {
+      ingests.emplace_back(std::make_unique<MqttIngest>(std::move(p_config.ingests[idx]),
+                                                        p_metric_cache));
+    }
+
+    m_pipeline = std::make_unique<MqttPipeline>(std::move(ingests),
+                                                p_config.pipeline.queue_size,
+                                                p_config.pipeline.overload,
+                                                p_config.pipeline.retained);
+  }
+
   int mqtt_version = MQTT_PROTOCOL_V5;
   mosqpp::mosquittopp::opts_set(MOSQ_OPT_PROTOCOL_VERSION, &mqtt_version);
 
+  if(0 != p_config.receive_maximum)
+  {
+    // Limits the QoS 1 & 2 messages in flight to this client, so the
+    // broker holds back messages while the client is busy.
+    mosqpp::mosquittopp::int_option(MOSQ_OPT_RECEIVE_MAXIMUM, p_config.receive_maximum);
+  }
+
   int nodelay_flag = 1;
   mosqpp::mosquittopp::opts_set(MOSQ_OPT_TCP_NODELAY, &nodelay_flag);
 
@@ -70,31 +126,200 @@ void mqtt_client::connect()
   mosqpp::mosquittopp::connect(m_host.c_str(), m_port, default_keepalive_seconds.count());
 }
 
-void mqtt_client::on_connect(int rc)
+void mqtt_client::CreateSubscribeChunks(size_type p_max_packet_size)
 {
-  m_is_connected = true;
+  // SUBSCRIBE fixed header, packet id & empty properties.
+  constexpr size_type packet_header_size = 1 + 4 + 2 + 1;
+  // Filter length & subscription options.
+  constexpr size_type filter_overhead = 2 + 1;
+
+  m_chunk_packet_size = p_max_packet_size;
+  m_subscribe_filters.clear();
+  m_subscribe_index.clear();
+  m_subscribe_chunks.clear();
+  m_subscribe_filters.reserve(m_subscriptions.size());
+  m_subscribe_index.reserve(m_subscriptions.size());
+
+  // subscribe_multiple() subscribes to all its filters with one QoS.
+  for(int qos = 0; qos <= 2; ++qos)
+  {
+    SubscribeChunk chunk{m_subscribe_filters.size(), 0, qos, 0};
+    size_type packet_size = packet_header_size;
+
+    for(size_type idx = 0; idx < m_subscriptions.size(); ++idx)
+    {
+      auto & sub = m_subscriptions[idx];
+      if((qos != sub.qos) || (sub.exclusive && !m_first_connection))
+      {
+        continue;
+      }
+
+      const size_type filter_size = filter_overhead + sub.filter.size();
+      if((0 != chunk.count) && ((packet_size + filter_size) > p_max_packet_size))
+      {
+        m_subscribe_chunks.emplace_back(chunk);
+        chunk = SubscribeChunk{m_subscribe_filters.size(), 0, qos, 0};
+        packet_size = packet_header_size;
+      }
 
+      m_subscribe_filters.emplace_back(sub.filter.data());
+      m_subscribe_index.emplace_back(idx);
+      packet_size += filter_size;
+      ++chunk.count;
+    }
+
+    if(0 != chunk.count)
+    {
+      m_subscribe_chunks.emplace_back(chunk);
+    }
+  }
+
+  spdlog::info(" Subscribing to [{}] filters in [{}] packets."sv,
+               m_subscribe_filters.size(),
+               m_subscribe_chunks.size());
+}
+
+void mqtt_client::SubscribeNext()
+{
+  while((m_subscribe_outstanding.size() < m_max_outstanding)
+        && (m_subscribe_next < m_subscribe_chunks.size()))
+  {
+    auto & chunk = m_subscribe_chunks[m_subscribe_next];
+
+    if(spdlog::level::debug >= spdlog::get_level())
+    {
+      for(size_type idx = chunk.first; idx < chunk.first + chunk.count; ++idx)
+      {
+        spdlog::debug("{}[{}] qos=[{}]"sv, "\t - "sv, m_subscribe_filters[idx], chunk.qos);
+      }
+    }
+
+    if(const int rc = mosqpp::mosquittopp::subscribe_multiple(&chunk.mid,
+                                                              static_cast<int>(chunk.count),
+                                                              m_subscribe_filters.data() + chunk.first,
+                                                              chunk.qos,
+                                                              0,
+                                                              nullptr);
+       MOSQ_ERR_SUCCESS != rc)
+    {
+      // Resubscribed in full on reconnecting.
+      spdlog::error(" MQTT subscribe failed rc=[{}]"sv, rc);
+      break;
+    }
+
+    m_subscribe_outstanding.emplace_back(m_subscribe_next);
+    ++m_subscribe_next;
+  }
+}
+
+void mqtt_client::on_connect_v5(int rc,
+                                int /* p_flags */,
+                                const mosquitto_property * p_properties)
+{
   spdlog::debug("{}[{}]"sv, "MQTT Connected status="sv, rc);
-  spdlog::info("{}"sv, " Subscribing to:"sv);
 
-  yy_quad::simple_vector<char *> subs{};
-  subs.reserve(m_subscriptions.size());
+  if(0 != rc)
+  {
+    // Refused, so reconnected after the reconnect delay.
+    spdlog::error(" MQTT connection refused rc=[{}] [{}]"sv,
+                  rc,
+                  mosquitto_reason_string(rc));
+    return;
+  }
+
+  m_is_connected = true;
+
+  if(m_pipeline)
+  {
+    m_pipeline->Connected();
+  }
+
+  size_type max_packet_size = m_max_packet_size;
+  if(std::uint32_t server_max_packet_size = 0;
+     nullptr != mosquitto_property_read_int32(p_properties,
+                                              MQTT_PROP_MAXIMUM_PACKET_SIZE,
+                                              &server_max_packet_size,
+                                              false))
+  {
+    spdlog::debug(" MQTT server maximum packet size=[{}]"sv, server_max_packet_size);
+    max_packet_size = std::min(max_packet_size, static_cast<size_type>(server_max_packet_size));
+  }
 
-  for(auto & sub : m_subscriptions)
+  if(max_packet_size != m_chunk_packet_size)
   {
-    spdlog::info("{}[{}]"sv, "\t - "sv, sub);
+    CreateSubscribeChunks(max_packet_size);
+  }
+
+  spdlog::info(" Subscribing to [{}] filters."sv, m_subscribe_filters.size());
 
-    subs.emplace_back(sub.data());
+  m_subscribe_start = clock_type::now();
+  m_subscribe_next = 0;
+  m_subscribe_outstanding.clear();
+  m_subscribe_failed = 0;
+  m_subscribe_failed_filters->Set(0);
+
+  for(auto & chunk : m_subscribe_chunks)
+  {
+    chunk.mid = 0;
   }
 
-  mosqpp::mosquittopp::subscribe_multiple(nullptr, static_cast<int>(subs.size()), subs.data(), 0, 0, nullptr);
+  SubscribeNext();
 }
 
-void mqtt_client::on_subscribe(int /* mid */,
-                               int /* qos_count */,
-                               const int * /* granted_qos */)
+void mqtt_client::on_subscribe(int p_mid,
+                               int p_qos_count,
+                               const int * p_granted_qos)
 {
-  spdlog::info(" MQTT Subscribed."sv);
+  auto outstanding = std::ranges::find_if(m_subscribe_outstanding, [this, p_mid](size_type idx) {
+    return p_mid == m_subscribe_chunks[idx].mid;
+  });
+
+  if(m_subscribe_outstanding.end() == outstanding)
+  {
+    spdlog::debug(" MQTT unexpected SUBACK mid=[{}]"sv, p_mid);
+    return;
+  }
+
+  SubscribeChunk * chunk = &m_subscribe_chunks[*outstanding];
+  chunk->mid = 0;
+  *outstanding = m_subscribe_outstanding.back();
+  m_subscribe_outstanding.pop_back();
+
+  // Granted QoS values of 0x80 & above are MQTT5 failure reason codes.
+  constexpr int failure_reason = 0x80;
+  const size_type granted_count = std::min(static_cast<size_type>(std::max(p_qos_count, 0)), chunk->count);
+  for(size_type idx = 0; idx < granted_count; ++idx)
+  {
+    if(const int granted_qos = p_granted_qos[idx];
+       granted_qos >= failure_reason)
+    {
+      ++m_subscribe_failed;
+      m_subscribe_failures->Add();
+      spdlog::warn(" MQTT subscription refused [{}] reason=[0x{:02x}]"sv,
+                   m_subscriptions[m_subscribe_index[chunk->first + idx]].filter,
+                   granted_qos);
+    }
+    else if(granted_qos < chunk->qos)
+    {
+      spdlog::debug(" MQTT subscription [{}] granted qos=[{}]"sv,
+                    m_subscribe_filters[chunk->first + idx],
+                    granted_qos);
+    }
+  }
+  m_subscribe_failed_filters->Set(m_subscribe_failed);
+
+  SubscribeNext();
+
+  if(m_subscribe_outstanding.empty() && (m_subscribe_next == m_subscribe_chunks.size()))
+  {
+    const auto subscribe_time = std::chrono::duration_cast<std::chrono::milliseconds>(clock_type::now() - m_subscribe_start);
+
+    m_subscribe_time->Set(static_cast<std::uint64_t>(subscribe_time.count()));
+    spdlog::info(" MQTT Subscribed to [{}] filters in [{}ms], [{}] refused."sv,
+                 m_subscribe_filters.size(),
+                 subscribe_time.count(),
+                 m_subscribe_failed);
+  }
 }
 
 void mqtt_client::on_disconnect(int rc)
@@ -105,44 +330,30 @@ void mqtt_client::on_disconnect(int rc)
 
 void mqtt_client::on_message(const struct mosquitto_message * message)
 {
-  if(m_metric_cache)
-  {
-    std::string_view topic{yy_mqtt::topic_trim(message->topic)};
-    if(auto payloads = m_topics.find(topic);
-       !payloads.empty())
-    {
-      spdlog::debug("Processing [{}] payloads=[{}]"sv,
-                    topic,
-                    payloads.size());
-      yy_mqtt::topic_tokenize_view(m_path, topic);
-
-      const std::string_view data{static_cast<std::string_view::value_type *>(message->payload),
-                                  static_cast<std::string_view::size_type>(message->payloadlen)};
+  std::string_view topic{yy_mqtt::topic_trim(message->topic)};
 
-      timestamp_type ts{std::chrono::time_point_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now()).time_since_epoch()};
+  const std::string_view data{static_cast<std::string_view::value_type *>(message->payload),
+                              static_cast<std::string_view::size_type>(message->payloadlen)};
 
-      size_type metric_count = 0;
-      m_metric_data.clear(yy_data::ClearAction::Keep);
+  timestamp_type ts{std::chrono::time_point_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now()).time_since_epoch()};
 
-      yy_prometheus::MetricDataVectorPtr metric_data{&m_metric_data};
-      for(auto & handlers : payloads)
-      {
-        for(auto & handler : *handlers)
-        {
-          metric_count += handler->MetricCount();
-          m_metric_data.reserve(metric_count);
-
-          handler->Event(data, topic, m_path, ts, metric_data);
-        }
-      }
-
-      m_metric_cache->Add(m_metric_data);
-    }
+  if(m_pipeline)
+  {
+    m_pipeline->Push(topic, data, ts, message->retain);
+  }
+  else if(m_ingest)
+  {
+    m_ingest->Process(topic, data, ts);
   }
 }
 
 void mqtt_client::run()
 {
+  if(m_pipeline)
+  {
+    m_pipeline->Start();
+  }
+
   reconnect_delay_set(2, default_reconnect_delay_seconds.count(), false);
   connect();
 
@@ -165,6 +376,12 @@ void mqtt_client::run()
   {
     std::this_thread::sleep_for(default_disconnect_sleep);
   }
+
+  if(m_pipeline)
+  {
+    // Stop from the network thread as it's the pipeline's producer.
+    m_pipeline->Stop();
+  }
 }
 
 void mqtt_client::stop()
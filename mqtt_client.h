@@ -27,27 +27,20 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
 #include <memory>
 #include <string>
 #include <string_view>
 
-#include <memory>
-
 #include "mosquitto/libmosquittopp.h"
 
 #include "yy_mqtt/yy_mqtt_constants.h"
 
-#include "yy_values/yy_values_labels.hpp"
-
+#include "bridge_stats.h"
+#include "mqtt_ingest.h"
+#include "mqtt_pipeline.h"
 #include "mqtt_topics.h"
 
-namespace yafiyogi::yy_prometheus {
-
-class MetricDataCache;
-using MetricDataCachePtr = std::shared_ptr<MetricDataCache>;
-
-} // namespace yafiyogi::yy_prometheus
-
 namespace yafiyogi::mqtt_bridge {
 
 class mqtt_config;
@@ -56,7 +49,9 @@ class mqtt_client final:
       public mosqpp::mosquittopp
 {
   public:
+    // Takes connection 'p_connection's share of config's ingests.
     explicit mqtt_client(mqtt_config & config,
+                         size_type p_connection,
                          yy_prometheus::MetricDataCachePtr p_metric_cache);
 
     mqtt_client() = delete;
@@ -73,23 +68,58 @@ class mqtt_client final:
       return m_is_connected.load(std::memory_order_acquire);
     }
 
-    void on_connect(int rc) override;
+    void on_connect_v5(int rc,
+                       int p_flags,
+                       const mosquitto_property * p_properties) override;
     void on_disconnect(int rc) override;
     void on_message(const struct mosquitto_message * message) override;
-    void on_subscribe(int mid,
-                      int qos_count,
-                      const int * granted_qos) override;
+    void on_subscribe(int p_mid,
+                      int p_qos_count,
+                      const int * p_granted_qos) override;
 
     void run();
     void stop();
 
   private:
-    Topics m_topics{};
+    using clock_type = std::chrono::steady_clock;
+
+    // Subscriptions sent in one SUBSCRIBE packet.
+    struct SubscribeChunk final
+    {
+        size_type first = 0;
+        size_type count = 0;
+        int qos = 0;
+        int mid = 0;
+    };
+
+    using SubscribeChunks = yy_quad::simple_vector<SubscribeChunk>;
+
+    // Chunks are sized to the smaller of the configured & the server's
+    // maximum packet size.
+    void CreateSubscribeChunks(size_type p_max_packet_size);
+    void SubscribeNext();
+
     Subscriptions m_subscriptions{};
-    yy_prometheus::MetricDataVector m_metric_data{};
-    yy_values::Labels m_labels{};
-    yy_mqtt::TopicLevelsView m_path{};
-    yy_prometheus::MetricDataCachePtr m_metric_cache{};
+    // Subscription filters ordered by QoS, and the index of each in
+    // m_subscriptions.
+    yy_quad::simple_vector<char *> m_subscribe_filters{};
+    yy_quad::simple_vector<size_type> m_subscribe_index{};
+    SubscribeChunks m_subscribe_chunks{};
+    size_type m_subscribe_next = 0;
+    // Chunks sent & waiting for a SUBACK. SUBACKs may arrive in any
+    // order, so they're matched by mid.
+    yy_quad::simple_vector<size_type> m_subscribe_outstanding{};
+    size_type m_subscribe_failed = 0;
+    size_type m_max_outstanding = 1;
+    size_type m_max_packet_size = 0;
+    size_type m_chunk_packet_size = 0;
+    bool m_first_connection = false;
+    clock_type::time_point m_subscribe_start{};
+    stats::StatPtr m_subscribe_time{};
+    stats::StatPtr m_subscribe_failures{};
+    stats::StatPtr m_subscribe_failed_filters{};
+    MqttIngestPtr m_ingest{};
+    MqttPipelinePtr m_pipeline{};
     std::string m_host{};
     int m_port = yy_mqtt::mqtt_default_port;
     std::atomic<bool> m_is_connected = false;
@@ -42,10 +42,16 @@ MqttHandler::MqttHandler(std::string_view p_handler_id,
 MqttHandler::MqttHandler(MqttHandler && p_other) noexcept:
   m_metric_count(p_other.m_metric_count),
   m_handler_id(std::move(p_other.m_handler_id)),
-  m_type(p_other.m_type)
+  m_type(p_other.m_type),
+  m_skip_unchanged(p_other.m_skip_unchanged),
+  m_lazy(p_other.m_lazy),
+  m_decode(p_other.m_decode)
 {
   p_other.m_metric_count = 0;
   p_other.m_type = type::Text;
+  p_other.m_skip_unchanged = false;
+  p_other.m_lazy = false;
+  p_other.m_decode = decode::Chain{};
 }
 
 MqttHandler & MqttHandler::operator=(MqttHandler && p_other) noexcept
@@ -57,6 +63,12 @@ MqttHandler & MqttHandler::operator=(MqttHandler && p_other) noexcept
     m_handler_id = std::move(p_other.m_handler_id);
     m_type = p_other.m_type;
     p_other.m_type = type::Text;
+    m_skip_unchanged = p_other.m_skip_unchanged;
+    p_other.m_skip_unchanged = false;
+    m_lazy = p_other.m_lazy;
+    p_other.m_lazy = false;
+    m_decode = p_other.m_decode;
+    p_other.m_decode = decode::Chain{};
   }
 
   return *this;
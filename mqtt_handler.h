@@ -34,14 +34,16 @@
 #include "yy_values/yy_values_metric_data.hpp"
 
 #include "mqtt_handler_fwd.h"
+#include "payload_decode.h"
 #include "prometheus_metric.h"
+#include "topic_match.h"
 
 namespace yafiyogi::mqtt_bridge {
 
 class MqttHandler
 {
   public:
-    enum class type:uint8_t {Json, Text, Value};
+    enum class type:uint8_t {Json, JsonFast, Text, Value, Csv, Logfmt, Cbor, Msgpack, Sparkplug};
 
     explicit MqttHandler(std::string_view p_handler_id,
                          const type p_type,
@@ -73,9 +75,47 @@ class MqttHandler
       return m_metric_count;
     }
 
+    // Skip Event() for a topic whose payload is unchanged since its
+    // last message, re-publishing the previous metrics instead.
+    [[nodiscard]]
+    constexpr bool SkipUnchanged() const noexcept
+    {
+      return m_skip_unchanged;
+    }
+
+    constexpr void SkipUnchanged(bool p_skip_unchanged) noexcept
+    {
+      m_skip_unchanged = p_skip_unchanged;
+    }
+
+    // Only keep a topic's latest payload, handling it when the metrics
+    // are scraped.
+    [[nodiscard]]
+    constexpr bool Lazy() const noexcept
+    {
+      return m_lazy;
+    }
+
+    constexpr void Lazy(bool p_lazy) noexcept
+    {
+      m_lazy = p_lazy;
+    }
+
+    // Decode stages run on a payload before Event() is called.
+    [[nodiscard]]
+    constexpr const decode::Chain & Decode() const noexcept
+    {
+      return m_decode;
+    }
+
+    constexpr void Decode(const decode::Chain & p_decode) noexcept
+    {
+      m_decode = p_decode;
+    }
+
     virtual void Event(std::string_view p_mqtt_data,
                        const std::string_view p_topic,
-                       const yy_mqtt::TopicLevelsView & p_levels ,
+                       const TopicMatch & p_match,
                        const timestamp_type p_timestamp,
                        yy_prometheus::MetricDataVectorPtr p_metric_data) noexcept = 0;
 
@@ -83,6 +123,9 @@ class MqttHandler
     size_type m_metric_count = 0;
     std::string m_handler_id{};
     type m_type = type::Text;
+    bool m_skip_unchanged = false;
+    bool m_lazy = false;
+    decode::Chain m_decode{};
 };
 
 } // namespace yafiyogi::mqtt_bridge
@@ -0,0 +1,883 @@
+/*
+
+  MIT License
+
+  Copyright (c) 2025 Yafiyogi
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+#include <array>
+#include <bit>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+
+#include "spdlog/spdlog.h"
+
+#include "yy_prometheus/yy_prometheus_metric_data.h"
+
+#include "mqtt_handler_binary.h"
+
+namespace yafiyogi::mqtt_bridge {
+
+using namespace std::string_view_literals;
+
+namespace binary {
+namespace {
+
+enum class Walk:uint8_t {Continue, Done, Error};
+
+// A decoded data item. Strings are views into the payload.
+struct Item final
+{
+    enum class Kind:uint8_t {Map, Array, String, Bytes, Int, UInt, Float, Bool, Null, Break, Other};
+
+    static constexpr size_type indefinite = std::numeric_limits<size_type>::max();
+
+    Kind kind = Kind::Other;
+    // Map pairs or array items, or indefinite.
+    size_type count = 0;
+    std::string_view str{};
+    std::int64_t sint = 0;
+    std::uint64_t uint = 0;
+    double real = 0.0;
+    bool flag = false;
+};
+
+// Reads a p_size byte big endian unsigned integer.
+bool read_be(std::string_view p_data,
+             size_type & p_pos,
+             size_type p_size,
+             std::uint64_t & p_value) noexcept
+{
+  if(p_size > (p_data.size() - p_pos))
+  {
+    return false;
+  }
+
+  p_value = 0;
+  for(size_type idx = 0; idx < p_size; ++idx)
+  {
+    p_value = (p_value << 8) | static_cast<std::uint8_t>(p_data[p_pos + idx]);
+  }
+  p_pos += p_size;
+
+  return true;
+}
+
+double half_to_double(std::uint16_t p_half) noexcept
+{
+  const int exponent = (p_half >> 10) & 0x1f;
+  const int mantissa = p_half & 0x3ff;
+  double value = 0.0;
+
+  if(0 == exponent)
+  {
+    value = std::ldexp(mantissa, -24);
+  }
+  else if(31 != exponent)
+  {
+    value = std::ldexp(mantissa + 1024, exponent - 25);
+  }
+  else
+  {
+    value = 0 == mantissa ? std::numeric_limits<double>::infinity() : std::numeric_limits<double>::quiet_NaN();
+  }
+
+  return 0 != (p_half & 0x8000) ? -value : value;
+}
+
+// RFC 8949 CBOR. Tags are skipped; chunked strings are joined into
+// p_str.
+class CborReader final
+{
+  public:
+    explicit CborReader(std::string_view p_data,
+                        std::string & p_str) noexcept:
+      m_data(p_data),
+      m_str(p_str)
+    {
+    }
+
+    [[nodiscard]]
+    size_type remaining() const noexcept
+    {
+      return m_data.size() - m_pos;
+    }
+
+    // Consumes the break ending an indefinite length map or array.
+    [[nodiscard]]
+    bool at_break() noexcept
+    {
+      if((m_pos < m_data.size()) && (0xff == static_cast<std::uint8_t>(m_data[m_pos])))
+      {
+        ++m_pos;
+        return true;
+      }
+
+      return false;
+    }
+
+    [[nodiscard]]
+    bool read(Item & p_item)
+    {
+      while(m_pos < m_data.size())
+      {
+        const auto initial = static_cast<std::uint8_t>(m_data[m_pos++]);
+        const int major = initial >> 5;
+        const int info = initial & 0x1f;
+        std::uint64_t arg = 0;
+        bool indefinite = false;
+
+        if(!read_arg(major, info, arg, indefinite))
+        {
+          return false;
+        }
+
+        switch(major)
+        {
+          case 0:
+            p_item.kind = Item::Kind::UInt;
+            p_item.uint = arg;
+            return true;
+
+          case 1:
+            if(arg > static_cast<std::uint64_t>(std::numeric_limits<std::int64_t>::max()))
+            {
+              p_item.kind = Item::Kind::Float;
+              p_item.real = -1.0 - static_cast<double>(arg);
+              return true;
+            }
+            p_item.kind = Item::Kind::Int;
+            p_item.sint = -1 - static_cast<std::int64_t>(arg);
+            return true;
+
+          case 2:
+          case 3:
+            p_item.kind = 2 == major ? Item::Kind::Bytes : Item::Kind::String;
+            return indefinite ? read_chunks(major, p_item) : read_str(arg, p_item);
+
+          case 4:
+          case 5:
+            p_item.kind = 4 == major ? Item::Kind::Array : Item::Kind::Map;
+            p_item.count = indefinite ? Item::indefinite : static_cast<size_type>(arg);
+            return true;
+
+          case 6:
+            // A tag annotates the next item.
+            break;
+
+          default:
+            read_simple(info, arg, p_item);
+            return true;
+        }
+      }
+
+      return false;
+    }
+
+  private:
+    bool read_arg(int p_major,
+                  int p_info,
+                  std::uint64_t & p_arg,
+                  bool & p_indefinite) noexcept
+    {
+      if(p_info < 24)
+      {
+        p_arg = static_cast<std::uint64_t>(p_info);
+        return true;
+      }
+
+      if(p_info <= 27)
+      {
+        return read_be(m_data, m_pos, size_type{1} << (p_info - 24), p_arg);
+      }
+
+      p_indefinite = (31 == p_info) && (((p_major >= 2) && (p_major <= 5)) || (7 == p_major));
+
+      return p_indefinite;
+    }
+
+    bool read_str(std::uint64_t p_size,
+                  Item & p_item) noexcept
+    {
+      if(p_size > remaining())
+      {
+        return false;
+      }
+
+      p_item.str = m_data.substr(m_pos, static_cast<size_type>(p_size));
+      m_pos += static_cast<size_type>(p_size);
+
+      return true;
+    }
+
+    // Definite length chunks of the string's major type, ending with
+    // a break.
+    bool read_chunks(int p_major,
+                     Item & p_item)
+    {
+      m_str.clear();
+
+      while(!at_break())
+      {
+        if(m_pos >= m_data.size())
+        {
+          return false;
+        }
+
+        const auto initial = static_cast<std::uint8_t>(m_data[m_pos++]);
+        std::uint64_t size = 0;
+        bool indefinite = false;
+
+        if((p_major != (initial >> 5))
+           || !read_arg(p_major, initial & 0x1f, size, indefinite)
+           || indefinite
+           || !read_str(size, p_item))
+        {
+          return false;
+        }
+
+        m_str.append(p_item.str);
+      }
+
+      p_item.str = m_str;
+
+      return true;
+    }
+
+    static void read_simple(int p_info,
+                            std::uint64_t p_arg,
+                            Item & p_item) noexcept
+    {
+      switch(p_info)
+      {
+        case 20:
+        case 21:
+          p_item.kind = Item::Kind::Bool;
+          p_item.flag = 21 == p_info;
+          break;
+
+        case 22:
+          p_item.kind = Item::Kind::Null;
+          break;
+
+        case 25:
+          p_item.kind = Item::Kind::Float;
+          p_item.real = half_to_double(static_cast<std::uint16_t>(p_arg));
+          break;
+
+        case 26:
+          p_item.kind = Item::Kind::Float;
+          p_item.real = std::bit_cast<float>(static_cast<std::uint32_t>(p_arg));
+          break;
+
+        case 27:
+          p_item.kind = Item::Kind::Float;
+          p_item.real = std::bit_cast<double>(p_arg);
+          break;
+
+        case 31:
+          p_item.kind = Item::Kind::Break;
+          break;
+
+        default:
+          // Undefined & other simple values.
+          p_item.kind = Item::Kind::Other;
+          break;
+      }
+    }
+
+    std::string_view m_data;
+    std::string & m_str;
+    size_type m_pos = 0;
+};
+
+// MessagePack. Ext types are read as bytes.
+class MsgpackReader final
+{
+  public:
+    explicit MsgpackReader(std::string_view p_data,
+                           std::string & /* p_str */) noexcept:
+      m_data(p_data)
+    {
+    }
+
+    [[nodiscard]]
+    size_type remaining() const noexcept
+    {
+      return m_data.size() - m_pos;
+    }
+
+    // Maps & arrays always have a length.
+    [[nodiscard]]
+    static constexpr bool at_break() noexcept
+    {
+      return false;
+    }
+
+    [[nodiscard]]
+    bool read(Item & p_item) noexcept
+    {
+      if(m_pos >= m_data.size())
+      {
+        return false;
+      }
+
+      const auto type = static_cast<std::uint8_t>(m_data[m_pos++]);
+      std::uint64_t value = 0;
+
+      if(type <= 0x7f)
+      {
+        p_item.kind = Item::Kind::UInt;
+        p_item.uint = type;
+        return true;
+      }
+
+      if(type >= 0xe0)
+      {
+        p_item.kind = Item::Kind::Int;
+        p_item.sint = static_cast<std::int8_t>(type);
+        return true;
+      }
+
+      if(type <= 0x8f)
+      {
+        return container(Item::Kind::Map, type & 0x0f, p_item);
+      }
+
+      if(type <= 0x9f)
+      {
+        return container(Item::Kind::Array, type & 0x0f, p_item);
+      }
+
+      if(type <= 0xbf)
+      {
+        return str(Item::Kind::String, type & 0x1f, 0, p_item);
+      }
+
+      switch(type)
+      {
+        case 0xc0:
+          p_item.kind = Item::Kind::Null;
+          return true;
+
+        case 0xc2:
+        case 0xc3:
+          p_item.kind = Item::Kind::Bool;
+          p_item.flag = 0xc3 == type;
+          return true;
+
+        case 0xc4:
+        case 0xc5:
+        case 0xc6:
+          return read_be(m_data, m_pos, size_type{1} << (type - 0xc4), value)
+            && str(Item::Kind::Bytes, value, 0, p_item);
+
+        case 0xc7:
+        case 0xc8:
+        case 0xc9:
+          // Size, then the ext type.
+          return read_be(m_data, m_pos, size_type{1} << (type - 0xc7), value)
+            && str(Item::Kind::Bytes, value, 1, p_item);
+
+        case 0xca:
+          if(!read_be(m_data, m_pos, 4, value))
+          {
+            return false;
+          }
+          p_item.kind = Item::Kind::Float;
+          p_item.real = std::bit_cast<float>(static_cast<std::uint32_t>(value));
+          return true;
+
+        case 0xcb:
+          if(!read_be(m_data, m_pos, 8, value))
+          {
+            return false;
+          }
+          p_item.kind = Item::Kind::Float;
+          p_item.real = std::bit_cast<double>(value);
+          return true;
+
+        case 0xcc:
+        case 0xcd:
+        case 0xce:
+        case 0xcf:
+          p_item.kind = Item::Kind::UInt;
+          return read_be(m_data, m_pos, size_type{1} << (type - 0xcc), p_item.uint);
+
+        case 0xd0:
+        case 0xd1:
+        case 0xd2:
+        case 0xd3:
+        {
+          const size_type size = size_type{1} << (type - 0xd0);
+          if(!read_be(m_data, m_pos, size, value))
+          {
+            return false;
+          }
+
+          // Sign extend.
+          const auto shift = static_cast<int>(64 - (8 * size));
+          p_item.kind = Item::Kind::Int;
+          p_item.sint = static_cast<std::int64_t>(value << shift) >> shift;
+          return true;
+        }
+
+        case 0xd4:
+        case 0xd5:
+        case 0xd6:
+        case 0xd7:
+        case 0xd8:
+          // Fixed size ext: the ext type, then the data.
+          return str(Item::Kind::Bytes, std::uint64_t{1} << (type - 0xd4), 1, p_item);
+
+        case 0xd9:
+        case 0xda:
+        case 0xdb:
+          return read_be(m_data, m_pos, size_type{1} << (type - 0xd9), value)
+            && str(Item::Kind::String, value, 0, p_item);
+
+        case 0xdc:
+        case 0xdd:
+          return read_be(m_data, m_pos, size_type{2} << (type - 0xdc), value)
+            && container(Item::Kind::Array, value, p_item);
+
+        case 0xde:
+        case 0xdf:
+          return read_be(m_data, m_pos, size_type{2} << (type - 0xde), value)
+            && container(Item::Kind::Map, value, p_item);
+
+        default:
+          // 0xc1 is never used.
+          return false;
+      }
+    }
+
+  private:
+    static bool container(Item::Kind p_kind,
+                          std::uint64_t p_count,
+                          Item & p_item) noexcept
+    {
+      p_item.kind = p_kind;
+      p_item.count = static_cast<size_type>(p_count);
+
+      return true;
+    }
+
+    // Skips p_skip bytes, then reads p_size bytes.
+    bool str(Item::Kind p_kind,
+             std::uint64_t p_size,
+             size_type p_skip,
+             Item & p_item) noexcept
+    {
+      if((p_skip > remaining())
+         || (p_size > (remaining() - p_skip)))
+      {
+        return false;
+      }
+
+      m_pos += p_skip;
+      p_item.kind = p_kind;
+      p_item.str = m_data.substr(m_pos, static_cast<size_type>(p_size));
+      m_pos += static_cast<size_type>(p_size);
+
+      return true;
+    }
+
+    std::string_view m_data;
+    size_type m_pos = 0;
+};
+
+// Walks a document, descending only into the maps & arrays on a
+// configured pointer's path.
+template<typename Reader>
+class Decoder final
+{
+  public:
+    using Node = json_fast::PointerTree::Node;
+    using JsonVisitor = json_handler_detail::JsonVisitor;
+
+    explicit Decoder(Reader & p_reader,
+                     json_fast::PointerTree & p_pointers,
+                     JsonVisitor & p_visitor,
+                     std::vector<prometheus::Capture> & p_captures) noexcept:
+      m_reader(p_reader),
+      m_pointers(p_pointers),
+      m_visitor(p_visitor),
+      m_captures(p_captures)
+    {
+    }
+
+    Decoder() = delete;
+    Decoder(const Decoder &) = delete;
+    Decoder(Decoder &&) = delete;
+
+    Decoder & operator=(const Decoder &) = delete;
+    Decoder & operator=(Decoder &&) = delete;
+
+    [[nodiscard]]
+    Walk walk()
+    {
+      return value(&m_pointers.root(), 0);
+    }
+
+  private:
+    Walk value(Node * p_node,
+               size_type p_depth)
+    {
+      Item item{};
+      if(!m_reader.read(item))
+      {
+        return Walk::Error;
+      }
+
+      const bool is_pointer = (nullptr != p_node) && p_node->is_pointer;
+
+      switch(item.kind)
+      {
+        case Item::Kind::Map:
+          if((nullptr == p_node) || p_node->children.empty())
+          {
+            return skip(item, p_depth);
+          }
+          return map(*p_node, item.count, p_depth);
+
+        case Item::Kind::Array:
+          if((nullptr == p_node) || p_node->children.empty())
+          {
+            return skip(item, p_depth);
+          }
+          return array(*p_node, item.count, p_depth);
+
+        case Item::Kind::String:
+          if(!is_pointer)
+          {
+            return Walk::Continue;
+          }
+          m_visitor.apply_str(p_node->metrics, item.str);
+          return found();
+
+        case Item::Kind::Int:
+          if(!is_pointer)
+          {
+            return Walk::Continue;
+          }
+          m_visitor.apply_int64(p_node->metrics, item.sint);
+          return found();
+
+        case Item::Kind::UInt:
+          if(!is_pointer)
+          {
+            return Walk::Continue;
+          }
+          m_visitor.apply_uint64(p_node->metrics, item.uint);
+          return found();
+
+        case Item::Kind::Float:
+          if(!is_pointer)
+          {
+            return Walk::Continue;
+          }
+          m_visitor.apply_double(p_node->metrics, item.real);
+          return found();
+
+        case Item::Kind::Bool:
+          if(!is_pointer)
+          {
+            return Walk::Continue;
+          }
+          m_visitor.apply_bool(p_node->metrics, item.flag);
+          return found();
+
+        case Item::Kind::Null:
+          // Found, but has no value.
+          return is_pointer ? found() : Walk::Continue;
+
+        case Item::Kind::Break:
+          return Walk::Error;
+
+        default:
+          // Byte strings & other simple values aren't values.
+          return Walk::Continue;
+      }
+    }
+
+    Walk map(Node & p_node,
+             size_type p_count,
+             size_type p_depth)
+    {
+      if(!valid_count(p_count, p_depth))
+      {
+        return Walk::Error;
+      }
+
+      for(size_type idx = 0; more(p_count, idx); ++idx)
+      {
+        Item key{};
+        if(!m_reader.read(key))
+        {
+          return Walk::Error;
+        }
+
+        std::string_view key_str{};
+        bool has_key = true;
+
+        switch(key.kind)
+        {
+          case Item::Kind::String:
+            key_str = key.str;
+            break;
+
+          case Item::Kind::Int:
+            key_str = format(m_key, key.sint);
+            break;
+
+          case Item::Kind::UInt:
+            key_str = format(m_key, key.uint);
+            break;
+
+          case Item::Kind::Map:
+          case Item::Kind::Array:
+            if(auto walk = skip(key, p_depth + 1);
+               Walk::Continue != walk)
+            {
+              return walk;
+            }
+            has_key = false;
+            break;
+
+          case Item::Kind::Break:
+            return Walk::Error;
+
+          default:
+            has_key = false;
+            break;
+        }
+
+        Node * node = has_key ? m_pointers.find_key(p_node, key_str) : nullptr;
+        if(auto walk = child(node, key_str, p_depth + 1);
+           Walk::Continue != walk)
+        {
+          return walk;
+        }
+      }
+
+      return Walk::Continue;
+    }
+
+    Walk array(Node & p_node,
+               size_type p_count,
+               size_type p_depth)
+    {
+      if(!valid_count(p_count, p_depth))
+      {
+        return Walk::Error;
+      }
+
+      for(size_type idx = 0; more(p_count, idx); ++idx)
+      {
+        Node * node = m_pointers.find_index(p_node, idx);
+        std::string_view capture{};
+
+        if((nullptr != node) && node->wildcard)
+        {
+          capture = format(m_key, idx);
+        }
+
+        if(auto walk = child(node, capture, p_depth + 1);
+           Walk::Continue != walk)
+        {
+          return walk;
+        }
+      }
+
+      return Walk::Continue;
+    }
+
+    // Walks a member's value, capturing its key or index for a wildcard.
+    Walk child(Node * p_node,
+               std::string_view p_capture,
+               size_type p_depth)
+    {
+      if((nullptr == p_node) || !p_node->wildcard)
+      {
+        return value(p_node, p_depth);
+      }
+
+      auto & capture = m_captures[m_capture_count];
+      capture.name.assign(p_node->label);
+      capture.value.assign(p_capture);
+
+      ++m_capture_count;
+      m_visitor.captures(prometheus::Captures{m_captures.data(), m_capture_count});
+
+      const auto walk = value(p_node, p_depth);
+
+      --m_capture_count;
+      m_visitor.captures(prometheus::Captures{m_captures.data(), m_capture_count});
+
+      return walk;
+    }
+
+    // Skips the members of the map or array p_item.
+    Walk skip(const Item & p_item,
+              size_type p_depth)
+    {
+      if(!valid_count(p_item.count, p_depth))
+      {
+        return Walk::Error;
+      }
+
+      // A map's members are key & value pairs.
+      const size_type count = ((Item::indefinite != p_item.count) && (Item::Kind::Map == p_item.kind))
+        ? p_item.count * 2
+        : p_item.count;
+
+      for(size_type idx = 0; more(count, idx); ++idx)
+      {
+        Item item{};
+        if(!m_reader.read(item)
+           || (Item::Kind::Break == item.kind))
+        {
+          return Walk::Error;
+        }
+
+        if((Item::Kind::Map == item.kind) || (Item::Kind::Array == item.kind))
+        {
+          if(auto walk = skip(item, p_depth + 1);
+             Walk::Continue != walk)
+          {
+            return walk;
+          }
+        }
+      }
+
+      return Walk::Continue;
+    }
+
+    // Every member takes at least a byte, so larger counts are
+    // malformed.
+    bool valid_count(size_type p_count,
+                     size_type p_depth) const noexcept
+    {
+      return (p_depth < MqttBinaryHandler::max_depth)
+        && ((Item::indefinite == p_count) || (p_count <= m_reader.remaining()));
+    }
+
+    bool more(size_type p_count,
+              size_type p_idx)
+    {
+      if(Item::indefinite == p_count)
+      {
+        return !m_reader.at_break();
+      }
+
+      return p_idx < p_count;
+    }
+
+    template<typename T>
+    static std::string_view format(std::array<char, 32> & p_buffer,
+                                   T p_value) noexcept
+    {
+      auto [ptr, ec] = std::to_chars(p_buffer.data(), p_buffer.data() + p_buffer.size(), p_value);
+
+      return std::string_view{p_buffer.data(), static_cast<size_type>(ptr - p_buffer.data())};
+    }
+
+    Walk found() noexcept
+    {
+      // Wildcards match any number of values.
+      if(m_pointers.has_wildcards())
+      {
+        return Walk::Continue;
+      }
+
+      return ++m_found == m_pointers.pointer_count() ? Walk::Done : Walk::Continue;
+    }
+
+    Reader & m_reader;
+    json_fast::PointerTree & m_pointers;
+    JsonVisitor & m_visitor;
+    std::vector<prometheus::Capture> & m_captures;
+    std::array<char, 32> m_key{};
+    size_type m_capture_count = 0;
+    size_type m_found = 0;
+};
+
+template<typename Reader>
+bool decode(std::string_view p_data,
+            std::string & p_str,
+            json_fast::PointerTree & p_pointers,
+            json_handler_detail::JsonVisitor & p_visitor,
+            std::vector<prometheus::Capture> & p_captures)
+{
+  Reader reader{p_data, p_str};
+  Decoder<Reader> decoder{reader, p_pointers, p_visitor, p_captures};
+
+  return Walk::Error != decoder.walk();
+}
+
+} // anonymous namespace
+} // namespace binary
+
+MqttBinaryHandler::MqttBinaryHandler(std::string_view p_handler_id,
+                                     Format p_format,
+                                     builder_type && p_pointers,
+                                     size_type p_metric_count) noexcept:
+  MqttHandler(p_handler_id, Format::Msgpack == p_format ? type::Msgpack : type::Cbor, p_metric_count),
+  m_format(p_format),
+  m_pointers(std::move(p_pointers)),
+  m_captures(m_pointers.max_captures())
+{
+}
+
+void MqttBinaryHandler::Event(std::string_view p_mqtt_data,
+                              const std::string_view p_topic,
+                              const TopicMatch & p_match,
+                              const timestamp_type p_timestamp,
+                              yy_prometheus::MetricDataVectorPtr p_metric_data) noexcept
+{
+  spdlog::debug("  handler [{}]"sv, Id());
+
+  m_visitor.reset();
+  m_visitor.match(&p_match);
+  m_visitor.metric_data(p_metric_data);
+  m_visitor.timestamp(p_timestamp);
+  m_visitor.topic(p_topic);
+
+  const bool valid = Format::Msgpack == m_format
+    ? binary::decode<binary::MsgpackReader>(p_mqtt_data, m_str, m_pointers, m_visitor, m_captures)
+    : binary::decode<binary::CborReader>(p_mqtt_data, m_str, m_pointers, m_visitor, m_captures);
+
+  if(!valid)
+  {
+    spdlog::debug("  handler [{}] invalid {} topic [{}]"sv,
+                  Id(),
+                  Format::Msgpack == m_format ? "msgpack"sv : "cbor"sv,
+                  p_topic);
+  }
+}
+
+} // namespace yafiyogi::mqtt_bridge
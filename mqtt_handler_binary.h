@@ -0,0 +1,95 @@
+/*
+
+  MIT License
+
+  Copyright (c) 2025 Yafiyogi
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "yy_cpp/yy_types.hpp"
+#include "yy_mqtt/yy_mqtt_types.h"
+
+#include "yy_prometheus/yy_prometheus_metric_data.h"
+
+#include "mqtt_handler.h"
+#include "mqtt_handler_json.h"
+#include "mqtt_handler_json_fast.h"
+#include "prometheus_metric.h"
+#include "value_type.h"
+
+namespace yafiyogi::mqtt_bridge {
+namespace binary {
+
+enum class Format:uint8_t {Cbor, Msgpack};
+
+} // namespace binary
+
+// Extracts the configured JSON pointers from CBOR or MessagePack
+// payloads. The payload is decoded in place: only maps & arrays on a
+// configured pointer's path are visited, strings are passed to the
+// metrics as views into the payload, and numbers are passed as a typed
+// NumericValue. Decoding stops once every pointer is found. Integer
+// map keys match pointer tokens written as numbers.
+class MqttBinaryHandler final:
+      public MqttHandler
+{
+  public:
+    using builder_type = json_fast::PointerTree;
+    using Format = binary::Format;
+
+    // Containers nested deeper than this are malformed.
+    static constexpr size_type max_depth = 128;
+
+    explicit MqttBinaryHandler(std::string_view p_handler_id,
+                               Format p_format,
+                               builder_type && p_pointers,
+                               size_type p_metric_count) noexcept;
+
+    MqttBinaryHandler() = delete;
+    MqttBinaryHandler(const MqttBinaryHandler &) = delete;
+    MqttBinaryHandler(MqttBinaryHandler &&) noexcept = default;
+
+    MqttBinaryHandler & operator=(const MqttBinaryHandler &) = delete;
+    MqttBinaryHandler & operator=(MqttBinaryHandler &&) noexcept = default;
+
+    void Event(std::string_view p_mqtt_data,
+               const std::string_view p_topic,
+               const TopicMatch & p_match,
+               const timestamp_type p_timestamp,
+               yy_prometheus::MetricDataVectorPtr p_metric_data) noexcept override;
+
+  private:
+    Format m_format = Format::Cbor;
+    builder_type m_pointers;
+    json_handler_detail::JsonVisitor m_visitor{};
+    std::vector<prometheus::Capture> m_captures;
+    // Chunked CBOR strings are joined here.
+    std::string m_str{};
+};
+
+} // namespace yafiyogi::mqtt_bridge
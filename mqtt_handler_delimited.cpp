@@ -0,0 +1,477 @@
+/*
+
+  MIT License
+
+  Copyright (c) 2025 Yafiyogi
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "fmt/compile.h"
+#include "fmt/format.h"
+#include "spdlog/spdlog.h"
+
+#include "yy_prometheus/yy_prometheus_metric_data.h"
+
+#include "json_fast_scan.h"
+#include "prometheus_metric.h"
+
+#include "mqtt_handler_delimited.h"
+
+namespace yafiyogi::mqtt_bridge {
+
+using namespace std::string_view_literals;
+using namespace fmt::literals;
+
+namespace delimited {
+namespace {
+
+constexpr size_type npos = DelimiterScanner::npos;
+
+std::string_view trim_cr(std::string_view p_value) noexcept
+{
+  if(p_value.ends_with('\r'))
+  {
+    p_value.remove_suffix(1);
+  }
+
+  return p_value;
+}
+
+std::string delimiters(Format p_format,
+                       char p_separator)
+{
+  if(Format::Logfmt == p_format)
+  {
+    return std::string{" =\"\n"};
+  }
+
+  return std::string{p_separator, '"', '\n'};
+}
+
+} // anonymous namespace
+
+std::tuple<Fields::Metrics *, bool> Fields::add_field(std::string_view p_name,
+                                                      Metrics && p_metrics)
+{
+  if(const auto pos = find(p_name);
+     no_field != pos)
+  {
+    return {&m_fields[pos].metrics, false};
+  }
+
+  const size_type pos = m_fields.size();
+  m_fields.emplace_back(Field{std::string{p_name}, std::move(p_metrics), false});
+
+  return {&m_fields[pos].metrics, true};
+}
+
+void Fields::add_label(std::string_view p_name)
+{
+  std::ignore = add_field(p_name, Metrics{});
+
+  m_fields[find(p_name)].label = true;
+}
+
+size_type Fields::find(std::string_view p_name) const noexcept
+{
+  for(size_type pos = 0; pos < m_fields.size(); ++pos)
+  {
+    if(m_fields[pos].name == p_name)
+    {
+      return pos;
+    }
+  }
+
+  return no_field;
+}
+
+} // namespace delimited
+
+MqttDelimitedHandler::MqttDelimitedHandler(std::string_view p_handler_id,
+                                           Format p_format,
+                                           char p_separator,
+                                           const std::vector<std::string> & p_columns,
+                                           builder_type && p_fields,
+                                           size_type p_metric_count) noexcept:
+  MqttHandler(p_handler_id, Format::Logfmt == p_format ? type::Logfmt : type::Csv, p_metric_count),
+  m_format(p_format),
+  m_separator(p_separator),
+  m_header(p_columns.empty()),
+  m_fields(std::move(p_fields)),
+  m_scanner(delimited::delimiters(p_format, p_separator)),
+  m_buffers(m_fields.size())
+{
+  m_values.reserve(m_fields.size());
+  for(size_type idx = 0; idx < m_fields.size(); ++idx)
+  {
+    m_values.emplace_back();
+  }
+
+  size_type labels = 0;
+  for(const auto & field : m_fields)
+  {
+    if(field.label)
+    {
+      ++labels;
+    }
+  }
+  m_captures.resize(labels);
+
+  for(size_type column = 0; column < p_columns.size(); ++column)
+  {
+    SetColumn(column, p_columns[column]);
+  }
+
+  m_rows = stats::add_stat("mqtt_bridge_delimited_rows_total"sv,
+                           "CSV rows & logfmt records with configured fields."sv,
+                           stats::StatType::Counter,
+                           fmt::format("handler=\"{}\""_cf, Id()));
+}
+
+void MqttDelimitedHandler::SetColumn(size_type p_column,
+                                     std::string_view p_name)
+{
+  if(p_column == m_columns.size())
+  {
+    m_columns.emplace_back(m_fields.find(p_name));
+  }
+}
+
+void MqttDelimitedHandler::SetValue(size_type p_field,
+                                    std::string_view p_value,
+                                    bool p_escaped) noexcept
+{
+  if(p_value.empty())
+  {
+    return;
+  }
+
+  if(p_escaped)
+  {
+    auto & buffer = m_buffers[p_field];
+    buffer.clear();
+
+    if(delimited::Format::Logfmt == m_format)
+    {
+      if(!json_fast::unescape(p_value, buffer))
+      {
+        buffer.assign(p_value);
+      }
+    }
+    else
+    {
+      // A CSV quote is escaped by doubling it.
+      for(size_type pos = 0; pos < p_value.size(); ++pos)
+      {
+        buffer.push_back(p_value[pos]);
+        if(('"' == p_value[pos]) && ((pos + 1) < p_value.size()) && ('"' == p_value[pos + 1]))
+        {
+          ++pos;
+        }
+      }
+    }
+
+    p_value = buffer;
+  }
+
+  m_values[p_field] = Value{p_value, true};
+}
+
+void MqttDelimitedHandler::EmitRow(const Row & p_row) noexcept
+{
+  size_type capture_count = 0;
+  bool found = false;
+
+  for(size_type pos = 0; pos < m_fields.size(); ++pos)
+  {
+    if(const auto & [value, value_found] = m_values[pos];
+       value_found)
+    {
+      const auto & field = m_fields[pos];
+      if(field.label)
+      {
+        auto & capture = m_captures[capture_count++];
+        capture.name.assign(field.name);
+        capture.value.assign(value);
+      }
+
+      found = found || !field.metrics.empty();
+    }
+  }
+
+  if(found)
+  {
+    const prometheus::Captures captures{m_captures.data(), capture_count};
+
+    for(size_type pos = 0; pos < m_fields.size(); ++pos)
+    {
+      if(const auto & [value, value_found] = m_values[pos];
+         value_found)
+      {
+        for(auto & metric : m_fields[pos].metrics)
+        {
+          metric->Event(value,
+                        p_row.topic,
+                        *p_row.match,
+                        p_row.timestamp,
+                        yy_values::ValueType::Unknown,
+                        p_row.metric_data,
+                        captures);
+        }
+      }
+    }
+
+    m_rows->Add(1);
+  }
+
+  for(auto & value : m_values)
+  {
+    value.found = false;
+  }
+}
+
+void MqttDelimitedHandler::ParseCsv(std::string_view p_data,
+                                    const Row & p_row) noexcept
+{
+  constexpr size_type npos = delimited::npos;
+
+  bool in_header = m_header;
+  bool in_quotes = false;
+  bool escaped = false;
+  size_type column = 0;
+  size_type field_start = 0;
+  // Closing quote of a quoted field.
+  size_type quote_end = npos;
+
+  if(in_header)
+  {
+    m_columns.clear(yy_data::ClearAction::Keep);
+  }
+
+  auto is_empty_line = [&](size_type p_end) {
+    return (0 == column)
+      && (npos == quote_end)
+      && delimited::trim_cr(p_data.substr(field_start, p_end - field_start)).empty();
+  };
+
+  auto end_field = [&](size_type p_end) {
+    std::string_view value{};
+    if(npos != quote_end)
+    {
+      value = p_data.substr(field_start + 1, quote_end - field_start - 1);
+    }
+    else
+    {
+      value = delimited::trim_cr(p_data.substr(field_start, p_end - field_start));
+    }
+
+    if(in_header)
+    {
+      SetColumn(column, value);
+    }
+    else if(column < m_columns.size())
+    {
+      if(const auto field = m_columns[column];
+         builder_type::no_field != field)
+      {
+        SetValue(field, value, escaped);
+      }
+    }
+
+    ++column;
+    quote_end = npos;
+    escaped = false;
+  };
+
+  auto end_row = [&]() {
+    if(in_header)
+    {
+      in_header = false;
+    }
+    else
+    {
+      EmitRow(p_row);
+    }
+
+    column = 0;
+  };
+
+  m_scanner.reset(p_data);
+  for(size_type pos = m_scanner.next(); npos != pos; pos = m_scanner.next())
+  {
+    const char ch = p_data[pos];
+
+    if(in_quotes)
+    {
+      if('"' == ch)
+      {
+        if(((pos + 1) < p_data.size()) && ('"' == p_data[pos + 1]))
+        {
+          // Skip the doubled quote.
+          escaped = true;
+          std::ignore = m_scanner.next();
+        }
+        else
+        {
+          in_quotes = false;
+          quote_end = pos;
+        }
+      }
+    }
+    else if('"' == ch)
+    {
+      in_quotes = (pos == field_start);
+    }
+    else if(m_separator == ch)
+    {
+      end_field(pos);
+      field_start = pos + 1;
+    }
+    else
+    {
+      if(!is_empty_line(pos))
+      {
+        end_field(pos);
+        end_row();
+      }
+      field_start = pos + 1;
+    }
+  }
+
+  // Last row without a trailing new line.
+  if(!is_empty_line(p_data.size()))
+  {
+    end_field(p_data.size());
+    end_row();
+  }
+}
+
+void MqttDelimitedHandler::ParseLogfmt(std::string_view p_data,
+                                       const Row & p_row) noexcept
+{
+  constexpr size_type npos = delimited::npos;
+
+  bool in_quotes = false;
+  size_type token_start = 0;
+  size_type value_start = npos;
+  // Closing quote of a quoted value.
+  size_type quote_end = npos;
+
+  auto end_token = [&](size_type p_end) {
+    if(npos != value_start)
+    {
+      const auto key = p_data.substr(token_start, value_start - 1 - token_start);
+
+      if(const auto field = m_fields.find(key);
+         builder_type::no_field != field)
+      {
+        if(npos != quote_end)
+        {
+          const auto value = p_data.substr(value_start + 1, quote_end - value_start - 1);
+          SetValue(field, value, std::string_view::npos != value.find('\\'));
+        }
+        else
+        {
+          SetValue(field, delimited::trim_cr(p_data.substr(value_start, p_end - value_start)), false);
+        }
+      }
+    }
+
+    value_start = npos;
+    quote_end = npos;
+  };
+
+  m_scanner.reset(p_data);
+  for(size_type pos = m_scanner.next(); npos != pos; pos = m_scanner.next())
+  {
+    const char ch = p_data[pos];
+
+    if(in_quotes)
+    {
+      if('"' == ch)
+      {
+        // A quote preceded by an odd number of backslashes is escaped.
+        size_type backslashes = 0;
+        while('\\' == p_data[pos - backslashes - 1])
+        {
+          ++backslashes;
+        }
+
+        if(0 == (backslashes % 2))
+        {
+          in_quotes = false;
+          quote_end = pos;
+        }
+      }
+    }
+    else if('=' == ch)
+    {
+      if(npos == value_start)
+      {
+        value_start = pos + 1;
+      }
+    }
+    else if('"' == ch)
+    {
+      in_quotes = (pos == value_start);
+    }
+    else
+    {
+      end_token(pos);
+      token_start = pos + 1;
+
+      if('\n' == ch)
+      {
+        EmitRow(p_row);
+      }
+    }
+  }
+
+  // Last record without a trailing new line.
+  end_token(p_data.size());
+  EmitRow(p_row);
+}
+
+void MqttDelimitedHandler::Event(std::string_view p_mqtt_data,
+                                 const std::string_view p_topic,
+                                 const TopicMatch & p_match,
+                                 const timestamp_type p_timestamp,
+                                 yy_prometheus::MetricDataVectorPtr p_metric_data) noexcept
+{
+  spdlog::debug("  handler [{}]"sv, Id());
+
+  const Row row{p_topic, &p_match, p_timestamp, p_metric_data};
+
+  if(delimited::Format::Logfmt == m_format)
+  {
+    ParseLogfmt(p_mqtt_data, row);
+  }
+  else
+  {
+    ParseCsv(p_mqtt_data, row);
+  }
+}
+
+} // namespace yafiyogi::mqtt_bridge
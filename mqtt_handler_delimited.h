@@ -0,0 +1,191 @@
+/*
+
+  MIT License
+
+  Copyright (c) 2025 Yafiyogi
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+#include "yy_cpp/yy_types.hpp"
+#include "yy_cpp/yy_vector.h"
+#include "yy_mqtt/yy_mqtt_types.h"
+
+#include "yy_prometheus/yy_prometheus_metric_data.h"
+
+#include "bridge_stats.h"
+#include "delimited_scan.h"
+#include "mqtt_handler.h"
+#include "prometheus_metric.h"
+#include "value_type.h"
+
+namespace yafiyogi::mqtt_bridge {
+namespace delimited {
+
+enum class Format:uint8_t {Csv, Logfmt};
+
+// The configured CSV columns or logfmt keys. A field holds metrics for
+// its values, and/or is a label for the other fields' values in the
+// same row.
+class Fields final
+{
+  public:
+    using Metrics = prometheus::Metrics;
+    static constexpr size_type no_field = std::numeric_limits<size_type>::max();
+
+    struct Field final
+    {
+        std::string name{};
+        Metrics metrics{};
+        bool label = false;
+    };
+
+    using container_type = yy_quad::simple_vector<Field>;
+    using const_iterator = container_type::const_iterator;
+
+    // Returns the field's metrics, and whether the field was added.
+    std::tuple<Metrics *, bool> add_field(std::string_view p_name,
+                                          Metrics && p_metrics);
+
+    void add_label(std::string_view p_name);
+
+    [[nodiscard]]
+    size_type find(std::string_view p_name) const noexcept;
+
+    [[nodiscard]]
+    size_type size() const noexcept
+    {
+      return m_fields.size();
+    }
+
+    [[nodiscard]]
+    Field & operator[](size_type p_pos) noexcept
+    {
+      return m_fields[p_pos];
+    }
+
+    [[nodiscard]]
+    const_iterator begin() const noexcept
+    {
+      return m_fields.begin();
+    }
+
+    [[nodiscard]]
+    const_iterator end() const noexcept
+    {
+      return m_fields.end();
+    }
+
+  private:
+    container_type m_fields{};
+};
+
+} // namespace delimited
+
+// Extracts fields from CSV rows or logfmt records, emitting the
+// configured fields' metrics for each row. Delimiters are found with
+// the SIMD delimiter scanner in one pass over the payload; values are
+// views into the payload, only quoted values with escapes are copied,
+// into buffers re-used between rows.
+class MqttDelimitedHandler final:
+      public MqttHandler
+{
+  public:
+    using builder_type = delimited::Fields;
+    using Format = delimited::Format;
+
+    static constexpr char default_separator = ',';
+
+    // Without p_columns, the first line of a CSV payload names its
+    // columns.
+    explicit MqttDelimitedHandler(std::string_view p_handler_id,
+                                  Format p_format,
+                                  char p_separator,
+                                  const std::vector<std::string> & p_columns,
+                                  builder_type && p_fields,
+                                  size_type p_metric_count) noexcept;
+
+    MqttDelimitedHandler() = delete;
+    MqttDelimitedHandler(const MqttDelimitedHandler &) = delete;
+    MqttDelimitedHandler(MqttDelimitedHandler &&) noexcept = default;
+
+    MqttDelimitedHandler & operator=(const MqttDelimitedHandler &) = delete;
+    MqttDelimitedHandler & operator=(MqttDelimitedHandler &&) noexcept = default;
+
+    void Event(std::string_view p_mqtt_data,
+               const std::string_view p_topic,
+               const TopicMatch & p_match,
+               const timestamp_type p_timestamp,
+               yy_prometheus::MetricDataVectorPtr p_metric_data) noexcept override;
+
+  private:
+    struct Value final
+    {
+        std::string_view value{};
+        bool found = false;
+    };
+
+    struct Row final
+    {
+        std::string_view topic{};
+        const TopicMatch * match = nullptr;
+        timestamp_type timestamp{};
+        yy_prometheus::MetricDataVectorPtr metric_data{};
+    };
+
+    void ParseCsv(std::string_view p_data,
+                  const Row & p_row) noexcept;
+    void ParseLogfmt(std::string_view p_data,
+                     const Row & p_row) noexcept;
+
+    // Sets a field's value, un-quoting it into the field's buffer if it
+    // has escapes.
+    void SetValue(size_type p_field,
+                  std::string_view p_value,
+                  bool p_escaped) noexcept;
+
+    void SetColumn(size_type p_column,
+                   std::string_view p_name);
+
+    void EmitRow(const Row & p_row) noexcept;
+
+    Format m_format = Format::Csv;
+    char m_separator = default_separator;
+    bool m_header = true;
+    builder_type m_fields;
+    delimited::DelimiterScanner m_scanner;
+    // Column number to field, or no_field.
+    yy_quad::simple_vector<size_type> m_columns{};
+    yy_quad::simple_vector<Value> m_values{};
+    std::vector<std::string> m_buffers{};
+    std::vector<prometheus::Capture> m_captures{};
+    stats::StatPtr m_rows{};
+};
+
+} // namespace yafiyogi::mqtt_bridge
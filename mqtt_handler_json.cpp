@@ -24,9 +24,16 @@
 
 */
 
+#include <charconv>
+#include <cstdint>
 #include <memory>
+#include <string>
 #include <string_view>
+#include <system_error>
+#include <tuple>
 
+#include "fmt/compile.h"
+#include "fmt/format.h"
 #include "spdlog/spdlog.h"
 
 #include "yy_cpp/yy_assert.h"
@@ -38,16 +45,52 @@
 namespace yafiyogi::mqtt_bridge {
 
 using namespace std::string_view_literals;
+using namespace fmt::literals;
 
 namespace json_handler_detail {
+namespace {
 
-const yy_mqtt::TopicLevelsView JsonVisitor::g_empty_levels{};
+prometheus::Metrics share_metrics(const prometheus::Metrics & p_metrics)
+{
+  prometheus::Metrics metrics{};
+  metrics.reserve(p_metrics.size());
+
+  for(const auto & metric : p_metrics)
+  {
+    metrics.emplace_back(metric);
+  }
+
+  return metrics;
+}
+
+MqttJsonHandler::handler_config_type create_handler_config(const MqttJsonHandler::parser_options_type & p_json_options,
+                                                           const JsonPointers & p_json_pointers)
+{
+  MqttJsonHandler::automaton_builder_type builder{};
+
+  for(const auto & [pointer, metrics] : p_json_pointers)
+  {
+    std::ignore = builder.add_pointer(pointer, share_metrics(metrics));
+  }
+
+  return builder.create(p_json_options.max_depth);
+}
+
+const yy_mqtt::TopicLevelsView g_empty_levels{};
+const TopicFilter g_empty_filter{};
+
+} // anonymous namespace
+
+const TopicMatch JsonVisitor::g_empty_match{g_empty_levels, g_empty_filter};
 
 JsonVisitor::JsonVisitor(JsonVisitor && p_other) noexcept:
-  m_levels(std::move(p_other.m_levels)),
+  m_match(std::move(p_other.m_match)),
   m_metric_data(std::move(p_other.m_metric_data)),
   m_timestamp(p_other.m_timestamp),
-  m_topic(p_other.m_topic)
+  m_topic(p_other.m_topic),
+  m_captures(p_other.m_captures),
+  m_pointers(p_other.m_pointers),
+  m_found(p_other.m_found)
 {
   p_other.reset();
 }
@@ -56,10 +99,13 @@ JsonVisitor & JsonVisitor::operator=(JsonVisitor && p_other) noexcept
 {
   if(this != &p_other)
   {
-    m_levels = p_other.m_levels;
+    m_match = p_other.m_match;
     m_metric_data = std::move(p_other.m_metric_data);
     m_timestamp = p_other.m_timestamp;
     m_topic = p_other.m_topic;
+    m_captures = p_other.m_captures;
+    m_pointers = p_other.m_pointers;
+    m_found = p_other.m_found;
 
     p_other.reset();
   }
@@ -67,13 +113,13 @@ JsonVisitor & JsonVisitor::operator=(JsonVisitor && p_other) noexcept
   return *this;
 }
 
-void JsonVisitor::levels(const yy_mqtt::TopicLevelsView * p_levels) noexcept
+void JsonVisitor::match(const TopicMatch * p_match) noexcept
 {
-  if(nullptr == p_levels)
+  if(nullptr == p_match)
   {
-    p_levels = &g_empty_levels;
+    p_match = &g_empty_match;
   }
-  m_levels = p_levels;
+  m_match = p_match;
 }
 
 void JsonVisitor::metric_data(yy_prometheus::MetricDataVectorPtr p_metric_data) noexcept
@@ -91,12 +137,85 @@ void JsonVisitor::timestamp(const timestamp_type p_timestamp) noexcept
   m_timestamp = p_timestamp;
 }
 
+void JsonVisitor::pointers(size_type p_pointers) noexcept
+{
+  m_pointers = p_pointers;
+}
+
+void JsonVisitor::captures(prometheus::Captures p_captures) noexcept
+{
+  m_captures = p_captures;
+}
+
 void JsonVisitor::reset() noexcept
 {
-  m_levels = &g_empty_levels;
+  m_match = &g_empty_match;
   m_metric_data.release();
   m_timestamp = timestamp_type{};
   m_topic = std::string_view{};
+  m_captures = prometheus::Captures{};
+  m_found = 0;
+}
+
+bool JsonVisitor::apply_scalar(Metrics & p_metrics,
+                               std::string_view p_raw)
+{
+  const char * begin = p_raw.data();
+  const char * end = p_raw.data() + p_raw.size();
+
+  if(p_raw.empty())
+  {
+    return false;
+  }
+
+  if(g_true_str == p_raw)
+  {
+    apply_bool(p_metrics, true);
+  }
+  else if(g_false_str == p_raw)
+  {
+    apply_bool(p_metrics, false);
+  }
+  else if("null"sv == p_raw)
+  {
+    // No value.
+  }
+  else if(('-' != p_raw[0]) && ((p_raw[0] < '0') || (p_raw[0] > '9')))
+  {
+    return false;
+  }
+  else if(std::string_view::npos != p_raw.find_first_of(".eE"sv))
+  {
+    double num = 0;
+    if(auto [ptr, ec] = std::from_chars(begin, end, num);
+       (std::errc{} != ec) || (ptr != end))
+    {
+      return false;
+    }
+    apply_double(p_metrics, num);
+  }
+  else if('-' == p_raw[0])
+  {
+    std::int64_t num = 0;
+    if(auto [ptr, ec] = std::from_chars(begin, end, num);
+       (std::errc{} != ec) || (ptr != end))
+    {
+      return false;
+    }
+    apply_int64(p_metrics, num);
+  }
+  else
+  {
+    std::uint64_t num = 0;
+    if(auto [ptr, ec] = std::from_chars(begin, end, num);
+       (std::errc{} != ec) || (ptr != end))
+    {
+      return false;
+    }
+    apply_uint64(p_metrics, num);
+  }
+
+  return true;
 }
 
 void JsonVisitor::apply(Metrics & p_metrics,
@@ -107,27 +226,136 @@ void JsonVisitor::apply(Metrics & p_metrics,
   {
     metric->Event(p_value,
                   m_topic,
-                  *m_levels,
+                  *m_match,
                   m_timestamp,
                   p_value_type,
-                  m_metric_data);
+                  m_metric_data,
+                  m_captures);
   }
+
+  ++m_found;
 }
 
+void JsonVisitor::apply(Metrics & p_metrics,
+                        const NumericValue & p_value)
+{
+  for(auto & metric : p_metrics)
+  {
+    metric->Event(p_value,
+                  m_topic,
+                  *m_match,
+                  m_timestamp,
+                  m_metric_data,
+                  m_captures);
+  }
+
+  ++m_found;
 }
 
+std::tuple<JsonPointers::Metrics *, bool> JsonPointers::add_pointer(std::string_view p_pointer,
+                                                                  Metrics && p_metrics)
+{
+  for(auto & [pointer, metrics] : m_pointers)
+  {
+    if(pointer == p_pointer)
+    {
+      return {&metrics, false};
+    }
+  }
+
+  const size_type pos = m_pointers.size();
+  m_pointers.emplace_back(Pointer{std::string{p_pointer}, std::move(p_metrics)});
+
+  return {&m_pointers[pos].metrics, true};
+}
+
+void JsonPointers::merge(const JsonPointers & p_other)
+{
+  for(const auto & [pointer, metrics] : p_other)
+  {
+    auto [merged_metrics, added] = add_pointer(pointer, Metrics{});
+
+    merged_metrics->reserve(merged_metrics->size() + metrics.size());
+    for(const auto & metric : metrics)
+    {
+      merged_metrics->emplace_back(metric);
+    }
+  }
+}
+
+} // namespace json_handler_detail
+
 MqttJsonHandler::MqttJsonHandler(std::string_view p_handler_id,
                                  const parser_options_type & p_json_options,
-                                 handler_config_type && p_json_handler_config,
+                                 builder_type && p_json_pointers,
                                  size_type p_metric_count) noexcept:
   MqttHandler(p_handler_id, type::Json, p_metric_count),
-  m_parser(p_json_options, std::move(p_json_handler_config))
+  m_pointers(std::move(p_json_pointers)),
+  m_parser(p_json_options, json_handler_detail::create_handler_config(p_json_options, m_pointers))
+{
+  m_parser.handler().visitor().pointers(m_pointers.size());
+
+  m_skipped_bytes = stats::add_stat("mqtt_bridge_json_skipped_bytes_total"sv,
+                                    "Payload bytes not parsed as every json pointer was found."sv,
+                                    stats::StatType::Counter,
+                                    fmt::format("handler=\"{}\""_cf, Id()));
+}
+
+bool MqttJsonHandler::LearnShapes(size_type p_shape_cache_size)
 {
+  std::vector<std::string> keys{};
+  keys.reserve(m_pointers.size());
+
+  for(const auto & [pointer, metrics] : m_pointers)
+  {
+    if(!pointer.starts_with('/')
+       || (std::string_view::npos != pointer.find('/', 1)))
+    {
+      return false;
+    }
+
+    // Decode '~1' & '~0'.
+    std::string key{};
+    for(size_type idx = 1; idx < pointer.size(); ++idx)
+    {
+      if(('~' == pointer[idx]) && ((idx + 1) < pointer.size()))
+      {
+        key.push_back('1' == pointer[++idx] ? '/' : '~');
+      }
+      else
+      {
+        key.push_back(pointer[idx]);
+      }
+    }
+    keys.emplace_back(std::move(key));
+  }
+
+  m_shape_keys = std::move(keys);
+  m_shape_metrics.clear();
+  m_shape_metrics.reserve(m_pointers.size());
+  for(const auto & [pointer, metrics] : m_pointers)
+  {
+    m_shape_metrics.emplace_back(json_handler_detail::share_metrics(metrics));
+  }
+
+  m_shapes = std::make_unique<ShapeCache>(p_shape_cache_size);
+
+  const auto labels{fmt::format("handler=\"{}\""_cf, Id())};
+  m_shape_hits = stats::add_stat("mqtt_bridge_json_shape_hits_total"sv,
+                                 "Payloads matching their topic's learned shape, extracted without parsing."sv,
+                                 stats::StatType::Counter,
+                                 labels);
+  m_shape_misses = stats::add_stat("mqtt_bridge_json_shape_misses_total"sv,
+                                   "Payloads not matching a learned shape, so parsed."sv,
+                                   stats::StatType::Counter,
+                                   labels);
+
+  return true;
 }
 
 void MqttJsonHandler::Event(std::string_view p_mqtt_data,
                             const std::string_view p_topic,
-                            const yy_mqtt::TopicLevelsView & p_levels ,
+                            const TopicMatch & p_match,
                             const timestamp_type p_timestamp,
                             yy_prometheus::MetricDataVectorPtr p_metric_data) noexcept
 {
@@ -139,15 +367,85 @@ void MqttJsonHandler::Event(std::string_view p_mqtt_data,
   auto & visitor = handler.visitor();
 
   visitor.reset();
-  visitor.levels(&p_levels);
+  visitor.match(&p_match);
   visitor.metric_data(p_metric_data);
   visitor.timestamp(p_timestamp);
   visitor.topic(p_topic);
 
-  m_parser.write_some(false,
-                      p_mqtt_data.data(),
-                      p_mqtt_data.size(),
-                      boost::json::error_code{});
+  if(!m_shapes)
+  {
+    std::ignore = Parse(p_mqtt_data, p_topic);
+    return;
+  }
+
+  const auto topic_hash = ShapeCache::hash(p_topic);
+  auto * shape = m_shapes->find(p_topic, topic_hash);
+
+  if((nullptr != shape) && shape->value.match(p_mqtt_data, m_shape_values))
+  {
+    m_shape_hits->Add();
+
+    for(const auto & [target, raw, is_string] : m_shape_values)
+    {
+      auto & metrics = m_shape_metrics[target];
+
+      if(is_string)
+      {
+        visitor.apply_str(metrics, raw);
+      }
+      else if(!visitor.apply_scalar(metrics, raw))
+      {
+        spdlog::debug("  handler [{}] invalid json topic [{}]"sv, Id(), p_topic);
+        break;
+      }
+    }
+    return;
+  }
+
+  m_shape_misses->Add();
+
+  if(Parse(p_mqtt_data, p_topic))
+  {
+    if(nullptr == shape)
+    {
+      shape = &m_shapes->emplace(p_topic, topic_hash);
+      shape->value.clear();
+    }
+
+    // Payloads whose shape can't be learnt (e.g. a nested target)
+    // won't be later, so aren't re-learnt.
+    if(JsonShape::State::NotFlat != shape->value.state())
+    {
+      std::ignore = shape->value.learn(p_mqtt_data, m_shape_keys);
+    }
+  }
+}
+
+bool MqttJsonHandler::Parse(std::string_view p_mqtt_data,
+                            const std::string_view p_topic)
+{
+  auto & visitor = m_parser.handler().visitor();
+
+  boost::json::error_code ec{};
+  const auto parsed = m_parser.write_some(false,
+                                          p_mqtt_data.data(),
+                                          p_mqtt_data.size(),
+                                          ec);
+
+  if(visitor.done())
+  {
+    if(parsed < p_mqtt_data.size())
+    {
+      m_skipped_bytes->Add(p_mqtt_data.size() - parsed);
+    }
+  }
+  else if(ec)
+  {
+    spdlog::debug("  handler [{}] invalid json topic [{}]"sv, Id(), p_topic);
+    return false;
+  }
+
+  return true;
 }
 
 } // namespace yafiyogi::mqtt_bridge
@@ -28,15 +28,27 @@
 
 #include <cstdint>
 
+#include <memory>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <tuple>
+#include <vector>
+
 #include "boost/json/basic_parser_impl.hpp"
 
+#include "yy_cpp/yy_vector.h"
 #include "yy_json/yy_json_pointer.h"
 #include "yy_mqtt/yy_mqtt_types.h"
 
 #include "yy_prometheus/yy_prometheus_metric_data.h"
 
+#include "bridge_stats.h"
+#include "json_shape.h"
 #include "mqtt_handler.h"
+#include "numeric_value.h"
 #include "prometheus_metric.h"
+#include "topic_cache.h"
 #include "value_type.h"
 
 namespace yafiyogi::mqtt_bridge {
@@ -55,12 +67,21 @@ class JsonVisitor final
     constexpr JsonVisitor & operator=(const JsonVisitor &) noexcept = default;
     JsonVisitor & operator=(JsonVisitor && p_other) noexcept;
 
-    void levels(const yy_mqtt::TopicLevelsView * p_levels) noexcept;
+    void match(const TopicMatch * p_match) noexcept;
     void metric_data(yy_prometheus::MetricDataVectorPtr p_metric_data) noexcept;
     void topic(const std::string_view p_topic) noexcept;
     void timestamp(const timestamp_type p_timestamp) noexcept;
+    void pointers(size_type p_pointers) noexcept;
+    void captures(prometheus::Captures p_captures) noexcept;
     void reset() noexcept;
 
+    // True once every pointer has a value.
+    [[nodiscard]]
+    constexpr bool done() const noexcept
+    {
+      return (0 != m_pointers) && (m_found >= m_pointers);
+    }
+
     void apply_str(Metrics & metrics,
                    std::string_view str)
     {
@@ -68,45 +89,156 @@ class JsonVisitor final
     }
 
     void apply_int64(Metrics & metrics,
-                     std::string_view raw,
-                     std::int64_t /* num */)
+                     std::int64_t num)
     {
-      apply(metrics, raw, yy_values::ValueType::Int);
+      apply(metrics, NumericValue{num});
     }
 
     void apply_uint64(Metrics & metrics,
-                      std::string_view raw,
-                      std::uint64_t /* num */)
+                      std::uint64_t num)
     {
-      apply(metrics, raw, yy_values::ValueType::UInt);
+      apply(metrics, NumericValue{num});
     }
 
     void apply_double(Metrics & metrics,
-                      std::string_view raw,
-                      double /* num */)
+                      double num)
     {
-      apply(metrics, raw, yy_values::ValueType::Float);
+      apply(metrics, NumericValue{num});
     }
 
     void apply_bool(Metrics & metrics,
                     bool flag)
     {
-      apply(metrics, flag ? g_true_str : g_false_str, yy_values::ValueType::Bool);
+      apply(metrics, NumericValue{flag});
     }
 
+    // Applies a raw number, true, false or null (which has no value).
+    // Returns false if raw isn't a valid scalar.
+    bool apply_scalar(Metrics & metrics,
+                      std::string_view raw);
+
   private:
     void apply(Metrics & p_metrics,
                std::string_view p_data,
                yy_values::ValueType p_value_type);
+    void apply(Metrics & p_metrics,
+               const NumericValue & p_value);
 
     static constexpr const std::string_view g_true_str{"true"};
     static constexpr const std::string_view g_false_str{"false"};
-    static const yy_mqtt::TopicLevelsView g_empty_levels;
+    static const TopicMatch g_empty_match;
 
-    yy_data::observer_ptr<std::add_const_t<yy_mqtt::TopicLevelsView>> m_levels{&g_empty_levels};
+    yy_data::observer_ptr<const TopicMatch> m_match{&g_empty_match};
     yy_prometheus::MetricDataVectorPtr m_metric_data{};
     timestamp_type m_timestamp{};
     std::string_view m_topic{};
+    prometheus::Captures m_captures{};
+    size_type m_pointers = 0;
+    size_type m_found = 0;
+};
+
+// Stops the parse once every pointer has a value, by failing the
+// first callback after the last value. The rest of the document isn't
+// parsed, so no errors are raised for it.
+template<typename Handler>
+class EarlyStopHandler final:
+      public Handler
+{
+  public:
+    using Handler::Handler;
+    using error_code = typename Handler::error_code;
+    using string_view = typename Handler::string_view;
+
+    bool on_string(string_view p_str,
+                   std::size_t p_size,
+                   error_code & p_ec)
+    {
+      return Handler::on_string(p_str, p_size, p_ec) && more(p_ec);
+    }
+
+    bool on_int64(std::int64_t p_num,
+                  string_view p_raw,
+                  error_code & p_ec)
+    {
+      return Handler::on_int64(p_num, p_raw, p_ec) && more(p_ec);
+    }
+
+    bool on_uint64(std::uint64_t p_num,
+                   string_view p_raw,
+                   error_code & p_ec)
+    {
+      return Handler::on_uint64(p_num, p_raw, p_ec) && more(p_ec);
+    }
+
+    bool on_double(double p_num,
+                   string_view p_raw,
+                   error_code & p_ec)
+    {
+      return Handler::on_double(p_num, p_raw, p_ec) && more(p_ec);
+    }
+
+    bool on_bool(bool p_flag,
+                 error_code & p_ec)
+    {
+      return Handler::on_bool(p_flag, p_ec) && more(p_ec);
+    }
+
+  private:
+    bool more(error_code & p_ec) noexcept
+    {
+      if(this->visitor().done())
+      {
+        p_ec = std::make_error_code(std::errc::operation_canceled);
+        return false;
+      }
+
+      return true;
+    }
+};
+
+// A handler's json pointers & their metrics. Kept so handlers sharing
+// a topic can be combined into one parser.
+class JsonPointers final
+{
+  public:
+    using Metrics = prometheus::Metrics;
+
+    struct Pointer final
+    {
+        std::string pointer{};
+        Metrics metrics{};
+    };
+
+    using container_type = yy_quad::simple_vector<Pointer>;
+    using const_iterator = container_type::const_iterator;
+
+    // Returns the pointer's metrics, and whether the pointer was added.
+    std::tuple<Metrics *, bool> add_pointer(std::string_view p_pointer,
+                                            Metrics && p_metrics);
+
+    // Adds p_other's pointers, sharing their metrics.
+    void merge(const JsonPointers & p_other);
+
+    [[nodiscard]]
+    size_type size() const noexcept
+    {
+      return m_pointers.size();
+    }
+
+    [[nodiscard]]
+    const_iterator begin() const noexcept
+    {
+      return m_pointers.begin();
+    }
+
+    [[nodiscard]]
+    const_iterator end() const noexcept
+    {
+      return m_pointers.end();
+    }
+
+  private:
+    container_type m_pointers{};
 };
 
 } // namespace json_handler_detail
@@ -115,15 +247,18 @@ class MqttJsonHandler final:
       public MqttHandler
 {
   public:
-    using builder_type = yy_json::json_pointer_builder<prometheus::Metrics, json_handler_detail::JsonVisitor>;
-    using handler_type = builder_type::handler_type;
-    using handler_config_type = handler_type::pointers_config_type;
+    using builder_type = json_handler_detail::JsonPointers;
+    using automaton_builder_type = yy_json::json_pointer_builder<prometheus::Metrics, json_handler_detail::JsonVisitor>;
+    using handler_type = json_handler_detail::EarlyStopHandler<automaton_builder_type::handler_type>;
+    using handler_config_type = automaton_builder_type::handler_type::pointers_config_type;
     using parser_type = boost::json::basic_parser<handler_type>;
     using parser_options_type = boost::json::parse_options;
 
+    static constexpr size_type default_shape_cache_size = 1024;
+
     explicit MqttJsonHandler(std::string_view p_handler_id,
                              const parser_options_type & p_json_options,
-                             handler_config_type && p_json_handler_config,
+                             builder_type && p_json_pointers,
                              size_type p_metric_count) noexcept;
 
     MqttJsonHandler() = delete;
@@ -133,14 +268,46 @@ class MqttJsonHandler final:
     MqttJsonHandler & operator=(const MqttJsonHandler &) = delete;
     constexpr MqttJsonHandler & operator=(MqttJsonHandler &&) noexcept = default;
 
+    [[nodiscard]]
+    constexpr const builder_type & Pointers() const noexcept
+    {
+      return m_pointers;
+    }
+
+    // Learns the shape of each topic's payloads (see JsonShape),
+    // extracting values from payloads matching their topic's shape
+    // without parsing. Only possible if every pointer is a top level
+    // key. Returns false if not possible.
+    bool LearnShapes(size_type p_shape_cache_size);
+
+    [[nodiscard]]
+    size_type ShapeCacheSize() const noexcept
+    {
+      return m_shapes ? m_shapes->capacity() : 0;
+    }
+
     void Event(std::string_view p_mqtt_data,
                const std::string_view p_topic,
-               const yy_mqtt::TopicLevelsView & p_levels ,
+               const TopicMatch & p_match,
                const timestamp_type p_timestamp,
                yy_prometheus::MetricDataVectorPtr p_metric_data) noexcept override;
 
   private:
+    using ShapeCache = TopicCache<JsonShape>;
+
+    bool Parse(std::string_view p_mqtt_data,
+               const std::string_view p_topic);
+
+    builder_type m_pointers;
     parser_type m_parser;
+    stats::StatPtr m_skipped_bytes{};
+
+    std::unique_ptr<ShapeCache> m_shapes{};
+    std::vector<std::string> m_shape_keys{};
+    yy_quad::simple_vector<prometheus::Metrics> m_shape_metrics{};
+    JsonShape::Values m_shape_values{};
+    stats::StatPtr m_shape_hits{};
+    stats::StatPtr m_shape_misses{};
 };
 
 } // namespace yafiyogi::mqtt_bridge
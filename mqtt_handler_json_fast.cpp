@@ -0,0 +1,653 @@
+/*
+
+  MIT License
+
+  Copyright (c) 2025 Yafiyogi
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+#include "fmt/compile.h"
+#include "fmt/format.h"
+#include "spdlog/spdlog.h"
+
+#include "yy_cpp/yy_string_util.h"
+
+#include "yy_prometheus/yy_prometheus_metric_data.h"
+
+#include "mqtt_handler_json_fast.h"
+
+namespace yafiyogi::mqtt_bridge {
+
+using namespace std::string_view_literals;
+using namespace fmt::literals;
+
+namespace json_fast {
+namespace {
+
+constexpr std::string_view whitespace{" \t\r\n"};
+
+std::string_view trim(std::string_view p_str) noexcept
+{
+  const auto begin = p_str.find_first_not_of(whitespace);
+  if(std::string_view::npos == begin)
+  {
+    return std::string_view{};
+  }
+
+  return p_str.substr(begin, p_str.find_last_not_of(whitespace) - begin + 1);
+}
+
+size_type to_index(std::string_view p_key) noexcept
+{
+  if(p_key.empty()
+     || ((p_key.size() > 1) && ('0' == p_key[0])))
+  {
+    return PointerTree::no_index;
+  }
+
+  size_type index = 0;
+  auto [ptr, ec] = std::from_chars(p_key.data(), p_key.data() + p_key.size(), index);
+  if((std::errc{} != ec) || (ptr != p_key.data() + p_key.size()))
+  {
+    return PointerTree::no_index;
+  }
+
+  return index;
+}
+
+// A '*' or '{label}' token.
+bool is_wildcard(std::string_view p_token) noexcept
+{
+  return ("*"sv == p_token)
+    || ((p_token.size() > 2) && p_token.starts_with('{') && p_token.ends_with('}'));
+}
+
+enum class Walk:uint8_t {Continue, Done, Error};
+
+// Walks a document's structural index, descending only into the values
+// on a configured pointer's path.
+class Navigator final
+{
+  public:
+    using Node = PointerTree::Node;
+    using JsonVisitor = json_handler_detail::JsonVisitor;
+
+    explicit Navigator(std::string_view p_json,
+                       const StructuralIndex & p_index,
+                       PointerTree & p_pointers,
+                       JsonVisitor & p_visitor,
+                       std::vector<prometheus::Capture> & p_captures,
+                       std::string & p_str) noexcept:
+      m_json(p_json),
+      m_index(p_index),
+      m_pointers(p_pointers),
+      m_visitor(p_visitor),
+      m_captures(p_captures),
+      m_str(p_str)
+    {
+    }
+
+    Navigator() = delete;
+    Navigator(const Navigator &) = delete;
+    Navigator(Navigator &&) = delete;
+
+    Navigator & operator=(const Navigator &) = delete;
+    Navigator & operator=(Navigator &&) = delete;
+
+    [[nodiscard]]
+    Walk walk()
+    {
+      return value(&m_pointers.root(), 0);
+    }
+
+    // Bytes walked.
+    [[nodiscard]]
+    size_type parsed() const noexcept
+    {
+      return m_cursor < m_index.size() ? m_index[m_cursor] : m_json.size();
+    }
+
+  private:
+    [[nodiscard]]
+    char token() const noexcept
+    {
+      return m_json[m_index[m_cursor]];
+    }
+
+    // Value starting at byte p_begin. The cursor is at the first
+    // structural character at or after p_begin.
+    Walk value(Node * p_node,
+               size_type p_begin)
+    {
+      const size_type end = m_cursor < m_index.size() ? m_index[m_cursor] : m_json.size();
+
+      if(auto raw = trim(m_json.substr(p_begin, end - p_begin));
+         !raw.empty())
+      {
+        return scalar(p_node, raw);
+      }
+
+      if(m_cursor >= m_index.size())
+      {
+        return Walk::Error;
+      }
+
+      switch(token())
+      {
+        case '"':
+        {
+          if((m_cursor + 1) >= m_index.size())
+          {
+            return Walk::Error;
+          }
+
+          const size_type begin = m_index[m_cursor] + 1;
+          const auto raw = m_json.substr(begin, m_index[m_cursor + 1] - begin);
+          m_cursor += 2;
+
+          return string(p_node, raw);
+        }
+
+        case '{':
+          if((nullptr == p_node) || p_node->children.empty())
+          {
+            return skip();
+          }
+          return object(*p_node);
+
+        case '[':
+          if((nullptr == p_node) || p_node->children.empty())
+          {
+            return skip();
+          }
+          return array(*p_node);
+
+        default:
+          return Walk::Error;
+      }
+    }
+
+    Walk object(const Node & p_node)
+    {
+      ++m_cursor;
+      if(m_cursor >= m_index.size())
+      {
+        return Walk::Error;
+      }
+
+      if('}' == token())
+      {
+        ++m_cursor;
+        return Walk::Continue;
+      }
+
+      while(true)
+      {
+        if(((m_cursor + 2) >= m_index.size())
+           || ('"' != token()))
+        {
+          return Walk::Error;
+        }
+
+        const size_type key_begin = m_index[m_cursor] + 1;
+        std::string_view key = m_json.substr(key_begin, m_index[m_cursor + 1] - key_begin);
+        m_cursor += 2;
+
+        if(':' != token())
+        {
+          return Walk::Error;
+        }
+        const size_type begin = m_index[m_cursor] + 1;
+        ++m_cursor;
+
+        if(std::string_view::npos != key.find('\\'))
+        {
+          m_key.clear();
+          if(!unescape(key, m_key))
+          {
+            return Walk::Error;
+          }
+          key = m_key;
+        }
+
+        if(auto walk = child(m_pointers.find_key(p_node, key), key, begin);
+           Walk::Continue != walk)
+        {
+          return walk;
+        }
+
+        if(m_cursor >= m_index.size())
+        {
+          return Walk::Error;
+        }
+
+        switch(token())
+        {
+          case ',':
+            ++m_cursor;
+            break;
+
+          case '}':
+            ++m_cursor;
+            return Walk::Continue;
+
+          default:
+            return Walk::Error;
+        }
+      }
+    }
+
+    Walk array(const Node & p_node)
+    {
+      size_type begin = m_index[m_cursor] + 1;
+      ++m_cursor;
+      if(m_cursor >= m_index.size())
+      {
+        return Walk::Error;
+      }
+
+      if((']' == token())
+         && trim(m_json.substr(begin, m_index[m_cursor] - begin)).empty())
+      {
+        ++m_cursor;
+        return Walk::Continue;
+      }
+
+      char index_str[std::numeric_limits<size_type>::digits10 + 1];
+
+      for(size_type index = 0; ; ++index)
+      {
+        Node * node = m_pointers.find_index(p_node, index);
+        std::string_view capture{};
+
+        if((nullptr != node) && node->wildcard)
+        {
+          auto [ptr, ec] = std::to_chars(index_str, index_str + sizeof(index_str), index);
+          capture = std::string_view{index_str, static_cast<size_type>(ptr - index_str)};
+        }
+
+        if(auto walk = child(node, capture, begin);
+           Walk::Continue != walk)
+        {
+          return walk;
+        }
+
+        if(m_cursor >= m_index.size())
+        {
+          return Walk::Error;
+        }
+
+        switch(token())
+        {
+          case ',':
+            begin = m_index[m_cursor] + 1;
+            ++m_cursor;
+            break;
+
+          case ']':
+            ++m_cursor;
+            return Walk::Continue;
+
+          default:
+            return Walk::Error;
+        }
+      }
+    }
+
+    // Walks a member's value, capturing its key or index for a wildcard.
+    Walk child(Node * p_node,
+               std::string_view p_capture,
+               size_type p_begin)
+    {
+      if((nullptr == p_node) || !p_node->wildcard)
+      {
+        return value(p_node, p_begin);
+      }
+
+      auto & capture = m_captures[m_capture_count];
+      capture.name.assign(p_node->label);
+      capture.value.assign(p_capture);
+
+      ++m_capture_count;
+      m_visitor.captures(prometheus::Captures{m_captures.data(), m_capture_count});
+
+      const auto walk = value(p_node, p_begin);
+
+      --m_capture_count;
+      m_visitor.captures(prometheus::Captures{m_captures.data(), m_capture_count});
+
+      return walk;
+    }
+
+    // Skips the object or array at the cursor. Strings are index pairs
+    // of quotes, so only brackets need counting.
+    Walk skip() noexcept
+    {
+      size_type depth = 0;
+
+      while(m_cursor < m_index.size())
+      {
+        switch(m_json[m_index[m_cursor++]])
+        {
+          case '{':
+          case '[':
+            ++depth;
+            break;
+
+          case '}':
+          case ']':
+            if(0 == --depth)
+            {
+              return Walk::Continue;
+            }
+            break;
+
+          default:
+            break;
+        }
+      }
+
+      return Walk::Error;
+    }
+
+    Walk string(Node * p_node,
+                std::string_view p_raw)
+    {
+      if((nullptr == p_node) || !p_node->is_pointer)
+      {
+        return Walk::Continue;
+      }
+
+      if(std::string_view::npos != p_raw.find('\\'))
+      {
+        m_str.clear();
+        if(!unescape(p_raw, m_str))
+        {
+          return Walk::Error;
+        }
+        p_raw = m_str;
+      }
+
+      m_visitor.apply_str(p_node->metrics, p_raw);
+
+      return found();
+    }
+
+    Walk scalar(Node * p_node,
+                std::string_view p_raw)
+    {
+      if((nullptr == p_node) || !p_node->is_pointer)
+      {
+        return Walk::Continue;
+      }
+
+      if(!m_visitor.apply_scalar(p_node->metrics, p_raw))
+      {
+        return Walk::Error;
+      }
+
+      return found();
+    }
+
+    Walk found() noexcept
+    {
+      // Wildcards match any number of values.
+      if(m_pointers.has_wildcards())
+      {
+        return Walk::Continue;
+      }
+
+      return ++m_found == m_pointers.pointer_count() ? Walk::Done : Walk::Continue;
+    }
+
+    std::string_view m_json;
+    const StructuralIndex & m_index;
+    PointerTree & m_pointers;
+    JsonVisitor & m_visitor;
+    std::vector<prometheus::Capture> & m_captures;
+    std::string & m_str;
+    std::string m_key{};
+    size_type m_capture_count = 0;
+    size_type m_cursor = 0;
+    size_type m_found = 0;
+};
+
+} // anonymous namespace
+
+PointerTree::PointerTree()
+{
+  m_nodes.emplace_back();
+}
+
+std::tuple<PointerTree::Metrics *, bool> PointerTree::add_pointer(std::string_view p_pointer,
+                                                                  Metrics && p_metrics)
+{
+  if(!p_pointer.empty() && ('/' == p_pointer[0]))
+  {
+    p_pointer.remove_prefix(1);
+  }
+
+  size_type node_idx = 0;
+  size_type captures = 0;
+  std::string key{};
+
+  while(!p_pointer.empty())
+  {
+    const auto slash = p_pointer.find('/');
+    const auto token = p_pointer.substr(0, slash);
+    p_pointer = std::string_view::npos == slash ? std::string_view{} : p_pointer.substr(slash + 1);
+
+    // Decode '~1' & '~0'.
+    key.clear();
+    for(size_type idx = 0; idx < token.size(); ++idx)
+    {
+      if('~' != token[idx])
+      {
+        key.push_back(token[idx]);
+      }
+      else if(++idx < token.size() && (('0' == token[idx]) || ('1' == token[idx])))
+      {
+        key.push_back('0' == token[idx] ? '~' : '/');
+      }
+      else
+      {
+        return {nullptr, false};
+      }
+    }
+
+    size_type child_idx = no_index;
+    for(const auto idx : m_nodes[node_idx].children)
+    {
+      if(m_nodes[idx].key == key)
+      {
+        child_idx = idx;
+        break;
+      }
+    }
+
+    const bool wildcard = is_wildcard(token);
+    if(wildcard)
+    {
+      ++captures;
+    }
+
+    if(no_index == child_idx)
+    {
+      std::string label{};
+      if(wildcard)
+      {
+        if("*"sv != token)
+        {
+          label = token.substr(1, token.size() - 2);
+        }
+        else if((0 != node_idx) && !m_nodes[node_idx].wildcard)
+        {
+          label = m_nodes[node_idx].key;
+        }
+        else
+        {
+          // '*' needs a previous token to name its label.
+          return {nullptr, false};
+        }
+      }
+
+      child_idx = m_nodes.size();
+      const auto index = wildcard ? no_index : to_index(key);
+      m_nodes.emplace_back(Node{std::move(key), index, false, wildcard, std::move(label), Metrics{}, {}});
+      m_nodes[node_idx].children.emplace_back(child_idx);
+      key = std::string{};
+    }
+
+    node_idx = child_idx;
+  }
+
+  auto & node = m_nodes[node_idx];
+  if(node.is_pointer)
+  {
+    return {&node.metrics, false};
+  }
+
+  node.is_pointer = true;
+  node.metrics = std::move(p_metrics);
+  ++m_pointer_count;
+  m_max_captures = std::max(m_max_captures, captures);
+
+  return {&node.metrics, true};
+}
+
+PointerTree::Node * PointerTree::find_key(const Node & p_node,
+                                          std::string_view p_key) noexcept
+{
+  Node * wildcard = nullptr;
+
+  for(const auto idx : p_node.children)
+  {
+    auto & child = m_nodes[idx];
+    if(child.wildcard)
+    {
+      wildcard = &child;
+    }
+    else if(child.key == p_key)
+    {
+      return &child;
+    }
+  }
+
+  return wildcard;
+}
+
+PointerTree::Node * PointerTree::find_index(const Node & p_node,
+                                            size_type p_index) noexcept
+{
+  Node * wildcard = nullptr;
+
+  for(const auto idx : p_node.children)
+  {
+    auto & child = m_nodes[idx];
+    if(child.wildcard)
+    {
+      wildcard = &child;
+    }
+    else if(child.index == p_index)
+    {
+      return &child;
+    }
+  }
+
+  return wildcard;
+}
+
+bool PointerTree::has_wildcard(std::string_view p_pointer) noexcept
+{
+  while(!p_pointer.empty())
+  {
+    const auto slash = p_pointer.find('/');
+    if(is_wildcard(p_pointer.substr(0, slash)))
+    {
+      return true;
+    }
+
+    p_pointer = std::string_view::npos == slash ? std::string_view{} : p_pointer.substr(slash + 1);
+  }
+
+  return false;
+}
+
+} // namespace json_fast
+
+MqttJsonFastHandler::MqttJsonFastHandler(std::string_view p_handler_id,
+                                         builder_type && p_pointers,
+                                         size_type p_metric_count) noexcept:
+  MqttHandler(p_handler_id, type::JsonFast, p_metric_count),
+  m_pointers(std::move(p_pointers)),
+  m_captures(m_pointers.max_captures())
+{
+  m_skipped_bytes = stats::add_stat("mqtt_bridge_json_skipped_bytes_total"sv,
+                                    "Payload bytes not parsed as every json pointer was found."sv,
+                                    stats::StatType::Counter,
+                                    fmt::format("handler=\"{}\""_cf, Id()));
+}
+
+void MqttJsonFastHandler::Event(std::string_view p_mqtt_data,
+                                const std::string_view p_topic,
+                                const TopicMatch & p_match,
+                                const timestamp_type p_timestamp,
+                                yy_prometheus::MetricDataVectorPtr p_metric_data) noexcept
+{
+  spdlog::debug("  handler [{}]"sv, Id());
+
+  m_visitor.reset();
+  m_visitor.match(&p_match);
+  m_visitor.metric_data(p_metric_data);
+  m_visitor.timestamp(p_timestamp);
+  m_visitor.topic(p_topic);
+
+  bool valid = json_fast::structural_index(p_mqtt_data, m_index);
+  if(valid)
+  {
+    json_fast::Navigator navigator{p_mqtt_data, m_index, m_pointers, m_visitor, m_captures, m_str};
+
+    const auto walk = navigator.walk();
+    valid = json_fast::Walk::Error != walk;
+
+    if(json_fast::Walk::Done == walk)
+    {
+      // The index covers the whole payload, but values past the last
+      // pointer aren't visited.
+      m_skipped_bytes->Add(p_mqtt_data.size() - navigator.parsed());
+    }
+  }
+
+  if(!valid)
+  {
+    spdlog::debug("  handler [{}] invalid json topic [{}]"sv, Id(), p_topic);
+  }
+}
+
+} // namespace yafiyogi::mqtt_bridge
@@ -0,0 +1,175 @@
+/*
+
+  MIT License
+
+  Copyright (c) 2025 Yafiyogi
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <limits>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+#include "yy_cpp/yy_types.hpp"
+#include "yy_cpp/yy_vector.h"
+#include "yy_mqtt/yy_mqtt_types.h"
+
+#include "yy_prometheus/yy_prometheus_metric_data.h"
+
+#include "bridge_stats.h"
+#include "json_fast_scan.h"
+#include "mqtt_handler.h"
+#include "mqtt_handler_json.h"
+#include "prometheus_metric.h"
+#include "value_type.h"
+
+namespace yafiyogi::mqtt_bridge {
+namespace json_fast {
+
+// Trie of the configured JSON pointers. Each node is one pointer
+// reference token; nodes that end a pointer hold its metrics.
+//
+// A '*' or '{label}' token is a wildcard, matching any object key or
+// array index. The matched key or index is captured as a label, named
+// 'label' or, for '*', after the previous token.
+class PointerTree final
+{
+  public:
+    using Metrics = prometheus::Metrics;
+    static constexpr size_type no_index = std::numeric_limits<size_type>::max();
+
+    struct Node final
+    {
+        std::string key{};
+        // The key as an array index, or no_index.
+        size_type index = no_index;
+        bool is_pointer = false;
+        bool wildcard = false;
+        std::string label{};
+        Metrics metrics{};
+        yy_quad::simple_vector<size_type> children{};
+    };
+
+    PointerTree();
+    PointerTree(const PointerTree &) = delete;
+    PointerTree(PointerTree &&) noexcept = default;
+
+    PointerTree & operator=(const PointerTree &) = delete;
+    PointerTree & operator=(PointerTree &&) noexcept = default;
+
+    // Returns the pointer's metrics, and whether the pointer was added,
+    // or nullptr if the pointer is malformed.
+    std::tuple<Metrics *, bool> add_pointer(std::string_view p_pointer,
+                                            Metrics && p_metrics);
+
+    [[nodiscard]]
+    const Node & root() const noexcept
+    {
+      return m_nodes[0];
+    }
+
+    [[nodiscard]]
+    Node & root() noexcept
+    {
+      return m_nodes[0];
+    }
+
+    [[nodiscard]]
+    Node * find_key(const Node & p_node,
+                    std::string_view p_key) noexcept;
+
+    [[nodiscard]]
+    Node * find_index(const Node & p_node,
+                      size_type p_index) noexcept;
+
+    [[nodiscard]]
+    constexpr size_type pointer_count() const noexcept
+    {
+      return m_pointer_count;
+    }
+
+    // Most wildcards on one pointer.
+    [[nodiscard]]
+    constexpr size_type max_captures() const noexcept
+    {
+      return m_max_captures;
+    }
+
+    [[nodiscard]]
+    constexpr bool has_wildcards() const noexcept
+    {
+      return 0 != m_max_captures;
+    }
+
+    [[nodiscard]]
+    static bool has_wildcard(std::string_view p_pointer) noexcept;
+
+  private:
+    yy_quad::simple_vector<Node> m_nodes{};
+    size_type m_pointer_count = 0;
+    size_type m_max_captures = 0;
+};
+
+} // namespace json_fast
+
+// Extracts the configured JSON pointers without a full parse. The
+// payload's structural index is built with SIMD, then the handler only
+// descends into objects & arrays on a configured pointer's path,
+// skipping everything else, and stops once every pointer is found.
+// Pointers with wildcards emit a value for each match, with the
+// captured keys as labels.
+class MqttJsonFastHandler final:
+      public MqttHandler
+{
+  public:
+    using builder_type = json_fast::PointerTree;
+
+    explicit MqttJsonFastHandler(std::string_view p_handler_id,
+                                 builder_type && p_pointers,
+                                 size_type p_metric_count) noexcept;
+
+    MqttJsonFastHandler() = delete;
+    MqttJsonFastHandler(const MqttJsonFastHandler &) = delete;
+    MqttJsonFastHandler(MqttJsonFastHandler &&) noexcept = default;
+
+    MqttJsonFastHandler & operator=(const MqttJsonFastHandler &) = delete;
+    MqttJsonFastHandler & operator=(MqttJsonFastHandler &&) noexcept = default;
+
+    void Event(std::string_view p_mqtt_data,
+               const std::string_view p_topic,
+               const TopicMatch & p_match,
+               const timestamp_type p_timestamp,
+               yy_prometheus::MetricDataVectorPtr p_metric_data) noexcept override;
+
+  private:
+    builder_type m_pointers;
+    json_fast::StructuralIndex m_index{};
+    json_handler_detail::JsonVisitor m_visitor{};
+    std::vector<prometheus::Capture> m_captures;
+    std::string m_str{};
+    stats::StatPtr m_skipped_bytes{};
+};
+
+} // namespace yafiyogi::mqtt_bridge
@@ -0,0 +1,525 @@
+/*
+
+  MIT License
+
+  Copyright (c) 2025 Yafiyogi
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "fmt/compile.h"
+#include "fmt/format.h"
+#include "spdlog/spdlog.h"
+
+#include "yy_prometheus/yy_prometheus_metric_data.h"
+
+#include "mqtt_handler_sparkplug.h"
+
+namespace yafiyogi::mqtt_bridge {
+
+using namespace std::string_view_literals;
+using namespace fmt::literals;
+
+namespace sparkplug {
+
+struct Alias final
+{
+    size_type name = MetricNames::no_name;
+    DataType datatype = DataType::Unknown;
+};
+
+// Metric aliases of each edge node ('<group>/<node>'), for one handler
+// id. Lock the mutex shared to read, unique to change the tables.
+class AliasTables final
+{
+  public:
+    using NodeAliases = std::unordered_map<std::uint64_t, Alias>;
+
+    [[nodiscard]]
+    std::shared_mutex & mutex() noexcept
+    {
+      return m_mtx;
+    }
+
+    [[nodiscard]]
+    NodeAliases & node(std::string_view p_node)
+    {
+      auto node_iter = m_nodes.find(p_node);
+      if(m_nodes.end() == node_iter)
+      {
+        node_iter = m_nodes.emplace(std::string{p_node}, NodeAliases{}).first;
+      }
+
+      return node_iter->second;
+    }
+
+    [[nodiscard]]
+    const NodeAliases * find(std::string_view p_node) const noexcept
+    {
+      const auto node_iter = m_nodes.find(p_node);
+
+      return m_nodes.end() != node_iter ? &node_iter->second : nullptr;
+    }
+
+    void erase(std::string_view p_node)
+    {
+      if(auto node_iter = m_nodes.find(p_node);
+         m_nodes.end() != node_iter)
+      {
+        m_nodes.erase(node_iter);
+      }
+    }
+
+  private:
+    struct node_hash final
+    {
+        using is_transparent = void;
+
+        std::size_t operator()(std::string_view p_str) const noexcept
+        {
+          return std::hash<std::string_view>{}(p_str);
+        }
+    };
+
+    std::shared_mutex m_mtx{};
+    std::unordered_map<std::string, NodeAliases, node_hash, std::equal_to<>> m_nodes{};
+};
+
+namespace {
+
+enum class MessageType:uint8_t {Birth, NodeBirth, Data, NodeDeath, Other};
+
+// Payload & Metric field numbers.
+constexpr std::uint32_t payload_metrics = 2;
+constexpr std::uint32_t metric_name = 1;
+constexpr std::uint32_t metric_alias = 2;
+constexpr std::uint32_t metric_datatype = 4;
+constexpr std::uint32_t metric_is_null = 7;
+constexpr std::uint32_t metric_int_value = 10;
+constexpr std::uint32_t metric_long_value = 11;
+constexpr std::uint32_t metric_float_value = 12;
+constexpr std::uint32_t metric_double_value = 13;
+constexpr std::uint32_t metric_boolean_value = 14;
+constexpr std::uint32_t metric_string_value = 15;
+
+MessageType message_type(std::string_view p_type) noexcept
+{
+  if("NDATA"sv == p_type || "DDATA"sv == p_type)
+  {
+    return MessageType::Data;
+  }
+
+  if("NBIRTH"sv == p_type)
+  {
+    return MessageType::NodeBirth;
+  }
+
+  if("DBIRTH"sv == p_type)
+  {
+    return MessageType::Birth;
+  }
+
+  if("NDEATH"sv == p_type)
+  {
+    return MessageType::NodeDeath;
+  }
+
+  return MessageType::Other;
+}
+
+std::mutex g_alias_tables_mtx{};
+
+std::shared_ptr<AliasTables> alias_tables(std::string_view p_handler_id)
+{
+  static std::unordered_map<std::string, std::weak_ptr<AliasTables>> g_alias_tables{};
+
+  std::unique_lock lck{g_alias_tables_mtx};
+
+  auto & weak_tables = g_alias_tables[std::string{p_handler_id}];
+  auto tables = weak_tables.lock();
+  if(!tables)
+  {
+    tables = std::make_shared<AliasTables>();
+    weak_tables = tables;
+  }
+
+  return tables;
+}
+
+} // anonymous namespace
+
+std::tuple<MetricNames::Metrics *, bool> MetricNames::add_name(std::string_view p_name,
+                                                               Metrics && p_metrics)
+{
+  for(auto & [name, metrics] : m_names)
+  {
+    if(name == p_name)
+    {
+      return {&metrics, false};
+    }
+  }
+
+  const size_type pos = m_names.size();
+  m_names.emplace_back(Name{std::string{p_name}, std::move(p_metrics)});
+
+  return {&m_names[pos].metrics, true};
+}
+
+} // namespace sparkplug
+
+MqttSparkplugHandler::MqttSparkplugHandler(std::string_view p_handler_id,
+                                           builder_type && p_names,
+                                           size_type p_metric_count) noexcept:
+  MqttHandler(p_handler_id, type::Sparkplug, p_metric_count),
+  m_names(std::move(p_names)),
+  m_aliases(sparkplug::alias_tables(p_handler_id))
+{
+  m_name_index.reserve(m_names.size());
+  for(size_type pos = 0; pos < m_names.size(); ++pos)
+  {
+    m_name_index.emplace(m_names[pos].name, pos);
+  }
+
+  m_alias_misses = stats::add_stat("mqtt_bridge_sparkplug_alias_misses_total"sv,
+                                   "Sparkplug data metrics whose alias wasn't defined by a birth certificate."sv,
+                                   stats::StatType::Counter,
+                                   fmt::format("handler=\"{}\""_cf, Id()));
+}
+
+size_type MqttSparkplugHandler::FindName(std::string_view p_name) const noexcept
+{
+  const auto name_iter = m_name_index.find(p_name);
+
+  return m_name_index.end() != name_iter ? name_iter->second : builder_type::no_name;
+}
+
+bool MqttSparkplugHandler::DecodeMetric(std::string_view p_metric,
+                                        MetricValue & p_value) noexcept
+{
+  protobuf::Reader reader{p_metric};
+  std::uint32_t field = 0;
+  protobuf::WireType wire_type = protobuf::WireType::Varint;
+
+  while(reader.next(field, wire_type))
+  {
+    bool ok = true;
+    std::uint64_t num = 0;
+    std::uint32_t num32 = 0;
+
+    switch(field)
+    {
+      case sparkplug::metric_name:
+        ok = (protobuf::WireType::Len == wire_type) && reader.bytes(p_value.name);
+        break;
+
+      case sparkplug::metric_alias:
+        ok = (protobuf::WireType::Varint == wire_type) && reader.varint(p_value.alias);
+        p_value.has_alias = true;
+        break;
+
+      case sparkplug::metric_datatype:
+        ok = (protobuf::WireType::Varint == wire_type) && reader.varint(num);
+        p_value.datatype = static_cast<DataType>(num);
+        break;
+
+      case sparkplug::metric_is_null:
+        ok = (protobuf::WireType::Varint == wire_type) && reader.varint(num);
+        p_value.is_null = 0 != num;
+        break;
+
+      case sparkplug::metric_int_value:
+      case sparkplug::metric_long_value:
+      case sparkplug::metric_boolean_value:
+        ok = (protobuf::WireType::Varint == wire_type) && reader.varint(p_value.num);
+        p_value.value_field = field;
+        break;
+
+      case sparkplug::metric_float_value:
+        ok = (protobuf::WireType::Fixed32 == wire_type) && reader.fixed32(num32);
+        p_value.num = num32;
+        p_value.value_field = field;
+        break;
+
+      case sparkplug::metric_double_value:
+        ok = (protobuf::WireType::Fixed64 == wire_type) && reader.fixed64(p_value.num);
+        p_value.value_field = field;
+        break;
+
+      case sparkplug::metric_string_value:
+        ok = (protobuf::WireType::Len == wire_type) && reader.bytes(p_value.str);
+        p_value.value_field = field;
+        break;
+
+      default:
+        // Metadata, properties, datasets, templates & bytes.
+        ok = reader.skip(wire_type);
+        break;
+    }
+
+    if(!ok)
+    {
+      return false;
+    }
+  }
+
+  return reader.ok();
+}
+
+void MqttSparkplugHandler::Emit(size_type p_name,
+                                DataType p_datatype,
+                                const MetricValue & p_value,
+                                const Message & p_message) noexcept
+{
+  NumericValue value{};
+
+  // Signed integers are two's complement in the unsigned fields.
+  switch(p_value.value_field)
+  {
+    case sparkplug::metric_int_value:
+    case sparkplug::metric_long_value:
+      switch(p_datatype)
+      {
+        case DataType::Int8:
+          value = NumericValue{std::int64_t{static_cast<std::int8_t>(p_value.num)}};
+          break;
+
+        case DataType::Int16:
+          value = NumericValue{std::int64_t{static_cast<std::int16_t>(p_value.num)}};
+          break;
+
+        case DataType::Int32:
+          value = NumericValue{std::int64_t{static_cast<std::int32_t>(p_value.num)}};
+          break;
+
+        case DataType::Int64:
+          value = NumericValue{static_cast<std::int64_t>(p_value.num)};
+          break;
+
+        default:
+          value = NumericValue{p_value.num};
+          break;
+      }
+      break;
+
+    case sparkplug::metric_float_value:
+      value = NumericValue{std::bit_cast<float>(static_cast<std::uint32_t>(p_value.num))};
+      break;
+
+    case sparkplug::metric_double_value:
+      value = NumericValue{std::bit_cast<double>(p_value.num)};
+      break;
+
+    case sparkplug::metric_boolean_value:
+      value = NumericValue{0 != p_value.num};
+      break;
+
+    case sparkplug::metric_string_value:
+      for(auto & metric : m_names[p_name].metrics)
+      {
+        metric->Event(p_value.str,
+                      p_message.topic,
+                      *p_message.match,
+                      p_message.timestamp,
+                      yy_values::ValueType::String,
+                      p_message.metric_data);
+      }
+      return;
+
+    default:
+      return;
+  }
+
+  for(auto & metric : m_names[p_name].metrics)
+  {
+    metric->Event(value,
+                  p_message.topic,
+                  *p_message.match,
+                  p_message.timestamp,
+                  p_message.metric_data);
+  }
+}
+
+// Calls p_alias(metric_value, name, datatype) for each metric, to
+// record or resolve its alias, then emits the configured metrics.
+template<typename AliasFn>
+bool MqttSparkplugHandler::Decode(std::string_view p_payload,
+                                  const Message & p_message,
+                                  AliasFn && p_alias)
+{
+  protobuf::Reader reader{p_payload};
+  std::uint32_t field = 0;
+  protobuf::WireType wire_type = protobuf::WireType::Varint;
+
+  while(reader.next(field, wire_type))
+  {
+    if((sparkplug::payload_metrics != field)
+       || (protobuf::WireType::Len != wire_type))
+    {
+      // Timestamp, seq, uuid & body.
+      if(!reader.skip(wire_type))
+      {
+        return false;
+      }
+      continue;
+    }
+
+    std::string_view metric{};
+    MetricValue value{};
+    if(!reader.bytes(metric)
+       || !DecodeMetric(metric, value))
+    {
+      return false;
+    }
+
+    size_type name = value.name.empty() ? builder_type::no_name : FindName(value.name);
+    DataType datatype = value.datatype;
+    p_alias(value, name, datatype);
+
+    if((builder_type::no_name != name) && !value.is_null)
+    {
+      Emit(name, datatype, value, p_message);
+    }
+  }
+
+  return reader.ok();
+}
+
+void MqttSparkplugHandler::Event(std::string_view p_mqtt_data,
+                                 const std::string_view p_topic,
+                                 const TopicMatch & p_match,
+                                 const timestamp_type p_timestamp,
+                                 yy_prometheus::MetricDataVectorPtr p_metric_data) noexcept
+{
+  spdlog::debug("  handler [{}]"sv, Id());
+
+  if((p_match.levels.size() < 4)
+     || (topic_namespace != p_match.levels[0]))
+  {
+    spdlog::debug("  handler [{}] not a sparkplug topic [{}]"sv, Id(), p_topic);
+    return;
+  }
+
+  const auto message_type = sparkplug::message_type(p_match.levels[2]);
+  if(sparkplug::MessageType::Other == message_type)
+  {
+    return;
+  }
+
+  m_node_key.assign(p_match.levels[1]);
+  m_node_key.push_back('/');
+  m_node_key.append(p_match.levels[3]);
+
+  const Message message{p_topic, &p_match, p_timestamp, p_metric_data};
+  bool valid = true;
+
+  switch(message_type)
+  {
+    case sparkplug::MessageType::NodeBirth:
+    case sparkplug::MessageType::Birth:
+    {
+      std::unique_lock lck{m_aliases->mutex()};
+
+      // A node's rebirth replaces the aliases of the node & its devices.
+      if(sparkplug::MessageType::NodeBirth == message_type)
+      {
+        m_aliases->erase(m_node_key);
+      }
+      auto & aliases = m_aliases->node(m_node_key);
+
+      valid = Decode(p_mqtt_data, message, [&aliases](const MetricValue & p_value, size_type p_name, DataType p_datatype) {
+        if(p_value.has_alias)
+        {
+          aliases.insert_or_assign(p_value.alias, sparkplug::Alias{p_name, p_datatype});
+        }
+      });
+      break;
+    }
+
+    case sparkplug::MessageType::Data:
+    {
+      std::shared_lock lck{m_aliases->mutex()};
+      const auto aliases = m_aliases->find(m_node_key);
+
+      valid = Decode(p_mqtt_data, message, [this, aliases](const MetricValue & p_value, size_type & p_name, DataType & p_datatype) {
+        if(!p_value.has_alias
+           || (!p_value.name.empty() && (DataType::Unknown != p_datatype)))
+        {
+          return;
+        }
+
+        const sparkplug::Alias * alias = nullptr;
+        if(nullptr != aliases)
+        {
+          if(auto alias_iter = aliases->find(p_value.alias);
+             aliases->end() != alias_iter)
+          {
+            alias = &alias_iter->second;
+          }
+        }
+
+        if(nullptr == alias)
+        {
+          if(p_value.name.empty())
+          {
+            m_alias_misses->Add(1);
+          }
+          return;
+        }
+
+        const auto & [name, datatype] = *alias;
+        if(p_value.name.empty())
+        {
+          p_name = name;
+        }
+        if(DataType::Unknown == p_datatype)
+        {
+          p_datatype = datatype;
+        }
+      });
+      break;
+    }
+
+    case sparkplug::MessageType::NodeDeath:
+    {
+      std::unique_lock lck{m_aliases->mutex()};
+      m_aliases->erase(m_node_key);
+      break;
+    }
+
+    default:
+      break;
+  }
+
+  if(!valid)
+  {
+    spdlog::debug("  handler [{}] invalid sparkplug payload topic [{}]"sv, Id(), p_topic);
+  }
+}
+
+} // namespace yafiyogi::mqtt_bridge
@@ -0,0 +1,210 @@
+/*
+
+  MIT License
+
+  Copyright (c) 2025 Yafiyogi
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <unordered_map>
+
+#include "yy_cpp/yy_types.hpp"
+#include "yy_cpp/yy_vector.h"
+#include "yy_mqtt/yy_mqtt_types.h"
+
+#include "yy_prometheus/yy_prometheus_metric_data.h"
+
+#include "bridge_stats.h"
+#include "mqtt_handler.h"
+#include "prometheus_metric.h"
+#include "protobuf_reader.h"
+#include "value_type.h"
+
+namespace yafiyogi::mqtt_bridge {
+namespace sparkplug {
+
+// Sparkplug B metric data types.
+enum class DataType:uint32_t {Unknown = 0,
+                              Int8 = 1,
+                              Int16 = 2,
+                              Int32 = 3,
+                              Int64 = 4,
+                              UInt8 = 5,
+                              UInt16 = 6,
+                              UInt32 = 7,
+                              UInt64 = 8,
+                              Float = 9,
+                              Double = 10,
+                              Boolean = 11,
+                              String = 12,
+                              DateTime = 13,
+                              Text = 14,
+                              UUID = 15};
+
+// The configured Sparkplug metric names & their metrics.
+class MetricNames final
+{
+  public:
+    using Metrics = prometheus::Metrics;
+    static constexpr size_type no_name = std::numeric_limits<size_type>::max();
+
+    struct Name final
+    {
+        std::string name{};
+        Metrics metrics{};
+    };
+
+    using container_type = yy_quad::simple_vector<Name>;
+    using const_iterator = container_type::const_iterator;
+
+    // Returns the name's metrics, and whether the name was added.
+    std::tuple<Metrics *, bool> add_name(std::string_view p_name,
+                                         Metrics && p_metrics);
+
+    [[nodiscard]]
+    size_type size() const noexcept
+    {
+      return m_names.size();
+    }
+
+    [[nodiscard]]
+    Name & operator[](size_type p_pos) noexcept
+    {
+      return m_names[p_pos];
+    }
+
+    [[nodiscard]]
+    const_iterator begin() const noexcept
+    {
+      return m_names.begin();
+    }
+
+    [[nodiscard]]
+    const_iterator end() const noexcept
+    {
+      return m_names.end();
+    }
+
+  private:
+    container_type m_names{};
+};
+
+class AliasTables;
+
+} // namespace sparkplug
+
+// Extracts Sparkplug B metrics from 'spBv1.0/<group>/<type>/<node>[/<device>]'
+// topics. NBIRTH & DBIRTH certificates define each edge node's metric
+// aliases, which NDATA & DDATA messages use instead of names. The alias
+// tables are shared by every worker's handler with the same id, as a
+// node's births & data may be received by different connections.
+// Payloads are decoded in place with a hand written protobuf reader.
+class MqttSparkplugHandler final:
+      public MqttHandler
+{
+  public:
+    using builder_type = sparkplug::MetricNames;
+    using DataType = sparkplug::DataType;
+
+    static constexpr std::string_view topic_namespace{"spBv1.0"};
+
+    explicit MqttSparkplugHandler(std::string_view p_handler_id,
+                                  builder_type && p_names,
+                                  size_type p_metric_count) noexcept;
+
+    MqttSparkplugHandler() = delete;
+    MqttSparkplugHandler(const MqttSparkplugHandler &) = delete;
+    MqttSparkplugHandler(MqttSparkplugHandler &&) noexcept = default;
+
+    MqttSparkplugHandler & operator=(const MqttSparkplugHandler &) = delete;
+    MqttSparkplugHandler & operator=(MqttSparkplugHandler &&) noexcept = default;
+
+    void Event(std::string_view p_mqtt_data,
+               const std::string_view p_topic,
+               const TopicMatch & p_match,
+               const timestamp_type p_timestamp,
+               yy_prometheus::MetricDataVectorPtr p_metric_data) noexcept override;
+
+  private:
+    struct name_hash final
+    {
+        using is_transparent = void;
+
+        std::size_t operator()(std::string_view p_str) const noexcept
+        {
+          return std::hash<std::string_view>{}(p_str);
+        }
+    };
+
+    struct MetricValue final
+    {
+        std::string_view name{};
+        std::uint64_t alias = 0;
+        bool has_alias = false;
+        DataType datatype = DataType::Unknown;
+        bool is_null = false;
+        // Field number of the value, or 0.
+        std::uint32_t value_field = 0;
+        std::uint64_t num = 0;
+        std::string_view str{};
+    };
+
+    struct Message final
+    {
+        std::string_view topic{};
+        const TopicMatch * match = nullptr;
+        timestamp_type timestamp{};
+        yy_prometheus::MetricDataVectorPtr metric_data{};
+    };
+
+    template<typename AliasFn>
+    bool Decode(std::string_view p_payload,
+                const Message & p_message,
+                AliasFn && p_alias);
+
+    static bool DecodeMetric(std::string_view p_metric,
+                             MetricValue & p_value) noexcept;
+
+    [[nodiscard]]
+    size_type FindName(std::string_view p_name) const noexcept;
+
+    void Emit(size_type p_name,
+              DataType p_datatype,
+              const MetricValue & p_value,
+              const Message & p_message) noexcept;
+
+    builder_type m_names;
+    std::unordered_map<std::string, size_type, name_hash, std::equal_to<>> m_name_index{};
+    std::shared_ptr<sparkplug::AliasTables> m_aliases{};
+    std::string m_node_key{};
+    stats::StatPtr m_alias_misses{};
+};
+
+} // namespace yafiyogi::mqtt_bridge
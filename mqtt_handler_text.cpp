@@ -0,0 +1,233 @@
+/*
+
+  MIT License
+
+  Copyright (c) 2025 Yafiyogi
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "re2/re2.h"
+#include "re2/set.h"
+#include "spdlog/spdlog.h"
+
+#include "yy_prometheus/yy_prometheus_metric_data.h"
+
+#include "prometheus_metric.h"
+
+#include "mqtt_handler_text.h"
+
+namespace yafiyogi::mqtt_bridge {
+
+using namespace std::string_view_literals;
+
+namespace text_handler_detail {
+namespace {
+
+// Names the group holding the value, otherwise it's the first group.
+const std::string g_value_group_name{"value"};
+
+re2::RE2::Options regex_options() noexcept
+{
+  re2::RE2::Options options{};
+  options.set_log_errors(false);
+
+  return options;
+}
+
+} // anonymous namespace
+
+std::tuple<TextPatterns::Metrics *, bool> TextPatterns::add_pattern(std::string_view p_pattern,
+                                                                   Metrics && p_metrics)
+{
+  for(auto & [pattern, metrics] : m_patterns)
+  {
+    if(pattern == p_pattern)
+    {
+      return {&metrics, false};
+    }
+  }
+
+  const size_type pos = m_patterns.size();
+  m_patterns.emplace_back(Pattern{std::string{p_pattern}, std::move(p_metrics)});
+
+  return {&m_patterns[pos].metrics, true};
+}
+
+} // namespace text_handler_detail
+
+MqttTextHandler::MqttTextHandler(std::string_view p_handler_id,
+                                 builder_type && p_patterns,
+                                 size_type p_metric_count) noexcept:
+  MqttHandler(p_handler_id, type::Text, p_metric_count),
+  m_set(text_handler_detail::regex_options(), re2::RE2::UNANCHORED)
+{
+  const auto options = text_handler_detail::regex_options();
+  builder_type patterns{std::move(p_patterns)};
+  int max_groups = 0;
+
+  m_extractors.reserve(patterns.size());
+  for(const auto & [pattern, metrics] : patterns)
+  {
+    std::string error{};
+    auto regex = std::make_unique<re2::RE2>(pattern, options);
+
+    // Set indices are sequential, so only add patterns that compile
+    // to keep them in step with m_extractors.
+    if(!regex->ok()
+       || (regex->NumberOfCapturingGroups() < 1)
+       || (-1 == m_set.Add(pattern, &error)))
+    {
+      spdlog::warn("  handler [{}] skipping pattern [{}] {}"sv,
+                   Id(),
+                   pattern,
+                   regex->ok() ? error : regex->error());
+      continue;
+    }
+
+    Extractor extractor{};
+    extractor.groups = regex->NumberOfCapturingGroups();
+    const auto & named_groups = regex->NamedCapturingGroups();
+    if(auto value_group = named_groups.find(text_handler_detail::g_value_group_name);
+       named_groups.end() != value_group)
+    {
+      extractor.value_group = value_group->second;
+    }
+
+    for(const auto & [group, name] : regex->CapturingGroupNames())
+    {
+      if(group != extractor.value_group)
+      {
+        extractor.labels.emplace_back(Label{group, name});
+      }
+    }
+    extractor.metrics = metrics;
+    extractor.regex = std::move(regex);
+
+    max_groups = std::max(max_groups, extractor.groups);
+    m_extractors.emplace_back(std::move(extractor));
+  }
+
+  if(!m_set.Compile())
+  {
+    spdlog::error("  handler [{}] failed to compile patterns"sv, Id());
+    m_extractors.clear(yy_data::ClearAction::Keep);
+  }
+
+  m_matches.reserve(m_extractors.size());
+  m_groups.resize(static_cast<std::size_t>(max_groups) + 1);
+
+  size_type max_labels = 0;
+  for(const auto & extractor : m_extractors)
+  {
+    max_labels = std::max(max_labels, extractor.labels.size());
+  }
+  m_captures.resize(max_labels);
+}
+
+bool MqttTextHandler::ValidPattern(std::string_view p_pattern,
+                                   std::string & p_error)
+{
+  re2::RE2 regex{p_pattern, text_handler_detail::regex_options()};
+
+  if(!regex.ok())
+  {
+    p_error = regex.error();
+    return false;
+  }
+
+  if(regex.NumberOfCapturingGroups() < 1)
+  {
+    p_error = "no capture group for the value";
+    return false;
+  }
+
+  return true;
+}
+
+void MqttTextHandler::Event(std::string_view p_mqtt_data,
+                            const std::string_view p_topic,
+                            const TopicMatch & p_match,
+                            const timestamp_type p_timestamp,
+                            yy_prometheus::MetricDataVectorPtr p_metric_data) noexcept
+{
+  spdlog::debug("  handler [{}]"sv, Id());
+
+  m_matches.clear();
+  if(m_extractors.empty()
+     || !m_set.Match(p_mqtt_data, &m_matches))
+  {
+    return;
+  }
+
+  for(const int match : m_matches)
+  {
+    auto & extractor = m_extractors[static_cast<size_type>(match)];
+
+    if(!extractor.regex->Match(p_mqtt_data,
+                               0,
+                               p_mqtt_data.size(),
+                               re2::RE2::UNANCHORED,
+                               m_groups.data(),
+                               extractor.groups + 1))
+    {
+      continue;
+    }
+
+    const auto & value_group = m_groups[static_cast<std::size_t>(extractor.value_group)];
+    if(nullptr == value_group.data())
+    {
+      // An optional value group that didn't take part in the match.
+      continue;
+    }
+    const std::string_view value{value_group.data(), value_group.size()};
+
+    size_type capture_count = 0;
+    for(const auto & [group, name] : extractor.labels)
+    {
+      const auto & label_group = m_groups[static_cast<std::size_t>(group)];
+      if(nullptr != label_group.data())
+      {
+        auto & capture = m_captures[capture_count++];
+        capture.name.assign(name);
+        capture.value.assign(label_group.data(), label_group.size());
+      }
+    }
+
+    const prometheus::Captures captures{m_captures.data(), capture_count};
+    for(auto & metric : extractor.metrics)
+    {
+      metric->Event(value,
+                    p_topic,
+                    p_match,
+                    p_timestamp,
+                    yy_values::ValueType::Unknown,
+                    p_metric_data,
+                    captures);
+    }
+  }
+}
+
+} // namespace yafiyogi::mqtt_bridge
@@ -0,0 +1,151 @@
+/*
+
+  MIT License
+
+  Copyright (c) 2025 Yafiyogi
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+#include "re2/re2.h"
+#include "re2/set.h"
+
+#include "yy_cpp/yy_types.hpp"
+#include "yy_cpp/yy_vector.h"
+#include "yy_mqtt/yy_mqtt_types.h"
+
+#include "yy_prometheus/yy_prometheus_metric_data.h"
+
+#include "mqtt_handler.h"
+#include "prometheus_metric.h"
+#include "value_type.h"
+
+namespace yafiyogi::mqtt_bridge {
+namespace text_handler_detail {
+
+// The configured regex patterns. A pattern's group named 'value', or
+// else its first group, is the property's value; any other named groups
+// are captured as labels.
+class TextPatterns final
+{
+  public:
+    using Metrics = prometheus::Metrics;
+
+    struct Pattern final
+    {
+        std::string pattern{};
+        Metrics metrics{};
+    };
+
+    using container_type = yy_quad::simple_vector<Pattern>;
+    using const_iterator = container_type::const_iterator;
+
+    // Returns the pattern's metrics, and whether the pattern was added.
+    std::tuple<Metrics *, bool> add_pattern(std::string_view p_pattern,
+                                            Metrics && p_metrics);
+
+    [[nodiscard]]
+    size_type size() const noexcept
+    {
+      return m_patterns.size();
+    }
+
+    [[nodiscard]]
+    const_iterator begin() const noexcept
+    {
+      return m_patterns.begin();
+    }
+
+    [[nodiscard]]
+    const_iterator end() const noexcept
+    {
+      return m_patterns.end();
+    }
+
+  private:
+    container_type m_patterns{};
+};
+
+} // namespace text_handler_detail
+
+// Extracts properties from a text payload with regex patterns. All the
+// patterns are compiled into one RE2::Set, so the payload is scanned
+// once to find which patterns match, and only those patterns are run
+// again to extract their capture groups.
+class MqttTextHandler final:
+      public MqttHandler
+{
+  public:
+    using builder_type = text_handler_detail::TextPatterns;
+
+    explicit MqttTextHandler(std::string_view p_handler_id,
+                             builder_type && p_patterns,
+                             size_type p_metric_count) noexcept;
+
+    MqttTextHandler() = delete;
+    MqttTextHandler(const MqttTextHandler &) = delete;
+    MqttTextHandler(MqttTextHandler &&) noexcept = default;
+
+    MqttTextHandler & operator=(const MqttTextHandler &) = delete;
+    MqttTextHandler & operator=(MqttTextHandler &&) noexcept = default;
+
+    void Event(std::string_view p_mqtt_data,
+               const std::string_view p_topic,
+               const TopicMatch & p_match,
+               const timestamp_type p_timestamp,
+               yy_prometheus::MetricDataVectorPtr p_metric_data) noexcept override;
+
+    // Checks a pattern compiles & has a capture group for the value.
+    [[nodiscard]]
+    static bool ValidPattern(std::string_view p_pattern,
+                             std::string & p_error);
+
+  private:
+    struct Label final
+    {
+        int group = 0;
+        std::string name{};
+    };
+
+    struct Extractor final
+    {
+        std::unique_ptr<re2::RE2> regex{};
+        int groups = 0;
+        int value_group = 1;
+        yy_quad::simple_vector<Label> labels{};
+        prometheus::Metrics metrics{};
+    };
+
+    re2::RE2::Set m_set;
+    yy_quad::simple_vector<Extractor> m_extractors{};
+    std::vector<int> m_matches{};
+    std::vector<re2::StringPiece> m_groups{};
+    std::vector<prometheus::Capture> m_captures{};
+};
+
+} // namespace yafiyogi::mqtt_bridge
@@ -48,7 +48,7 @@ MqttValueHandler::MqttValueHandler(std::string_view p_handler_id,
 
 void MqttValueHandler::Event(std::string_view p_mqtt_data,
                              const std::string_view p_topic,
-                             const yy_mqtt::TopicLevelsView & p_levels,
+                             const TopicMatch & p_match,
                              const timestamp_type p_timestamp,
                              yy_prometheus::MetricDataVectorPtr p_metric_data) noexcept
 {
@@ -58,7 +58,7 @@ void MqttValueHandler::Event(std::string_view p_mqtt_data,
   {
     metric->Event(p_mqtt_data,
                   p_topic,
-                  p_levels,
+                  p_match,
                   p_timestamp,
                   yy_values::ValueType::Unknown,
                   p_metric_data);
@@ -52,7 +52,7 @@ class MqttValueHandler final:
 
     void Event(std::string_view p_mqtt_data,
                const std::string_view p_topic,
-               const yy_mqtt::TopicLevelsView & p_levels,
+               const TopicMatch & p_match,
                const timestamp_type p_timestamp,
                yy_prometheus::MetricDataVectorPtr p_metric_data) noexcept override;
   private:
@@ -0,0 +1,375 @@
+/*
+
+  MIT License
+
+  Copyright (c) 2025 Yafiyogi
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+#include <algorithm>
+#include <string_view>
+
+#include "fmt/compile.h"
+#include "fmt/format.h"
+#include "spdlog/spdlog.h"
+
+#include "yy_mqtt/yy_mqtt_util.h"
+
+#include "yy_prometheus/yy_prometheus_cache.h"
+
+#include "mqtt_handler.h"
+
+#include "mqtt_ingest.h"
+
+namespace yafiyogi::mqtt_bridge {
+
+using namespace std::string_view_literals;
+using namespace fmt::literals;
+
+MqttIngest::MqttIngest(mqtt_ingest_config && p_config,
+                       yy_prometheus::MetricDataCachePtr p_metric_cache):
+  m_id(p_config.id),
+  m_handlers(std::move(p_config.handlers)),
+  m_topics(std::move(p_config.topics)),
+  m_routes(p_config.route_cache_size),
+  m_metric_cache(std::move(p_metric_cache))
+{
+  const auto labels{fmt::format("ingest=\"{}\""_cf, m_id)};
+
+  m_route_hits = stats::add_stat("mqtt_bridge_route_cache_hits_total"sv,
+                                 "Topics routed from the route cache."sv,
+                                 stats::StatType::Counter,
+                                 labels);
+  m_route_misses = stats::add_stat("mqtt_bridge_route_cache_misses_total"sv,
+                                   "Topics routed using the topic automaton."sv,
+                                   stats::StatType::Counter,
+                                   labels);
+  m_unchanged = stats::add_stat("mqtt_bridge_unchanged_payloads_total"sv,
+                                "Messages whose payload was unchanged, skipping 'skip_unchanged' handlers."sv,
+                                stats::StatType::Counter,
+                                labels);
+
+  bool has_decode = false;
+  for(size_type idx = 0; idx < m_handlers.size(); ++idx)
+  {
+    if(auto [id, handler] = m_handlers[idx];
+       handler)
+    {
+      m_has_lazy = m_has_lazy || handler->Lazy();
+      has_decode = has_decode || !handler->Decode().empty();
+    }
+  }
+
+  if(has_decode)
+  {
+    m_decoder.emplace(labels);
+  }
+
+  if(m_has_lazy)
+  {
+    m_lazy_stored = stats::add_stat("mqtt_bridge_lazy_payloads_total"sv,
+                                    "Payloads stored for lazy handlers."sv,
+                                    stats::StatType::Counter,
+                                    labels);
+    m_lazy_flushed = stats::add_stat("mqtt_bridge_lazy_flushes_total"sv,
+                                     "Stored payloads handled by lazy handlers."sv,
+                                     stats::StatType::Counter,
+                                     labels);
+
+    m_dirty.reserve(m_routes.capacity());
+    m_scrape_hook = add_scrape_hook([this]() { Flush(); });
+  }
+}
+
+MqttIngest::~MqttIngest() noexcept
+{
+  if(m_scrape_hook.has_value())
+  {
+    remove_scrape_hook(m_scrape_hook.value());
+  }
+}
+
+MqttIngest::RouteEntry & MqttIngest::Route(std::string_view p_topic)
+{
+  const auto hash = RouteCache::hash(p_topic);
+
+  if(auto entry = m_routes.find(p_topic, hash);
+     nullptr != entry)
+  {
+    m_route_hits->Add();
+    return *entry;
+  }
+
+  m_route_misses->Add();
+
+  // Don't lose the latest payload of an evicted topic.
+  auto do_evict = [this](RouteEntry & p_evicted) {
+    if(p_evicted.value.dirty)
+    {
+      FlushRoute(p_evicted);
+    }
+  };
+
+  auto & entry = m_routes.emplace(p_topic, hash, do_evict);
+  auto & route = entry.value;
+
+  route.handlers.clear(yy_data::ClearAction::Keep);
+  route.unchanged_handlers.clear(yy_data::ClearAction::Keep);
+  route.unchanged_data.clear(yy_data::ClearAction::Keep);
+  route.has_payload = false;
+  route.lazy_handlers.clear(yy_data::ClearAction::Keep);
+  route.dirty = false;
+
+  for(auto & topic_handlers : m_topics.find(p_topic))
+  {
+    const yy_data::observer_ptr<const TopicFilter> filter{&topic_handlers->filter};
+
+    for(auto & handler : topic_handlers->handlers)
+    {
+      if(handler->Lazy())
+      {
+        route.lazy_handlers.emplace_back(RouteHandler{handler, filter});
+      }
+      else if(handler->SkipUnchanged())
+      {
+        route.unchanged_handlers.emplace_back(RouteHandler{handler, filter});
+      }
+      else
+      {
+        route.handlers.emplace_back(RouteHandler{handler, filter});
+      }
+    }
+  }
+
+  if(m_decoder)
+  {
+    // Group handlers by decode chain, so each chain is decoded once.
+    auto by_decode = [](const RouteHandler & p_route_handler) -> const decode::Chain & {
+      return p_route_handler.handler->Decode();
+    };
+
+    std::ranges::stable_sort(route.handlers, {}, by_decode);
+    std::ranges::stable_sort(route.unchanged_handlers, {}, by_decode);
+    std::ranges::stable_sort(route.lazy_handlers, {}, by_decode);
+  }
+
+  // Levels are views of the entry's copy of the topic.
+  yy_mqtt::topic_tokenize_view(route.levels, entry.key);
+
+  return entry;
+}
+
+void MqttIngest::Process(std::string_view p_topic,
+                         std::string_view p_payload,
+                         const timestamp_type p_timestamp)
+{
+  if(m_metric_cache)
+  {
+    if(m_has_lazy)
+    {
+      std::unique_lock lck{m_mtx};
+
+      ProcessRoute(Route(p_topic), p_payload, p_timestamp);
+    }
+    else
+    {
+      ProcessRoute(Route(p_topic), p_payload, p_timestamp);
+    }
+  }
+}
+
+void MqttIngest::ProcessRoute(RouteEntry & p_entry,
+                              std::string_view p_payload,
+                              const timestamp_type p_timestamp)
+{
+  auto & route = p_entry.value;
+
+  if(!route.lazy_handlers.empty())
+  {
+    route.lazy_payload.assign(p_payload);
+    route.lazy_timestamp = p_timestamp;
+    m_lazy_stored->Add();
+
+    if(!route.dirty)
+    {
+      // An evicted route is flushed, but stays in m_dirty. Flush before
+      // stale entries grow m_dirty past the number of routes.
+      if(m_dirty.size() >= m_routes.capacity())
+      {
+        FlushDirty();
+      }
+
+      route.dirty = true;
+      m_dirty.emplace_back(&p_entry);
+    }
+  }
+
+  if(route.handlers.empty() && route.unchanged_handlers.empty())
+  {
+    return;
+  }
+
+  const std::string_view topic{p_entry.key};
+
+  spdlog::debug("Processing [{}] handlers=[{}]"sv,
+                topic,
+                route.handlers.size() + route.unchanged_handlers.size());
+
+  size_type metric_count = 0;
+  m_metric_data.clear(yy_data::ClearAction::Keep);
+  m_has_decoded = false;
+
+  if(!route.unchanged_handlers.empty())
+  {
+    // Compared in full: comparing the sizes rejects most changed
+    // payloads, and is no slower than hashing for unchanged payloads.
+    if(route.has_payload && (p_payload == route.unchanged_payload))
+    {
+      m_unchanged->Add();
+      spdlog::debug("  unchanged payload"sv);
+    }
+    else
+    {
+      route.unchanged_data.clear(yy_data::ClearAction::Keep);
+
+      yy_prometheus::MetricDataVectorPtr unchanged_data{&route.unchanged_data};
+      for(auto & [handler, filter] : route.unchanged_handlers)
+      {
+        if(auto payload = Payload(*handler, p_payload);
+           payload.has_value())
+        {
+          metric_count += handler->MetricCount();
+          route.unchanged_data.reserve(metric_count);
+
+          handler->Event(payload.value(), topic, TopicMatch{route.levels, *filter}, p_timestamp, unchanged_data);
+        }
+      }
+
+      route.unchanged_payload.assign(p_payload);
+      route.has_payload = true;
+    }
+
+    m_metric_data.reserve(route.unchanged_data.size());
+    for(auto & data : route.unchanged_data)
+    {
+      data.Timestamp(p_timestamp);
+      m_metric_data.emplace_back(data);
+    }
+    metric_count = m_metric_data.size();
+  }
+
+  yy_prometheus::MetricDataVectorPtr metric_data{&m_metric_data};
+  for(auto & [handler, filter] : route.handlers)
+  {
+    if(auto payload = Payload(*handler, p_payload);
+       payload.has_value())
+    {
+      metric_count += handler->MetricCount();
+      m_metric_data.reserve(metric_count);
+
+      handler->Event(payload.value(), topic, TopicMatch{route.levels, *filter}, p_timestamp, metric_data);
+    }
+  }
+
+  m_metric_cache->Add(m_metric_data);
+}
+
+void MqttIngest::Flush()
+{
+  if(m_has_lazy)
+  {
+    std::unique_lock lck{m_mtx};
+
+    FlushDirty();
+  }
+}
+
+void MqttIngest::FlushDirty()
+{
+  for(auto & entry : m_dirty)
+  {
+    if(entry->value.dirty)
+    {
+      FlushRoute(*entry);
+    }
+  }
+
+  m_dirty.clear(yy_data::ClearAction::Keep);
+}
+
+void MqttIngest::FlushRoute(RouteEntry & p_entry)
+{
+  auto & route = p_entry.value;
+  const std::string_view topic{p_entry.key};
+
+  route.dirty = false;
+  m_lazy_flushed->Add();
+
+  spdlog::debug("Processing lazy [{}] handlers=[{}]"sv,
+                topic,
+                route.lazy_handlers.size());
+
+  size_type metric_count = 0;
+  m_metric_data.clear(yy_data::ClearAction::Keep);
+  m_has_decoded = false;
+
+  yy_prometheus::MetricDataVectorPtr metric_data{&m_metric_data};
+  for(auto & [handler, filter] : route.lazy_handlers)
+  {
+    if(auto payload = Payload(*handler, route.lazy_payload);
+       payload.has_value())
+    {
+      metric_count += handler->MetricCount();
+      m_metric_data.reserve(metric_count);
+
+      handler->Event(payload.value(), topic, TopicMatch{route.levels, *filter}, route.lazy_timestamp, metric_data);
+    }
+  }
+
+  m_metric_cache->Add(m_metric_data);
+}
+
+std::optional<std::string_view> MqttIngest::Payload(const MqttHandler & p_handler,
+                                                    std::string_view p_payload) noexcept
+{
+  const auto & chain = p_handler.Decode();
+
+  if(chain.empty())
+  {
+    return p_payload;
+  }
+
+  if(!m_has_decoded || (chain != m_decoded_chain))
+  {
+    m_decoded = m_decoder->Decode(chain, p_payload);
+    m_decoded_chain = chain;
+    m_has_decoded = true;
+
+    if(!m_decoded.has_value())
+    {
+      spdlog::debug("  failed to decode payload for [{}]"sv, p_handler.Id());
+    }
+  }
+
+  return m_decoded;
+}
+
+} // namespace yafiyogi::mqtt_bridge
@@ -0,0 +1,184 @@
+/*
+
+  MIT License
+
+  Copyright (c) 2025 Yafiyogi
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "yy_cpp/yy_observer_ptr.hpp"
+#include "yy_cpp/yy_types.hpp"
+
+#include "yy_mqtt/yy_mqtt_types.h"
+
+#include "yy_prometheus/yy_prometheus_metric_data.h"
+
+#include "bridge_stats.h"
+#include "mqtt_handler_fwd.h"
+#include "mqtt_topics.h"
+#include "payload_decode.h"
+#include "scrape_hooks.h"
+#include "string_pool.h"
+#include "topic_cache.h"
+
+namespace yafiyogi::yy_prometheus {
+
+class MetricDataCache;
+using MetricDataCachePtr = std::shared_ptr<MetricDataCache>;
+
+} // namespace yafiyogi::yy_prometheus
+
+namespace yafiyogi::mqtt_bridge {
+
+// Each MqttIngest needs its own handlers (and their metrics), as
+// handlers keep per message scratch state.
+struct mqtt_ingest_config final
+{
+    static constexpr size_type default_route_cache_size = 32768;
+
+    size_type id = 0;
+    MqttHandlerStore handlers{};
+    Topics topics{};
+    size_type route_cache_size = default_route_cache_size;
+};
+
+using mqtt_ingest_configs = yy_quad::simple_vector<mqtt_ingest_config>;
+
+// A handler, and the filter that routed a topic to it.
+struct RouteHandler final
+{
+    yy_data::observer_ptr<MqttHandler> handler{};
+    yy_data::observer_ptr<const TopicFilter> filter{};
+};
+
+using RouteHandlers = yy_quad::simple_vector<RouteHandler>;
+
+// Handlers for a concrete topic, and the topic's levels.
+struct MqttRoute final
+{
+    RouteHandlers handlers{};
+    // Handlers skipped while the topic's payload is unchanged, the
+    // metrics they produced for the payload, and the payload.
+    RouteHandlers unchanged_handlers{};
+    yy_prometheus::MetricDataVector unchanged_data{};
+    std::string unchanged_payload{};
+    bool has_payload = false;
+    // Handlers run when metrics are scraped, for the latest payload.
+    RouteHandlers lazy_handlers{};
+    std::string lazy_payload{};
+    timestamp_type lazy_timestamp{};
+    bool dirty = false;
+    yy_mqtt::TopicLevelsView levels{};
+};
+
+// Routes an MQTT message to its handlers and adds the resulting
+// metrics to the cache.
+//
+// Owns the handlers, the topic automaton and the scratch buffers used
+// while processing a message, so an instance must only be used by one
+// thread at a time.
+//
+// Handlers with a decode chain are handed the decoded payload. Each
+// distinct chain of a route is decoded once per message, into buffers
+// shared by all of the route's handlers.
+//
+// Lazy handlers only store a topic's latest payload, which is handled
+// before the metrics are scraped (by a scrape hook, from the web
+// server's thread). If any handler is lazy, Process() & the hook are
+// serialized by a mutex.
+class MqttIngest final
+{
+  public:
+    explicit MqttIngest(mqtt_ingest_config && p_config,
+                        yy_prometheus::MetricDataCachePtr p_metric_cache);
+
+    MqttIngest() = delete;
+    MqttIngest(const MqttIngest &) = delete;
+    MqttIngest(MqttIngest &&) = delete;
+    ~MqttIngest() noexcept;
+
+    MqttIngest & operator=(const MqttIngest &) = delete;
+    MqttIngest & operator=(MqttIngest &&) = delete;
+
+    void Process(std::string_view p_topic,
+                 std::string_view p_payload,
+                 const timestamp_type p_timestamp);
+
+    [[nodiscard]]
+    constexpr size_type Id() const noexcept
+    {
+      return m_id;
+    }
+
+    // Handles the latest payload of topics with lazy handlers.
+    void Flush();
+
+  private:
+    using RouteCache = TopicCache<MqttRoute, InternedString>;
+    using RouteEntry = RouteCache::Entry;
+    using DirtyRoutes = yy_quad::simple_vector<yy_data::observer_ptr<RouteEntry>>;
+
+    RouteEntry & Route(std::string_view p_topic);
+    void ProcessRoute(RouteEntry & p_entry,
+                      std::string_view p_payload,
+                      const timestamp_type p_timestamp);
+    void FlushRoute(RouteEntry & p_entry);
+    void FlushDirty();
+    // p_payload decoded for p_handler, or std::nullopt if decoding failed.
+    std::optional<std::string_view> Payload(const MqttHandler & p_handler,
+                                            std::string_view p_payload) noexcept;
+
+    size_type m_id = 0;
+    MqttHandlerStore m_handlers{};
+    Topics m_topics{};
+    // Caches topic matches so the Topics automaton is only used for
+    // topics not seen recently. Rebuilt with the Topics it caches.
+    RouteCache m_routes;
+    yy_prometheus::MetricDataVector m_metric_data{};
+    yy_prometheus::MetricDataCachePtr m_metric_cache{};
+    stats::StatPtr m_route_hits{};
+    stats::StatPtr m_route_misses{};
+    stats::StatPtr m_unchanged{};
+    DirtyRoutes m_dirty{};
+    bool m_has_lazy = false;
+    std::mutex m_mtx{};
+    std::optional<ScrapeHookId> m_scrape_hook{};
+    stats::StatPtr m_lazy_stored{};
+    stats::StatPtr m_lazy_flushed{};
+    std::optional<decode::Decoder> m_decoder{};
+    // The chain decoded for the current message, and its result.
+    decode::Chain m_decoded_chain{};
+    std::optional<std::string_view> m_decoded{};
+    bool m_has_decoded = false;
+};
+
+using MqttIngestPtr = std::unique_ptr<MqttIngest>;
+using MqttIngests = yy_quad::simple_vector<MqttIngestPtr>;
+
+} // namespace yafiyogi::mqtt_bridge
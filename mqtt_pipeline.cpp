@@ -0,0 +1,562 @@
+/*
+
+  MIT License
+
+  Copyright (c) 2025 Yafiyogi
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <functional>
+#include <string>
+#include <string_view>
+
+#include "fmt/compile.h"
+#include "fmt/format.h"
+#include "spdlog/spdlog.h"
+
+#include "mqtt_handler.h"
+#include "mqtt_handler_sparkplug.h"
+
+#include "mqtt_pipeline.h"
+
+namespace yafiyogi::mqtt_bridge {
+
+using namespace std::string_view_literals;
+using namespace fmt::literals;
+
+namespace pipeline_detail {
+
+namespace {
+
+// Longest a worker waits for a retained message token before checking
+// for live messages.
+constexpr std::chrono::milliseconds g_max_token_wait{1};
+
+} // anonymous namespace
+
+TokenBucket::TokenBucket(size_type p_rate,
+                         size_type p_burst) noexcept:
+  m_tokens(static_cast<double>(std::max(p_burst, size_type{1}))),
+  m_tokens_per_ns(static_cast<double>(p_rate) / 1'000'000'000.0),
+  m_burst(static_cast<double>(std::max(p_burst, size_type{1}))),
+  m_last(clock_type::now())
+{
+}
+
+void TokenBucket::Refill(const clock_type::time_point p_now) noexcept
+{
+  if(p_now > m_last)
+  {
+    const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(p_now - m_last).count();
+
+    m_tokens = std::min(m_burst, m_tokens + (static_cast<double>(elapsed) * m_tokens_per_ns));
+    m_last = p_now;
+  }
+}
+
+bool TokenBucket::Take(const clock_type::time_point p_now) noexcept
+{
+  Refill(p_now);
+
+  if(m_tokens < 1.0)
+  {
+    return false;
+  }
+
+  m_tokens -= 1.0;
+
+  return true;
+}
+
+TokenBucket::clock_type::duration TokenBucket::Wait(const clock_type::time_point p_now) const noexcept
+{
+  if((m_tokens >= 1.0) || (0.0 == m_tokens_per_ns))
+  {
+    return clock_type::duration::zero();
+  }
+
+  const auto elapsed = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(p_now - m_last).count());
+  const auto wait_ns = ((1.0 - m_tokens) / m_tokens_per_ns) - elapsed;
+
+  return std::chrono::duration_cast<clock_type::duration>(std::chrono::nanoseconds{static_cast<std::int64_t>(std::max(wait_ns, 0.0))});
+}
+
+Worker::Worker(size_type p_id,
+               MqttIngestPtr && p_ingest,
+               size_type p_queue_size,
+               OverloadPolicy p_overload,
+               const RetainedConfig & p_retained):
+  m_id(p_id),
+  m_queue(p_queue_size),
+  m_ingest(std::move(p_ingest)),
+  m_overload(p_overload),
+  m_retained_tokens(p_retained.rate, p_retained.burst)
+{
+  const auto labels{fmt::format("ingest=\"{}\""_cf, m_ingest->Id())};
+
+  m_high_watermark = stats::add_stat("mqtt_bridge_ingest_queue_high_watermark"sv,
+                                     "Most messages queued for a worker."sv,
+                                     stats::StatType::Gauge,
+                                     labels);
+  m_blocked = stats::add_stat("mqtt_bridge_ingest_queue_blocked_total"sv,
+                              "Messages the network thread waited to queue."sv,
+                              stats::StatType::Counter,
+                              labels);
+  m_dropped = stats::add_stat("mqtt_bridge_ingest_queue_dropped_total"sv,
+                              "Messages dropped as a worker's queue was full."sv,
+                              stats::StatType::Counter,
+                              labels);
+  m_replaced = stats::add_stat("mqtt_bridge_ingest_queue_replaced_total"sv,
+                               "Queued messages replaced by a newer message for the topic."sv,
+                               stats::StatType::Counter,
+                               labels);
+
+  if(OverloadPolicy::DropOldest == m_overload)
+  {
+    m_queued_topics.reserve(m_queue.capacity());
+  }
+
+  if(0 != p_retained.rate)
+  {
+    m_retained = std::make_unique<IngestQueue>(p_retained.queue_size);
+
+    m_retained_count = stats::add_stat("mqtt_bridge_retained_messages_total"sv,
+                                       "Retained messages processed at the retained message rate."sv,
+                                       stats::StatType::Counter,
+                                       labels);
+    m_retained_stale = stats::add_stat("mqtt_bridge_retained_messages_stale_total"sv,
+                                       "Retained messages skipped as a live message for the topic was processed first."sv,
+                                       stats::StatType::Counter,
+                                       labels);
+    m_retained_live = stats::add_stat("mqtt_bridge_retained_messages_live_total"sv,
+                                      "Retained messages processed as live messages as the retained queue was full."sv,
+                                      stats::StatType::Counter,
+                                      labels);
+    m_warm_time = stats::add_stat("mqtt_bridge_retained_warm_milliseconds"sv,
+                                  "Time from connecting to processing the last queued retained message."sv,
+                                  stats::StatType::Gauge,
+                                  labels);
+  }
+}
+
+Worker::~Worker() noexcept
+{
+  Join();
+}
+
+void Worker::Start()
+{
+  m_thread = std::thread{[this]() { Run(); }};
+}
+
+void Worker::Connected(const TokenBucket::clock_type::time_point p_connected) noexcept
+{
+  m_connected.store(p_connected.time_since_epoch().count(), std::memory_order_relaxed);
+}
+
+void Worker::Signal() noexcept
+{
+  m_pending.fetch_add(1, std::memory_order_release);
+  m_pending.notify_one();
+}
+
+void Worker::Push(std::string_view p_topic,
+                  std::string_view p_payload,
+                  const timestamp_type p_timestamp,
+                  bool p_retained)
+{
+  if(p_retained && m_retained)
+  {
+    if(PushRetained(p_topic, p_payload, p_timestamp))
+    {
+      return;
+    }
+
+    m_retained_live->Add();
+  }
+
+  auto message = m_queue.try_acquire();
+
+  if(nullptr == message)
+  {
+    switch(m_overload)
+    {
+      case OverloadPolicy::DropOldest:
+        if(Replace(p_topic, p_payload, p_timestamp))
+        {
+          m_replaced->Add();
+          return;
+        }
+        [[fallthrough]];
+
+      case OverloadPolicy::DropNewest:
+        m_dropped->Add();
+        return;
+
+      case OverloadPolicy::Block:
+        [[fallthrough]];
+      default:
+        m_blocked->Add();
+        message = &m_queue.acquire();
+        break;
+    }
+  }
+
+  const size_type pos = m_queue.tail();
+
+  message->topic.assign(p_topic);
+  message->payload.assign(p_payload);
+  message->timestamp = p_timestamp;
+  message->pos = pos;
+  message->stop = false;
+  message->status.store(IngestMessage::state::Queued, std::memory_order_relaxed);
+
+  if(OverloadPolicy::DropOldest == m_overload)
+  {
+    // Forget topics whose messages have all been consumed.
+    if(m_queued_topics.size() >= (2 * m_queue.capacity()))
+    {
+      const size_type head = m_queue.head();
+
+      std::erase_if(m_queued_topics, [head](const auto & queued) {
+        return queued.second < head;
+      });
+    }
+
+    if(auto queued = m_queued_topics.find(p_topic);
+       m_queued_topics.end() != queued)
+    {
+      queued->second = pos;
+    }
+    else
+    {
+      m_queued_topics.emplace(std::string{p_topic}, pos);
+    }
+  }
+
+  m_queue.publish();
+  Signal();
+  m_high_watermark->Max(pos + 1 - m_queue.head());
+}
+
+bool Worker::PushRetained(std::string_view p_topic,
+                          std::string_view p_payload,
+                          const timestamp_type p_timestamp)
+{
+  auto message = m_retained->try_acquire();
+  if(nullptr == message)
+  {
+    return false;
+  }
+
+  message->topic.assign(p_topic);
+  message->payload.assign(p_payload);
+  message->timestamp = p_timestamp;
+  message->stop = false;
+  message->status.store(IngestMessage::state::Processing, std::memory_order_relaxed);
+
+  m_retained->publish();
+  Signal();
+
+  return true;
+}
+
+bool Worker::Replace(std::string_view p_topic,
+                     std::string_view p_payload,
+                     const timestamp_type p_timestamp)
+{
+  auto queued = m_queued_topics.find(p_topic);
+  if(m_queued_topics.end() == queued)
+  {
+    return false;
+  }
+
+  const size_type pos = queued->second;
+  if(pos < m_queue.head())
+  {
+    // Already consumed.
+    return false;
+  }
+
+  // Only the producer re-fills slots, so the slot still holds the
+  // message at 'pos'. Claim it unless the worker already has.
+  auto & message = m_queue.slot(pos);
+  auto status = IngestMessage::state::Queued;
+  if(!message.status.compare_exchange_strong(status,
+                                             IngestMessage::state::Replacing,
+                                             std::memory_order_acquire))
+  {
+    return false;
+  }
+
+  message.payload.assign(p_payload);
+  message.timestamp = p_timestamp;
+  message.status.store(IngestMessage::state::Queued, std::memory_order_release);
+
+  return true;
+}
+
+void Worker::Stop() noexcept
+{
+  if(m_thread.joinable())
+  {
+    auto & message = m_queue.acquire();
+
+    message.stop = true;
+    message.status.store(IngestMessage::state::Queued, std::memory_order_relaxed);
+
+    m_queue.publish();
+    Signal();
+  }
+}
+
+void Worker::Join() noexcept
+{
+  if(m_thread.joinable())
+  {
+    m_thread.join();
+  }
+}
+
+void Worker::Process(IngestMessage & p_message) noexcept
+{
+  try
+  {
+    m_ingest->Process(p_message.topic, p_message.payload, p_message.timestamp);
+  }
+  catch(const std::exception & ex)
+  {
+    spdlog::error("MQTT worker [{}] exception caught [{}]"sv, m_id, ex.what());
+  }
+  catch(...)
+  {
+    spdlog::error("MQTT worker [{}] exception caught!"sv, m_id);
+  }
+}
+
+void Worker::Run() noexcept
+{
+  spdlog::debug("MQTT worker [{}] started."sv, m_id);
+
+  for(;;)
+  {
+    // Read before checking the queues, so a message published after
+    // they are checked ends the wait.
+    const auto pending = m_pending.load(std::memory_order_acquire);
+
+    if(auto message = m_queue.front();
+       nullptr != message)
+    {
+      if(message->stop)
+      {
+        m_queue.pop();
+        break;
+      }
+
+      if(OverloadPolicy::DropOldest == m_overload)
+      {
+        // Wait out the producer replacing the payload.
+        auto status = IngestMessage::state::Queued;
+        while(!message->status.compare_exchange_weak(status,
+                                                     IngestMessage::state::Processing,
+                                                     std::memory_order_acquire))
+        {
+          status = IngestMessage::state::Queued;
+          std::this_thread::yield();
+        }
+      }
+
+      if(m_retained && (nullptr != m_retained->front()))
+      {
+        m_live_topics.emplace(message->topic);
+      }
+
+      Process(*message);
+      m_queue.pop();
+      continue;
+    }
+
+    // Live messages take priority over retained messages.
+    if(m_retained)
+    {
+      if(auto message = m_retained->front();
+         nullptr != message)
+      {
+        const auto now = TokenBucket::clock_type::now();
+
+        if(m_live_topics.contains(message->topic))
+        {
+          m_retained->pop();
+          m_retained_stale->Add();
+        }
+        else if(m_retained_tokens.Take(now))
+        {
+          Process(*message);
+          m_retained->pop();
+          m_retained_count->Add();
+        }
+        else
+        {
+          std::this_thread::sleep_for(std::min(std::chrono::duration_cast<TokenBucket::clock_type::duration>(g_max_token_wait),
+                                               m_retained_tokens.Wait(now)));
+          continue;
+        }
+
+        if(nullptr == m_retained->front())
+        {
+          m_live_topics.clear();
+
+          const TokenBucket::clock_type::duration connected{m_connected.load(std::memory_order_relaxed)};
+          const auto warm = TokenBucket::clock_type::now().time_since_epoch() - connected;
+
+          m_warm_time->Set(static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(warm).count()));
+        }
+        continue;
+      }
+    }
+
+    m_pending.wait(pending, std::memory_order_acquire);
+  }
+
+  spdlog::debug("MQTT worker [{}] stopped."sv, m_id);
+}
+
+} // namespace pipeline_detail
+
+namespace {
+
+// A Sparkplug node's births, data & deaths are published on different
+// topics ('spBv1.0/<group>/<type>/<node>[/<device>]'), but must be
+// handled in order, so they're sharded by '<group>/<node>'.
+std::size_t shard_hash(std::string_view p_topic) noexcept
+{
+  constexpr std::string_view sparkplug_prefix{"spBv1.0/"};
+  static_assert(sparkplug_prefix.starts_with(MqttSparkplugHandler::topic_namespace));
+
+  if(!p_topic.starts_with(sparkplug_prefix))
+  {
+    return std::hash<std::string_view>{}(p_topic);
+  }
+
+  std::string_view levels[4]{};
+  std::string_view rest{p_topic};
+  for(auto & level : levels)
+  {
+    const auto pos = rest.find('/');
+    if(std::string_view::npos == pos)
+    {
+      level = rest;
+      rest = std::string_view{};
+      break;
+    }
+    level = rest.substr(0, pos);
+    rest.remove_prefix(pos + 1);
+  }
+
+  if(levels[3].empty())
+  {
+    // e.g. 'spBv1.0/STATE/<host>'.
+    return std::hash<std::string_view>{}(p_topic);
+  }
+
+  const std::size_t group_hash = std::hash<std::string_view>{}(levels[1]);
+  const std::size_t node_hash = std::hash<std::string_view>{}(levels[3]);
+
+  return group_hash ^ (node_hash + 0x9e3779b97f4a7c15ULL + (group_hash << 6) + (group_hash >> 2));
+}
+
+} // anonymous namespace
+
+MqttPipeline::MqttPipeline(MqttIngests && p_ingests,
+                           size_type p_queue_size,
+                           OverloadPolicy p_overload,
+                           const RetainedConfig & p_retained)
+{
+  m_workers.reserve(p_ingests.size());
+
+  for(auto & ingest : p_ingests)
+  {
+    m_workers.emplace_back(std::make_unique<pipeline_detail::Worker>(m_workers.size(),
+                                                                     std::move(ingest),
+                                                                     p_queue_size,
+                                                                     p_overload,
+                                                                     p_retained));
+  }
+}
+
+MqttPipeline::~MqttPipeline() noexcept
+{
+  Stop();
+}
+
+void MqttPipeline::Start()
+{
+  if(!m_running)
+  {
+    for(auto & worker : m_workers)
+    {
+      worker->Start();
+    }
+    m_running = true;
+  }
+}
+
+void MqttPipeline::Connected() noexcept
+{
+  const auto now = pipeline_detail::TokenBucket::clock_type::now();
+
+  for(auto & worker : m_workers)
+  {
+    worker->Connected(now);
+  }
+}
+
+void MqttPipeline::Push(std::string_view p_topic,
+                        std::string_view p_payload,
+                        const timestamp_type p_timestamp,
+                        bool p_retained)
+{
+  const size_type shard = shard_hash(p_topic) % m_workers.size();
+
+  m_workers[shard]->Push(p_topic, p_payload, p_timestamp, p_retained);
+}
+
+void MqttPipeline::Stop() noexcept
+{
+  if(m_running)
+  {
+    for(auto & worker : m_workers)
+    {
+      worker->Stop();
+    }
+
+    for(auto & worker : m_workers)
+    {
+      worker->Join();
+    }
+    m_running = false;
+  }
+}
+
+} // namespace yafiyogi::mqtt_bridge
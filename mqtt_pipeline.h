@@ -0,0 +1,246 @@
+/*
+
+  MIT License
+
+  Copyright (c) 2025 Yafiyogi
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <cstdint>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "yy_cpp/yy_types.hpp"
+#include "yy_cpp/yy_vector.h"
+
+#include "bridge_stats.h"
+#include "mqtt_ingest.h"
+#include "spsc_ring.h"
+
+namespace yafiyogi::mqtt_bridge {
+
+// What a worker does with a message when its queue is full.
+// - Block      : the network thread waits for the worker.
+// - DropNewest : the message is dropped.
+// - DropOldest : the message replaces the payload of a queued message
+//                for the same topic, otherwise it is dropped.
+enum class OverloadPolicy:uint8_t {Block, DropNewest, DropOldest};
+
+// Retained messages (e.g. those sent by the broker on (re)subscribing)
+// are queued separately and processed when a worker has no live
+// messages, at most 'rate' per second per worker in bursts of up to
+// 'burst'. A zero rate processes retained messages as live messages.
+struct RetainedConfig final
+{
+    static constexpr size_type default_burst = 100;
+    static constexpr size_type default_queue_size = 16384;
+
+    size_type rate = 0;
+    size_type burst = default_burst;
+    size_type queue_size = default_queue_size;
+};
+
+namespace pipeline_detail {
+
+class TokenBucket final
+{
+  public:
+    using clock_type = std::chrono::steady_clock;
+
+    explicit TokenBucket(size_type p_rate,
+                         size_type p_burst) noexcept;
+
+    TokenBucket() = delete;
+    constexpr TokenBucket(const TokenBucket &) noexcept = default;
+    constexpr TokenBucket(TokenBucket &&) noexcept = default;
+
+    constexpr TokenBucket & operator=(const TokenBucket &) noexcept = default;
+    constexpr TokenBucket & operator=(TokenBucket &&) noexcept = default;
+
+    // Takes a token if one is available.
+    [[nodiscard]]
+    bool Take(const clock_type::time_point p_now) noexcept;
+
+    // Time until a token is available.
+    [[nodiscard]]
+    clock_type::duration Wait(const clock_type::time_point p_now) const noexcept;
+
+  private:
+    void Refill(const clock_type::time_point p_now) noexcept;
+
+    double m_tokens = 0.0;
+    double m_tokens_per_ns = 0.0;
+    double m_burst = 0.0;
+    clock_type::time_point m_last{};
+};
+
+struct IngestMessage final
+{
+    // A DropOldest producer may replace a queued message's payload, so
+    // the consumer claims a message before processing it.
+    enum class state:uint8_t {Queued, Replacing, Processing};
+
+    std::string topic{};
+    std::string payload{};
+    timestamp_type timestamp{};
+    size_type pos = 0;
+    std::atomic<state> status{state::Queued};
+    bool stop = false;
+};
+
+using IngestQueue = SpscRing<IngestMessage>;
+
+struct string_hash final
+{
+    using is_transparent = void;
+
+    std::size_t operator()(std::string_view p_str) const noexcept
+    {
+      return std::hash<std::string_view>{}(p_str);
+    }
+};
+
+// Queue position of each topic's most recently queued message.
+using QueuedTopics = std::unordered_map<std::string, size_type, string_hash, std::equal_to<>>;
+using LiveTopics = std::unordered_set<std::string, string_hash, std::equal_to<>>;
+
+class Worker final
+{
+  public:
+    explicit Worker(size_type p_id,
+                    MqttIngestPtr && p_ingest,
+                    size_type p_queue_size,
+                    OverloadPolicy p_overload,
+                    const RetainedConfig & p_retained);
+
+    Worker() = delete;
+    Worker(const Worker &) = delete;
+    Worker(Worker &&) = delete;
+    ~Worker() noexcept;
+
+    Worker & operator=(const Worker &) = delete;
+    Worker & operator=(Worker &&) = delete;
+
+    void Start();
+    void Connected(const TokenBucket::clock_type::time_point p_connected) noexcept;
+    void Push(std::string_view p_topic,
+              std::string_view p_payload,
+              const timestamp_type p_timestamp,
+              bool p_retained);
+    void Stop() noexcept;
+    void Join() noexcept;
+
+  private:
+    bool PushRetained(std::string_view p_topic,
+                      std::string_view p_payload,
+                      const timestamp_type p_timestamp);
+    bool Replace(std::string_view p_topic,
+                 std::string_view p_payload,
+                 const timestamp_type p_timestamp);
+    void Signal() noexcept;
+    void Process(IngestMessage & p_message) noexcept;
+    void Run() noexcept;
+
+    size_type m_id = 0;
+    IngestQueue m_queue;
+    MqttIngestPtr m_ingest{};
+    OverloadPolicy m_overload = OverloadPolicy::Block;
+    QueuedTopics m_queued_topics{};
+    stats::StatPtr m_high_watermark{};
+    stats::StatPtr m_blocked{};
+    stats::StatPtr m_dropped{};
+    stats::StatPtr m_replaced{};
+    // Retained messages. Not allocated if retained messages aren't
+    // throttled.
+    std::unique_ptr<IngestQueue> m_retained{};
+    TokenBucket m_retained_tokens;
+    std::atomic<TokenBucket::clock_type::rep> m_connected{0};
+    // Topics with live messages processed while retained messages are
+    // queued. Their retained messages are stale.
+    LiveTopics m_live_topics{};
+    stats::StatPtr m_retained_count{};
+    stats::StatPtr m_retained_stale{};
+    stats::StatPtr m_retained_live{};
+    stats::StatPtr m_warm_time{};
+    // Bumped by the producer after publishing to either queue, so the
+    // worker can wait for both.
+    std::atomic<std::uint32_t> m_pending{0};
+    std::thread m_thread{};
+};
+
+using WorkerPtr = std::unique_ptr<Worker>;
+
+} // namespace pipeline_detail
+
+// Decouples the MQTT network thread from message processing.
+//
+// The network thread copies each message into the queue of a worker
+// chosen by topic hash, so the messages a connection receives for a
+// topic are processed in order by the same worker. Sparkplug topics are
+// hashed by '<group>/<node>', so a node's births, data & deaths are
+// processed in order too. Each worker owns its own MqttIngest.
+class MqttPipeline final
+{
+  public:
+    explicit MqttPipeline(MqttIngests && p_ingests,
+                          size_type p_queue_size,
+                          OverloadPolicy p_overload,
+                          const RetainedConfig & p_retained);
+
+    MqttPipeline() = delete;
+    MqttPipeline(const MqttPipeline &) = delete;
+    MqttPipeline(MqttPipeline &&) = delete;
+    ~MqttPipeline() noexcept;
+
+    MqttPipeline & operator=(const MqttPipeline &) = delete;
+    MqttPipeline & operator=(MqttPipeline &&) = delete;
+
+    void Start();
+
+    // Starts timing how long retained messages take to process.
+    void Connected() noexcept;
+
+    // Push() & Stop() must be called from the same (producer) thread.
+    void Push(std::string_view p_topic,
+              std::string_view p_payload,
+              const timestamp_type p_timestamp,
+              bool p_retained);
+    void Stop() noexcept;
+
+  private:
+    using Workers = yy_quad::simple_vector<pipeline_detail::WorkerPtr>;
+
+    Workers m_workers{};
+    bool m_running = false;
+};
+
+using MqttPipelinePtr = std::unique_ptr<MqttPipeline>;
+
+} // namespace yafiyogi::mqtt_bridge
@@ -33,12 +33,31 @@
 #include "yy_mqtt/yy_mqtt_variant_state_topics.h"
 
 #include "mqtt_handler_fwd.h"
+#include "topic_match.h"
 
 namespace yafiyogi::mqtt_bridge {
 
-using Subscriptions = yy_quad::simple_vector<std::string>;
-
-using TopicsConfig = yy_mqtt::variant_state_topics<MqttHandlerList>;
+struct Subscription final
+{
+    std::string filter{};
+    int qos = 0;
+    // Subscribed to by the first connection only, without the
+    // '$share/<group>/' prefix. Shared subscriptions aren't sent
+    // retained messages.
+    bool exclusive = false;
+};
+
+using Subscriptions = yy_quad::simple_vector<Subscription>;
+
+// The handlers of a filter. The Topics automaton returns the
+// TopicHandlers of each filter matching a topic.
+struct TopicHandlers final
+{
+    TopicFilter filter{};
+    MqttHandlerList handlers{};
+};
+
+using TopicsConfig = yy_mqtt::variant_state_topics<TopicHandlers>;
 using Topics = TopicsConfig::automaton_type;
 
 } // namespace yafiyogi::mqtt_bridge
@@ -0,0 +1,182 @@
+/*
+
+  MIT License
+
+  Copyright (c) 2025 Yafiyogi
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+#include <charconv>
+#include <cmath>
+#include <string_view>
+#include <system_error>
+
+#include "numeric_value.h"
+
+namespace yafiyogi::mqtt_bridge {
+
+using namespace std::string_view_literals;
+
+namespace {
+
+constexpr std::string_view g_space{" \t\r\n"};
+
+template<typename T>
+std::string_view to_chars(NumberBuffer & p_buffer,
+                          T p_value) noexcept
+{
+  auto [ptr, ec] = std::to_chars(p_buffer.data(), p_buffer.data() + p_buffer.size(), p_value);
+
+  return std::string_view{p_buffer.data(), static_cast<std::string_view::size_type>(ptr - p_buffer.data())};
+}
+
+template<typename T>
+std::string_view format_float(NumberBuffer & p_buffer,
+                              T p_value) noexcept
+{
+  if(std::isnan(p_value))
+  {
+    return "NaN"sv;
+  }
+
+  if(std::isinf(p_value))
+  {
+    return p_value < 0 ? "-Inf"sv : "+Inf"sv;
+  }
+
+  return to_chars(p_buffer, p_value);
+}
+
+template<typename T>
+std::errc from_chars(std::string_view p_text,
+                     T & p_value) noexcept
+{
+  const char * end = p_text.data() + p_text.size();
+  auto [ptr, ec] = std::from_chars(p_text.data(), end, p_value);
+
+  if((std::errc{} == ec) && (ptr != end))
+  {
+    return std::errc::invalid_argument;
+  }
+
+  return ec;
+}
+
+} // anonymous namespace
+
+std::optional<NumericValue> NumericValue::Parse(std::string_view p_text) noexcept
+{
+  if(const auto begin = p_text.find_first_not_of(g_space);
+     std::string_view::npos == begin)
+  {
+    return std::nullopt;
+  }
+  else
+  {
+    p_text = p_text.substr(begin, p_text.find_last_not_of(g_space) + 1 - begin);
+  }
+
+  if("true"sv == p_text)
+  {
+    return NumericValue{true};
+  }
+
+  if("false"sv == p_text)
+  {
+    return NumericValue{false};
+  }
+
+  if('+' == p_text[0])
+  {
+    p_text.remove_prefix(1);
+    if(p_text.empty() || ('-' == p_text[0]))
+    {
+      return std::nullopt;
+    }
+  }
+
+  if(std::string_view::npos == p_text.find_first_of(".eEiInN"sv))
+  {
+    if('-' == p_text[0])
+    {
+      std::int64_t num = 0;
+      if(const auto ec = from_chars(p_text, num);
+         std::errc{} == ec)
+      {
+        return NumericValue{num};
+      }
+      else if(std::errc::result_out_of_range != ec)
+      {
+        return std::nullopt;
+      }
+    }
+    else
+    {
+      std::uint64_t num = 0;
+      if(const auto ec = from_chars(p_text, num);
+         std::errc{} == ec)
+      {
+        return NumericValue{num};
+      }
+      else if(std::errc::result_out_of_range != ec)
+      {
+        return std::nullopt;
+      }
+    }
+  }
+
+  double num = 0;
+  if(std::errc{} != from_chars(p_text, num))
+  {
+    return std::nullopt;
+  }
+
+  return NumericValue{num};
+}
+
+std::string_view NumericValue::Format(NumberBuffer & p_buffer) const noexcept
+{
+  switch(m_type)
+  {
+    case yy_values::ValueType::Int:
+      return to_chars(p_buffer, m_int);
+
+    case yy_values::ValueType::UInt:
+      return to_chars(p_buffer, m_uint);
+
+    case yy_values::ValueType::Float:
+      if(m_single)
+      {
+        return format_float(p_buffer, static_cast<float>(m_float));
+      }
+      return format_float(p_buffer, m_float);
+
+    case yy_values::ValueType::Bool:
+      return m_bool ? "true"sv : "false"sv;
+
+    default:
+      break;
+  }
+
+  return std::string_view{};
+}
+
+} // namespace yafiyogi::mqtt_bridge
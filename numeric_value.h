@@ -0,0 +1,141 @@
+/*
+
+  MIT License
+
+  Copyright (c) 2025 Yafiyogi
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+#include "yy_values/yy_value_type.hpp"
+
+namespace yafiyogi::mqtt_bridge {
+
+using NumberBuffer = std::array<char, 32>;
+
+// A payload value parsed once into its numeric type, so it is only
+// converted back to text when it is added to a metric.
+class NumericValue final
+{
+  public:
+    constexpr NumericValue() noexcept = default;
+
+    constexpr explicit NumericValue(std::int64_t p_value) noexcept:
+      m_int(p_value),
+      m_type(yy_values::ValueType::Int)
+    {
+    }
+
+    constexpr explicit NumericValue(std::uint64_t p_value) noexcept:
+      m_uint(p_value),
+      m_type(yy_values::ValueType::UInt)
+    {
+    }
+
+    constexpr explicit NumericValue(double p_value) noexcept:
+      m_float(p_value),
+      m_type(yy_values::ValueType::Float)
+    {
+    }
+
+    // Formatted as a float, so e.g. 0.1f isn't 0.10000000149011612.
+    constexpr explicit NumericValue(float p_value) noexcept:
+      m_float(p_value),
+      m_type(yy_values::ValueType::Float),
+      m_single(true)
+    {
+    }
+
+    constexpr explicit NumericValue(bool p_value) noexcept:
+      m_bool(p_value),
+      m_type(yy_values::ValueType::Bool)
+    {
+    }
+
+    constexpr NumericValue(const NumericValue &) noexcept = default;
+    constexpr NumericValue(NumericValue &&) noexcept = default;
+    constexpr ~NumericValue() noexcept = default;
+
+    constexpr NumericValue & operator=(const NumericValue &) noexcept = default;
+    constexpr NumericValue & operator=(NumericValue &&) noexcept = default;
+
+    // Parses 'true', 'false', an integer or a float (including 'nan' &
+    // 'inf'), ignoring surrounding white space & a leading '+'.
+    // Integers too large for 64 bits are parsed as floats. Returns
+    // std::nullopt if p_text isn't all a number.
+    [[nodiscard]]
+    static std::optional<NumericValue> Parse(std::string_view p_text) noexcept;
+
+    [[nodiscard]]
+    constexpr yy_values::ValueType Type() const noexcept
+    {
+      return m_type;
+    }
+
+    // The value as a double, e.g. for aggregation.
+    [[nodiscard]]
+    constexpr double AsDouble() const noexcept
+    {
+      switch(m_type)
+      {
+        case yy_values::ValueType::Int:
+          return static_cast<double>(m_int);
+
+        case yy_values::ValueType::UInt:
+          return static_cast<double>(m_uint);
+
+        case yy_values::ValueType::Float:
+          return m_float;
+
+        case yy_values::ValueType::Bool:
+          return m_bool ? 1.0 : 0.0;
+
+        default:
+          break;
+      }
+
+      return 0.0;
+    }
+
+    // Shortest text that parses back to the same value. Non finite
+    // floats are written as 'NaN', '+Inf' & '-Inf'.
+    [[nodiscard]]
+    std::string_view Format(NumberBuffer & p_buffer) const noexcept;
+
+  private:
+    union
+    {
+        std::int64_t m_int = 0;
+        std::uint64_t m_uint;
+        double m_float;
+        bool m_bool;
+    };
+    yy_values::ValueType m_type = yy_values::ValueType::Unknown;
+    bool m_single = false;
+};
+
+} // namespace yafiyogi::mqtt_bridge
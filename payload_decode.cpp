@@ -0,0 +1,315 @@
+/*
+
+  MIT License
+
+  Copyright (c) 2025 Yafiyogi
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <new>
+
+#include "zlib.h"
+
+#include "payload_decode.h"
+
+namespace yafiyogi::mqtt_bridge::decode {
+
+using namespace std::string_view_literals;
+
+namespace {
+
+constexpr std::int8_t base64_skip = -1;
+constexpr std::int8_t base64_invalid = -2;
+
+// Standard & URL safe alphabets. White space is skipped, and '=' ends
+// the data.
+constexpr std::array<std::int8_t, 256> base64_table = []() {
+  std::array<std::int8_t, 256> table{};
+  table.fill(base64_invalid);
+
+  constexpr std::string_view alphabet{"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789"};
+  for(size_type idx = 0; idx < alphabet.size(); ++idx)
+  {
+    table[static_cast<std::uint8_t>(alphabet[idx])] = static_cast<std::int8_t>(idx);
+  }
+
+  table[static_cast<std::uint8_t>('+')] = 62;
+  table[static_cast<std::uint8_t>('-')] = 62;
+  table[static_cast<std::uint8_t>('/')] = 63;
+  table[static_cast<std::uint8_t>('_')] = 63;
+
+  for(auto ch : " \t\r\n"sv)
+  {
+    table[static_cast<std::uint8_t>(ch)] = base64_skip;
+  }
+
+  return table;
+}();
+
+constexpr size_type min_inflate_size = 256;
+constexpr size_type inflate_ratio = 4;
+
+constexpr int window_bits(Stage p_stage) noexcept
+{
+  switch(p_stage)
+  {
+    case Stage::Gzip:
+      return 16 + MAX_WBITS;
+
+    case Stage::Deflate:
+      return -MAX_WBITS;
+
+    default:
+      break;
+  }
+
+  return MAX_WBITS;
+}
+
+} // anonymous namespace
+
+std::string_view stage_name(Stage p_stage) noexcept
+{
+  switch(p_stage)
+  {
+    case Stage::Base64:
+      return "base64"sv;
+
+    case Stage::Gzip:
+      return "gzip"sv;
+
+    case Stage::Deflate:
+      return "deflate"sv;
+
+    case Stage::Zlib:
+      return "zlib"sv;
+
+    case Stage::None:
+      break;
+  }
+
+  return "none"sv;
+}
+
+void Decoder::InflateEnd::operator()(z_stream_s * p_zstream) const noexcept
+{
+  inflateEnd(p_zstream);
+  delete p_zstream;
+}
+
+Decoder::Decoder(std::string_view p_labels,
+                 size_type p_max_size):
+  m_max_size(p_max_size)
+{
+  m_input_bytes = stats::add_stat("mqtt_bridge_decode_input_bytes_total"sv,
+                                  "Bytes of encoded payloads decoded before handling."sv,
+                                  stats::StatType::Counter,
+                                  p_labels);
+  m_output_bytes = stats::add_stat("mqtt_bridge_decode_output_bytes_total"sv,
+                                   "Bytes of decoded payloads."sv,
+                                   stats::StatType::Counter,
+                                   p_labels);
+  m_microseconds = stats::add_stat("mqtt_bridge_decode_microseconds_total"sv,
+                                   "Time spent decoding payloads."sv,
+                                   stats::StatType::Counter,
+                                   p_labels);
+  m_failures = stats::add_stat("mqtt_bridge_decode_failures_total"sv,
+                               "Payloads that failed to decode, and weren't handled."sv,
+                               stats::StatType::Counter,
+                               p_labels);
+}
+
+Decoder::~Decoder() noexcept = default;
+
+std::optional<std::string_view> Decoder::Decode(const Chain & p_chain,
+                                                std::string_view p_payload) noexcept
+{
+  using clock_type = std::chrono::steady_clock;
+  const auto start = clock_type::now();
+
+  std::string_view data{p_payload};
+  size_type buffer_idx = 0;
+
+  for(auto stage : p_chain)
+  {
+    auto & output = m_buffers[buffer_idx];
+    buffer_idx ^= 1;
+
+    bool decoded = false;
+    try
+    {
+      decoded = (Stage::Base64 == stage)
+                ? Base64(data, output)
+                : Inflate(stage, data, output);
+    }
+    catch(const std::bad_alloc &)
+    {
+      // e.g. a large payload, or one inflating to near the max size.
+    }
+
+    if(!decoded)
+    {
+      m_failures->Add();
+      return std::nullopt;
+    }
+
+    data = output;
+  }
+
+  const auto decode_time = std::chrono::duration_cast<std::chrono::microseconds>(clock_type::now() - start);
+
+  m_input_bytes->Add(p_payload.size());
+  m_output_bytes->Add(data.size());
+  m_microseconds->Add(static_cast<std::uint64_t>(decode_time.count()));
+
+  return data;
+}
+
+bool Decoder::Base64(std::string_view p_input,
+                     std::string & p_output)
+{
+  // Resizing within the buffer's capacity doesn't allocate.
+  p_output.resize(((p_input.size() + 3) / 4) * 3);
+
+  size_type size = 0;
+  std::uint32_t bits = 0;
+  size_type sextets = 0;
+
+  for(auto ch : p_input)
+  {
+    if('=' == ch)
+    {
+      break;
+    }
+
+    const auto value = base64_table[static_cast<std::uint8_t>(ch)];
+    if(base64_skip == value)
+    {
+      continue;
+    }
+    if(base64_invalid == value)
+    {
+      return false;
+    }
+
+    bits = (bits << 6) | static_cast<std::uint32_t>(value);
+    ++sextets;
+
+    if(4 == sextets)
+    {
+      p_output[size++] = static_cast<char>(bits >> 16);
+      p_output[size++] = static_cast<char>(bits >> 8);
+      p_output[size++] = static_cast<char>(bits);
+      bits = 0;
+      sextets = 0;
+    }
+  }
+
+  switch(sextets)
+  {
+    case 1:
+      // A single sextet can't encode a byte.
+      return false;
+
+    case 2:
+      p_output[size++] = static_cast<char>(bits >> 4);
+      break;
+
+    case 3:
+      p_output[size++] = static_cast<char>(bits >> 10);
+      p_output[size++] = static_cast<char>(bits >> 2);
+      break;
+
+    default:
+      break;
+  }
+
+  p_output.resize(size);
+
+  return true;
+}
+
+bool Decoder::Inflate(Stage p_stage,
+                      std::string_view p_input,
+                      std::string & p_output)
+{
+  const int bits = window_bits(p_stage);
+
+  if(!m_zstream)
+  {
+    std::unique_ptr<z_stream_s, InflateEnd> zstream{new z_stream{}};
+
+    if(Z_OK != inflateInit2(zstream.get(), bits))
+    {
+      // Nothing to end.
+      delete zstream.release();
+      return false;
+    }
+
+    m_zstream = std::move(zstream);
+  }
+  else if(Z_OK != inflateReset2(m_zstream.get(), bits))
+  {
+    return false;
+  }
+
+  auto & zstream = *m_zstream;
+
+  zstream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(p_input.data()));
+  zstream.avail_in = static_cast<uInt>(p_input.size());
+
+  p_output.resize(std::min(std::max({p_output.capacity(), p_input.size() * inflate_ratio, min_inflate_size}),
+                           m_max_size));
+
+  size_type size = 0;
+  while(true)
+  {
+    zstream.next_out = reinterpret_cast<Bytef *>(p_output.data() + size);
+    zstream.avail_out = static_cast<uInt>(p_output.size() - size);
+
+    const int rc = inflate(&zstream, Z_NO_FLUSH);
+    size = p_output.size() - zstream.avail_out;
+
+    if(Z_STREAM_END == rc)
+    {
+      break;
+    }
+
+    if(((Z_OK != rc) && (Z_BUF_ERROR != rc))
+       || (0 != zstream.avail_out) // Truncated stream.
+       || (p_output.size() >= m_max_size))
+    {
+      return false;
+    }
+
+    p_output.resize(std::min(p_output.size() * 2, m_max_size));
+  }
+
+  p_output.resize(size);
+
+  return true;
+}
+
+} // namespace yafiyogi::mqtt_bridge::decode
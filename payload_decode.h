@@ -0,0 +1,160 @@
+/*
+
+  MIT License
+
+  Copyright (c) 2025 Yafiyogi
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <array>
+#include <compare>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "yy_cpp/yy_types.hpp"
+
+#include "bridge_stats.h"
+
+struct z_stream_s;
+
+namespace yafiyogi::mqtt_bridge::decode {
+
+enum class Stage:uint8_t {None, Base64, Gzip, Deflate, Zlib};
+
+// Decode stages run, in order, on a payload before it is handled.
+class Chain final
+{
+  public:
+    static constexpr size_type max_stages = 4;
+
+    using const_iterator = const Stage *;
+
+    constexpr Chain() noexcept = default;
+    constexpr Chain(const Chain &) noexcept = default;
+    constexpr Chain(Chain &&) noexcept = default;
+    constexpr ~Chain() noexcept = default;
+
+    constexpr Chain & operator=(const Chain &) noexcept = default;
+    constexpr Chain & operator=(Chain &&) noexcept = default;
+
+    constexpr auto operator<=>(const Chain &) const noexcept = default;
+
+    // Returns false if the chain is full.
+    constexpr bool add_stage(Stage p_stage) noexcept
+    {
+      if(m_size == max_stages)
+      {
+        return false;
+      }
+
+      m_stages[m_size] = p_stage;
+      ++m_size;
+
+      return true;
+    }
+
+    [[nodiscard]]
+    constexpr bool empty() const noexcept
+    {
+      return 0 == m_size;
+    }
+
+    [[nodiscard]]
+    constexpr size_type size() const noexcept
+    {
+      return m_size;
+    }
+
+    [[nodiscard]]
+    constexpr const_iterator begin() const noexcept
+    {
+      return m_stages.data();
+    }
+
+    [[nodiscard]]
+    constexpr const_iterator end() const noexcept
+    {
+      return m_stages.data() + m_size;
+    }
+
+  private:
+    std::array<Stage, max_stages> m_stages{};
+    size_type m_size = 0;
+};
+
+[[nodiscard]]
+std::string_view stage_name(Stage p_stage) noexcept;
+
+// Runs decode chains on payloads. Its buffers & inflate context are
+// re-used, so memory only grows for a payload that decodes larger than
+// any before it. Not thread safe: each ingest worker has its own.
+class Decoder final
+{
+  public:
+    // Decoded payloads larger than this fail, guarding against
+    // decompression bombs.
+    static constexpr size_type default_max_size = size_type{16} * 1024 * 1024;
+
+    explicit Decoder(std::string_view p_labels,
+                     size_type p_max_size = default_max_size);
+
+    Decoder() = delete;
+    Decoder(const Decoder &) = delete;
+    Decoder(Decoder &&) = delete;
+    ~Decoder() noexcept;
+
+    Decoder & operator=(const Decoder &) = delete;
+    Decoder & operator=(Decoder &&) = delete;
+
+    // The decoded payload, or std::nullopt if a stage fails, including
+    // running out of memory. The view is valid until the next call.
+    [[nodiscard]]
+    std::optional<std::string_view> Decode(const Chain & p_chain,
+                                           std::string_view p_payload) noexcept;
+
+  private:
+    struct InflateEnd final
+    {
+        void operator()(z_stream_s * p_zstream) const noexcept;
+    };
+
+    // Both throw std::bad_alloc if the output can't be allocated.
+    bool Base64(std::string_view p_input,
+                std::string & p_output);
+    bool Inflate(Stage p_stage,
+                 std::string_view p_input,
+                 std::string & p_output);
+
+    std::unique_ptr<z_stream_s, InflateEnd> m_zstream{};
+    std::array<std::string, 2> m_buffers{};
+    size_type m_max_size = default_max_size;
+    stats::StatPtr m_input_bytes{};
+    stats::StatPtr m_output_bytes{};
+    stats::StatPtr m_microseconds{};
+    stats::StatPtr m_failures{};
+};
+
+} // namespace yafiyogi::mqtt_bridge::decode
@@ -36,6 +36,10 @@
 #include "yy_prometheus/yy_prometheus_metric_format.h"
 #include "yy_prometheus/yy_prometheus_cache.h"
 
+#include "bridge_stats.h"
+#include "distribution.h"
+#include "scrape_hooks.h"
+
 #include "prometheus_civetweb_handler.h"
 
 namespace yafiyogi::mqtt_bridge::prometheus {
@@ -100,12 +104,18 @@ bool PrometheusWebHandler::DoGet(struct mg_connection * conn,
     metric_data.Format(m_body);
   };
 
+  // Handle deferred messages before their metrics are read.
+  run_scrape_hooks();
+
   m_body.clear();
   if(m_metric_cache)
   {
     m_metric_cache->Visit(do_serialize_metrics);
   }
 
+  distributions::format_distributions(m_body);
+  stats::format_stats(m_body);
+
   m_header.clear();
   fmt::format_to(std::back_inserter(m_header),
                  g_http_response_format,
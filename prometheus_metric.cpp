@@ -24,6 +24,7 @@
 
 */
 
+#include <memory>
 #include <string>
 #include <string_view>
 
@@ -44,18 +45,27 @@ Metric::Metric(yy_values::MetricId && p_id,
                const Metric::MetricType p_metric_type,
                const MetricUnit p_metric_unit,
                const MetricTimestamp p_metric_timestamp,
+               labels::ReplacePaths && p_replace_paths,
                LabelActions && p_label_actions,
+               values::ValueProgram && p_value_program,
                ValueActions && p_value_actions,
-               LabelActions && p_metric_property_actions) noexcept:
+               LabelActions && p_metric_property_actions,
+               distributions::FamilyPtr p_distribution,
+               size_type p_label_cache_size):
   m_id(p_id),
   m_metric_data(std::move(p_id), yy_values::Labels{}, ""sv, p_metric_type, p_metric_unit),
   m_property(std::move(p_property)),
+  m_replace_paths(std::move(p_replace_paths)),
   m_label_actions(std::move(p_label_actions)),
+  m_value_program(std::move(p_value_program)),
   m_value_actions(std::move(p_value_actions)),
   m_metric_property_actions(std::move(p_metric_property_actions)),
   m_metric_properties(m_metric_property_actions.size()),
   m_metric_type(p_metric_type),
-  m_metric_unit(p_metric_unit)
+  m_metric_unit(p_metric_unit),
+  m_label_cache(p_label_cache_size),
+  m_distribution(std::move(p_distribution)),
+  m_series_cache_size(p_label_cache_size)
 {
   switch(p_metric_timestamp)
   {
@@ -83,47 +93,147 @@ const std::string & Metric::Property() const noexcept
 
 void Metric::Event(std::string_view p_value,
                    const std::string_view p_topic,
-                   const yy_mqtt::TopicLevelsView & p_levels,
+                   const TopicMatch & p_match,
                    const timestamp_type p_timestamp,
                    yy_values::ValueType p_value_type,
-                   MetricDataVectorPtr p_metric_data)
+                   MetricDataVectorPtr p_metric_data,
+                   Captures p_captures)
 {
+  if(!m_value_program.empty())
+  {
+    // Text is only parsed as a number by expressions, so switches
+    // match it as received.
+    Apply(values::Value{p_value, p_value_type}, p_topic, p_match, p_timestamp, p_metric_data, p_captures);
+    return;
+  }
+
+  Update(values::Value{p_value, p_value_type}, p_topic, p_match, p_timestamp, p_metric_data, p_captures);
+}
+
+void Metric::Event(const NumericValue & p_value,
+                   const std::string_view p_topic,
+                   const TopicMatch & p_match,
+                   const timestamp_type p_timestamp,
+                   MetricDataVectorPtr p_metric_data,
+                   Captures p_captures)
+{
+  if(!m_value_program.empty())
+  {
+    Apply(values::Value{p_value}, p_topic, p_match, p_timestamp, p_metric_data, p_captures);
+    return;
+  }
+
+  Update(values::Value{p_value}, p_topic, p_match, p_timestamp, p_metric_data, p_captures);
+}
+
+void Metric::Apply(values::Value p_value,
+                   const std::string_view p_topic,
+                   const TopicMatch & p_match,
+                   const timestamp_type p_timestamp,
+                   MetricDataVectorPtr p_metric_data,
+                   Captures p_captures)
+{
+  if(!m_value_program.Run(p_value))
+  {
+    spdlog::debug("    [{}] property=[{}] value isn't a number"sv,
+                  Id().Name(),
+                  m_property);
+    return;
+  }
+
+  Update(p_value, p_topic, p_match, p_timestamp, p_metric_data, p_captures);
+}
+
+void Metric::Update(const values::Value & p_value,
+                    const std::string_view p_topic,
+                    const TopicMatch & p_match,
+                    const timestamp_type p_timestamp,
+                    MetricDataVectorPtr p_metric_data,
+                    Captures p_captures)
+{
+  const std::string_view value_text = p_value.Text(m_number);
+  yy_values::ValueType value_type = p_value.Type();
+
   spdlog::debug("    [{}] property=[{}] [{}]"sv,
                 Id().Name(),
                 m_property,
-                p_value);
+                value_text);
 
   m_metric_data.Id(m_id);
   m_metric_data.MetricType(m_metric_type);
   m_metric_data.MetricUnit(m_metric_unit);
   m_metric_data.MetricFormat(m_metric_format);
-  m_metric_data.Value(p_value);
-  m_metric_data.Type(p_value_type);
+  m_metric_data.Value(value_text);
+  m_metric_data.Type(value_type);
   m_metric_data.Timestamp(p_timestamp);
 
-  m_metric_properties.clear(yy_data::ClearAction::Keep);
-  m_metric_properties.set_label(yy_values::g_label_topic, std::string{p_topic});
-
-  for(const auto & action : m_metric_property_actions)
+  yy_data::observer_ptr<distributions::Series> series{};
+  const auto topic_hash = LabelCache::hash(p_topic);
+  if(auto cached = m_label_cache.find(p_topic, topic_hash);
+     nullptr != cached)
   {
-    action->Apply(m_metric_properties, p_levels, m_metric_properties);
+    m_metric_data.Location(cached->value.location.str());
+    series = cached->value.series.get();
+
+    auto & l_labels = m_metric_data.Labels();
+    l_labels.clear(yy_data::ClearAction::Keep);
+    for(const auto & label : cached->value.labels)
+    {
+      l_labels.set_label(label.name.str(), label.value.str());
+    }
   }
+  else
+  {
+    ApplyLabelActions(p_topic, p_match);
 
-  m_metric_data.Location(m_metric_properties.get_label(yy_values::g_label_location));
+    auto & entry = m_label_cache.emplace(p_topic, topic_hash);
+    auto & cached_labels = entry.value.labels;
 
-  auto & l_labels = m_metric_data.Labels();
+    cached_labels.clear();
+    m_metric_data.Labels().visit([&cached_labels](const auto & label,
+                                                  const auto & value) {
+      cached_labels.emplace_back(CachedLabel{InternedString{label},
+                                             InternedString{value}});
+    });
+    entry.value.location = InternedString{m_metric_properties.get_label(yy_values::g_label_location)};
+    entry.value.series = m_distribution ? AddSeries() : distributions::SeriesPtr{};
+    series = entry.value.series.get();
+  }
 
-  l_labels.clear(yy_data::ClearAction::Keep);
-  l_labels.set_label(yy_values::g_label_location, m_metric_data.Id().Location());
-  l_labels.set_label(yy_values::g_label_topic, std::string{p_topic});
-  for(const auto & action : m_label_actions)
+  for(const auto & capture : p_captures)
   {
-    action->Apply(m_metric_properties, p_levels, l_labels);
+    m_metric_data.Labels().set_label(capture.name, capture.value);
   }
 
   for(const auto & action : m_value_actions)
   {
-    action->Apply(m_metric_data, p_value_type);
+    action->Apply(m_metric_data, value_type);
+  }
+
+  if(m_distribution)
+  {
+    if(!p_captures.empty())
+    {
+      series = CapturedSeries(p_topic, p_captures);
+    }
+
+    // Numbers are only parsed again if a value action rewrote them.
+    if(p_value.IsNumber()
+       && (m_value_actions.empty() || (value_text == m_metric_data.Value())))
+    {
+      series->Observe(p_value.Number().AsDouble(), p_timestamp);
+    }
+    else if(auto value = NumericValue::Parse(m_metric_data.Value());
+            value.has_value())
+    {
+      series->Observe(value.value().AsDouble(), p_timestamp);
+    }
+
+    // Aggregates are published as well as the value.
+    if(distributions::DistributionType::Aggregate != m_distribution->Type())
+    {
+      return;
+    }
   }
 
   if(spdlog::level::debug >= spdlog::get_level())
@@ -137,4 +247,76 @@ void Metric::Event(std::string_view p_value,
   p_metric_data->swap_data_back(m_metric_data);
 }
 
+distributions::SeriesPtr Metric::AddSeries()
+{
+  m_series_labels.clear();
+  m_metric_data.Labels().visit([this](const auto & label,
+                                      const auto & value) {
+    distributions::append_label(m_series_labels, label, value);
+  });
+
+  return m_distribution->AddSeries(m_series_labels);
+}
+
+distributions::Series * Metric::CapturedSeries(const std::string_view p_topic,
+                                              Captures p_captures)
+{
+  if(!m_series_cache)
+  {
+    m_series_cache = std::make_unique<SeriesCache>(m_series_cache_size);
+  }
+
+  m_series_key.assign(p_topic);
+  for(const auto & capture : p_captures)
+  {
+    m_series_key.push_back('\0');
+    m_series_key.append(capture.name);
+    m_series_key.push_back('\0');
+    m_series_key.append(capture.value);
+  }
+
+  const auto key_hash = SeriesCache::hash(m_series_key);
+  if(auto cached = m_series_cache->find(m_series_key, key_hash);
+     nullptr != cached)
+  {
+    return cached->value.get();
+  }
+
+  auto & entry = m_series_cache->emplace(m_series_key, key_hash);
+  entry.value = AddSeries();
+
+  return entry.value.get();
+}
+
+void Metric::ApplyLabelActions(const std::string_view p_topic,
+                               const TopicMatch & p_match)
+{
+  const std::string topic{p_topic};
+
+  m_metric_properties.clear(yy_data::ClearAction::Keep);
+  m_metric_properties.set_label(yy_values::g_label_topic, topic);
+
+  for(const auto & action : m_metric_property_actions)
+  {
+    action->Apply(m_metric_properties, p_match.levels, m_metric_properties);
+  }
+
+  m_metric_data.Location(m_metric_properties.get_label(yy_values::g_label_location));
+
+  auto & l_labels = m_metric_data.Labels();
+
+  l_labels.clear(yy_data::ClearAction::Keep);
+  l_labels.set_label(yy_values::g_label_location, m_metric_data.Id().Location());
+  l_labels.set_label(yy_values::g_label_topic, topic);
+  for(auto & replace_path : m_replace_paths)
+  {
+    replace_path.Apply(p_match, l_labels);
+  }
+
+  for(const auto & action : m_label_actions)
+  {
+    action->Apply(m_metric_properties, p_match.levels, l_labels);
+  }
+}
+
 } // namespace yafiyogi::mqtt_bridge::prometheus
@@ -27,8 +27,10 @@
 #pragma once
 
 #include <memory>
+#include <span>
 #include <string>
 #include <string_view>
+#include <vector>
 
 #include "yy_cpp/yy_vector.h"
 #include "yy_cpp/yy_flat_map.h"
@@ -42,8 +44,25 @@
 #include "yy_values/yy_value_action.hpp"
 #include "yy_values/yy_value_type.hpp"
 
+#include "distribution.h"
+#include "numeric_value.h"
+#include "replace_path.h"
+#include "string_pool.h"
+#include "topic_cache.h"
+#include "topic_match.h"
+#include "value_program.h"
+
 namespace yafiyogi::mqtt_bridge::prometheus {
 
+// A label captured from a payload, e.g. by a wildcard json pointer.
+struct Capture final
+{
+    std::string name{};
+    std::string value{};
+};
+
+using Captures = std::span<const Capture>;
+
 class Metric final
 {
   public:
@@ -58,20 +77,26 @@ class Metric final
     using MetricDataVector = yy_prometheus::MetricDataVector;
     using MetricDataVectorPtr = yy_prometheus::MetricDataVectorPtr;
 
+    static constexpr size_type default_label_cache_size = 4096;
+
     explicit Metric(yy_values::MetricId && p_id,
                     std::string && p_property,
                     const Metric::MetricType p_metric_type,
                     const MetricUnit p_metric_unit,
                     const MetricTimestamp p_metric_timestamp,
+                    labels::ReplacePaths && p_replace_paths,
                     LabelActions && p_label_actions,
+                    values::ValueProgram && p_value_program,
                     ValueActions && p_value_actions,
-                    LabelActions && p_metric_property_actions) noexcept;
+                    LabelActions && p_metric_property_actions,
+                    distributions::FamilyPtr p_distribution,
+                    size_type p_label_cache_size);
 
-    constexpr Metric() noexcept = default;
-    constexpr Metric(const Metric &) noexcept = default;
-    constexpr Metric(Metric &&) noexcept = default;
+    Metric() = delete;
+    Metric(const Metric &) = delete;
+    Metric(Metric &&) noexcept = default;
 
-    Metric & operator=(const Metric &) noexcept = default;
+    Metric & operator=(const Metric &) = delete;
     Metric & operator=(Metric &&) noexcept = default;
 
     [[nodiscard]]
@@ -80,26 +105,102 @@ class Metric final
     [[nodiscard]]
     const std::string & Property() const noexcept;
 
+    // Histograms, summaries & aggregates observe every value.
+    [[nodiscard]]
+    bool ObservesEveryValue() const noexcept
+    {
+      return static_cast<bool>(m_distribution);
+    }
+
+    // A text value is published as is, unless a value action changes
+    // it.
     void Event(std::string_view p_value,
                const std::string_view p_topic,
-               const yy_mqtt::TopicLevelsView & p_levels,
+               const TopicMatch & p_match,
                const timestamp_type p_timestamp,
                yy_values::ValueType p_value_type,
-               MetricDataVectorPtr p_metric_data);
+               MetricDataVectorPtr p_metric_data,
+               Captures p_captures = Captures{});
+
+    // The value is formatted as the shortest text that round trips.
+    void Event(const NumericValue & p_value,
+               const std::string_view p_topic,
+               const TopicMatch & p_match,
+               const timestamp_type p_timestamp,
+               MetricDataVectorPtr p_metric_data,
+               Captures p_captures = Captures{});
 
   private:
+    // Labels only depend on the topic (and its levels), so are cached
+    // per topic. Repeat messages only update the value & timestamp.
+    // Captured labels are set after the cached labels.
+    // Topics & labels are interned as they repeat across metrics.
+    struct CachedLabel final
+    {
+        InternedString name{};
+        InternedString value{};
+    };
+
+    struct CachedLabels final
+    {
+        std::vector<CachedLabel> labels{};
+        InternedString location{};
+        distributions::SeriesPtr series{};
+    };
+
+    using LabelCache = TopicCache<CachedLabels, InternedString>;
+    // Series of captured labels, keyed by topic & captures.
+    using SeriesCache = TopicCache<distributions::SeriesPtr>;
+    using SeriesCachePtr = std::unique_ptr<SeriesCache>;
+
+    // The replace paths are the leading 'replace-path' label actions,
+    // so run before the other label actions.
+    void ApplyLabelActions(const std::string_view p_topic,
+                           const TopicMatch & p_match);
+    // Runs the value program, then adds the value.
+    void Apply(values::Value p_value,
+               const std::string_view p_topic,
+               const TopicMatch & p_match,
+               const timestamp_type p_timestamp,
+               MetricDataVectorPtr p_metric_data,
+               Captures p_captures);
+    // The distribution's series for the current labels.
+    distributions::SeriesPtr AddSeries();
+    // The distribution's series for the current labels, cached by
+    // topic & captures.
+    distributions::Series * CapturedSeries(const std::string_view p_topic,
+                                          Captures p_captures);
+    void Update(const values::Value & p_value,
+                const std::string_view p_topic,
+                const TopicMatch & p_match,
+                const timestamp_type p_timestamp,
+                MetricDataVectorPtr p_metric_data,
+                Captures p_captures);
+
     yy_values::MetricId m_id{};
     MetricData m_metric_data{};
     std::string m_property{};
 
+    labels::ReplacePaths m_replace_paths{};
     LabelActions m_label_actions{};
+    values::ValueProgram m_value_program{};
     ValueActions m_value_actions{};
     LabelActions m_metric_property_actions{};
     Labels m_metric_properties{};
     yy_prometheus::MetricType m_metric_type;
     yy_prometheus::MetricUnit m_metric_unit;
     yy_prometheus::MetricFormatFn m_metric_format = &yy_prometheus::NoFormat;
-
+    LabelCache m_label_cache;
+    NumberBuffer m_number{};
+    // Set for histograms & summaries, whose values are observed by
+    // a series rather than published, and for aggregates, whose values
+    // are observed & published.
+    distributions::FamilyPtr m_distribution{};
+    std::string m_series_labels{};
+    // Allocated on the first captured labels of a distribution.
+    SeriesCachePtr m_series_cache{};
+    size_type m_series_cache_size = 0;
+    std::string m_series_key{};
 };
 
 using MetricPtr = std::shared_ptr<Metric>;
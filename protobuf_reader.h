@@ -0,0 +1,203 @@
+/*
+
+  MIT License
+
+  Copyright (c) 2025 Yafiyogi
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+#include "yy_cpp/yy_types.hpp"
+
+namespace yafiyogi::mqtt_bridge::protobuf {
+
+enum class WireType:uint8_t {Varint = 0, Fixed64 = 1, Len = 2, StartGroup = 3, EndGroup = 4, Fixed32 = 5};
+
+// Reads protobuf wire format fields in place. Length delimited fields
+// are views into the data; nested messages are read with a Reader over
+// their view.
+class Reader final
+{
+  public:
+    constexpr explicit Reader(std::string_view p_data) noexcept:
+      m_data(p_data)
+    {
+    }
+
+    Reader() = delete;
+    constexpr Reader(const Reader &) noexcept = default;
+    constexpr Reader(Reader &&) noexcept = default;
+
+    constexpr Reader & operator=(const Reader &) noexcept = default;
+    constexpr Reader & operator=(Reader &&) noexcept = default;
+
+    // Reads the next field's tag. Returns false at the end of the data,
+    // or on a malformed tag (see ok()).
+    [[nodiscard]]
+    constexpr bool next(std::uint32_t & p_field,
+                        WireType & p_wire_type) noexcept
+    {
+      if(m_pos >= m_data.size())
+      {
+        return false;
+      }
+
+      std::uint64_t tag = 0;
+      if(!varint(tag) || (0 == (tag >> 3)) || ((tag & 7) > 5))
+      {
+        m_ok = false;
+        return false;
+      }
+
+      p_field = static_cast<std::uint32_t>(tag >> 3);
+      p_wire_type = static_cast<WireType>(tag & 7);
+
+      return true;
+    }
+
+    [[nodiscard]]
+    constexpr bool varint(std::uint64_t & p_value) noexcept
+    {
+      p_value = 0;
+
+      for(int shift = 0; shift < 64; shift += 7)
+      {
+        if(m_pos >= m_data.size())
+        {
+          return fail();
+        }
+
+        const auto byte = static_cast<std::uint8_t>(m_data[m_pos++]);
+        p_value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+
+        if(0 == (byte & 0x80))
+        {
+          return true;
+        }
+      }
+
+      return fail();
+    }
+
+    [[nodiscard]]
+    constexpr bool fixed32(std::uint32_t & p_value) noexcept
+    {
+      std::uint64_t value = 0;
+      if(!little_endian(4, value))
+      {
+        return false;
+      }
+      p_value = static_cast<std::uint32_t>(value);
+
+      return true;
+    }
+
+    [[nodiscard]]
+    constexpr bool fixed64(std::uint64_t & p_value) noexcept
+    {
+      return little_endian(8, p_value);
+    }
+
+    [[nodiscard]]
+    constexpr bool bytes(std::string_view & p_value) noexcept
+    {
+      std::uint64_t size = 0;
+      if(!varint(size) || (size > (m_data.size() - m_pos)))
+      {
+        return fail();
+      }
+
+      p_value = m_data.substr(m_pos, static_cast<size_type>(size));
+      m_pos += static_cast<size_type>(size);
+
+      return true;
+    }
+
+    // Skips the value of a field. Groups are deprecated and not
+    // supported.
+    [[nodiscard]]
+    constexpr bool skip(WireType p_wire_type) noexcept
+    {
+      std::uint64_t num = 0;
+      std::uint32_t num32 = 0;
+      std::string_view str{};
+
+      switch(p_wire_type)
+      {
+        case WireType::Varint:
+          return varint(num);
+
+        case WireType::Fixed64:
+          return fixed64(num);
+
+        case WireType::Len:
+          return bytes(str);
+
+        case WireType::Fixed32:
+          return fixed32(num32);
+
+        default:
+          return fail();
+      }
+    }
+
+    // False once malformed data was read.
+    [[nodiscard]]
+    constexpr bool ok() const noexcept
+    {
+      return m_ok;
+    }
+
+  private:
+    constexpr bool fail() noexcept
+    {
+      m_ok = false;
+      return false;
+    }
+
+    constexpr bool little_endian(size_type p_size,
+                                 std::uint64_t & p_value) noexcept
+    {
+      if(p_size > (m_data.size() - m_pos))
+      {
+        return fail();
+      }
+
+      p_value = 0;
+      for(size_type idx = 0; idx < p_size; ++idx)
+      {
+        p_value |= static_cast<std::uint64_t>(static_cast<std::uint8_t>(m_data[m_pos + idx])) << (8 * idx);
+      }
+      m_pos += p_size;
+
+      return true;
+    }
+
+    std::string_view m_data{};
+    size_type m_pos = 0;
+    bool m_ok = true;
+};
+
+} // namespace yafiyogi::mqtt_bridge::protobuf
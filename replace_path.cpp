@@ -0,0 +1,307 @@
+/*
+
+  MIT License
+
+  Copyright (c) 2025 Yafiyogi
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+#include <algorithm>
+#include <charconv>
+#include <string_view>
+#include <system_error>
+
+#include "yy_mqtt/yy_mqtt_util.h"
+
+#include "replace_path.h"
+
+namespace yafiyogi::mqtt_bridge::labels {
+
+using namespace std::string_view_literals;
+
+namespace {
+
+constexpr std::string_view g_single_level{"+"};
+constexpr std::string_view g_multi_level{"#"};
+
+// True if every topic p_filter matches is matched by p_pattern. A
+// topic is a filter without wildcards.
+template<typename Pattern, typename Filter>
+bool covers(const Pattern & p_pattern,
+            const Filter & p_filter) noexcept
+{
+  size_type idx = 0;
+  for(; idx < p_pattern.size(); ++idx)
+  {
+    const std::string_view pattern{p_pattern[idx]};
+
+    // 'a/#' also matches 'a'.
+    if(g_multi_level == pattern)
+    {
+      return true;
+    }
+
+    if(idx == p_filter.size())
+    {
+      return false;
+    }
+
+    const std::string_view filter{p_filter[idx]};
+    if(g_multi_level == filter)
+    {
+      return false;
+    }
+
+    if((g_single_level != pattern) && (pattern != filter))
+    {
+      return false;
+    }
+  }
+
+  return idx == p_filter.size();
+}
+
+// True if a topic can match both p_pattern & p_filter.
+template<typename Pattern, typename Filter>
+bool overlaps(const Pattern & p_pattern,
+              const Filter & p_filter) noexcept
+{
+  const size_type size = std::min(p_pattern.size(), p_filter.size());
+
+  for(size_type idx = 0; idx < size; ++idx)
+  {
+    const std::string_view pattern{p_pattern[idx]};
+    const std::string_view filter{p_filter[idx]};
+
+    if((g_multi_level == pattern) || (g_multi_level == filter))
+    {
+      return true;
+    }
+
+    if((g_single_level != pattern)
+       && (g_single_level != filter)
+       && (pattern != filter))
+    {
+      return false;
+    }
+  }
+
+  if(p_pattern.size() > size)
+  {
+    return ((size + 1) == p_pattern.size()) && (g_multi_level == p_pattern[size]);
+  }
+
+  if(p_filter.size() > size)
+  {
+    return ((size + 1) == p_filter.size()) && (g_multi_level == p_filter[size]);
+  }
+
+  return true;
+}
+
+} // anonymous namespace
+
+PathFormat::PathFormat(std::string_view p_format)
+{
+  while(!p_format.empty())
+  {
+    const auto pos = p_format.find('\\');
+
+    AddText(p_format.substr(0, pos));
+    if(std::string_view::npos == pos)
+    {
+      break;
+    }
+    p_format.remove_prefix(pos + 1);
+
+    if(p_format.starts_with('\\'))
+    {
+      AddText("\\"sv);
+      p_format.remove_prefix(1);
+      continue;
+    }
+
+    size_type level = 0;
+    if(auto [ptr, ec] = std::from_chars(p_format.data(), p_format.data() + p_format.size(), level);
+       (std::errc{} == ec) && (0 != level))
+    {
+      m_segments.emplace_back(Segment{std::string{}, level - 1});
+      p_format.remove_prefix(static_cast<size_type>(ptr - p_format.data()));
+    }
+    else
+    {
+      AddText("\\"sv);
+    }
+  }
+}
+
+PathFormat PathFormat::Resolve(const yy_mqtt::TopicLevelsView & p_filter) const
+{
+  // Levels from a '#' on are only known from the topic.
+  const auto multi_level = static_cast<size_type>(std::distance(p_filter.begin(),
+                                                                std::find(p_filter.begin(), p_filter.end(), g_multi_level)));
+  PathFormat format{};
+
+  for(const auto & segment : m_segments)
+  {
+    if(no_level == segment.level)
+    {
+      format.AddText(segment.text);
+    }
+    else if((segment.level >= multi_level)
+            || ((segment.level < p_filter.size()) && (g_single_level == p_filter[segment.level])))
+    {
+      format.m_segments.emplace_back(segment);
+    }
+    else if(segment.level < p_filter.size())
+    {
+      format.AddText(p_filter[segment.level]);
+    }
+  }
+
+  return format;
+}
+
+void PathFormat::Format(const yy_mqtt::TopicLevelsView & p_levels,
+                        std::string & p_label) const
+{
+  p_label.clear();
+
+  for(const auto & segment : m_segments)
+  {
+    if(no_level == segment.level)
+    {
+      p_label.append(segment.text);
+    }
+    else if(segment.level < p_levels.size())
+    {
+      p_label.append(p_levels[segment.level]);
+    }
+  }
+}
+
+void PathFormat::AddText(std::string_view p_text)
+{
+  if(p_text.empty())
+  {
+    return;
+  }
+
+  if(!m_segments.empty() && (no_level == m_segments.back().level))
+  {
+    m_segments.back().text.append(p_text);
+  }
+  else
+  {
+    m_segments.emplace_back(Segment{std::string{p_text}, no_level});
+  }
+}
+
+ReplacePath::ReplacePath(std::string && p_target,
+                         Replaces && p_replaces):
+  m_target(std::move(p_target))
+{
+  m_patterns.reserve(p_replaces.size());
+
+  for(auto & replace : p_replaces)
+  {
+    auto & pattern = m_patterns.emplace_back(Pattern{{}, std::move(replace.format)});
+
+    if(!replace.pattern.empty())
+    {
+      yy_mqtt::topic_tokenize_view(m_filter_levels, replace.pattern);
+      pattern.levels.reserve(m_filter_levels.size());
+      for(const auto level : m_filter_levels)
+      {
+        pattern.levels.emplace_back(level);
+      }
+    }
+  }
+}
+
+void ReplacePath::Apply(const TopicMatch & p_match,
+                        Labels & p_labels)
+{
+  const auto & filter = Resolve(p_match.filter);
+  const PathFormat * format = nullptr;
+
+  switch(filter.resolution)
+  {
+    case Resolution::Format:
+      format = &filter.format;
+      break;
+
+    case Resolution::Topic:
+      if(auto found = std::ranges::find_if(m_patterns, [&p_match](const Pattern & p_pattern) {
+        return p_pattern.levels.empty() || covers(p_pattern.levels, p_match.levels);
+      });
+         m_patterns.end() != found)
+      {
+        format = &found->format;
+      }
+      break;
+
+    default:
+      break;
+  }
+
+  if(nullptr != format)
+  {
+    format->Format(p_match.levels, m_label);
+    p_labels.set_label(m_target, m_label);
+  }
+}
+
+const ReplacePath::Filter & ReplacePath::Resolve(const TopicFilter & p_filter)
+{
+  while(p_filter.id >= m_filters.size())
+  {
+    m_filters.emplace_back();
+  }
+
+  auto & filter = m_filters[p_filter.id];
+
+  if(Resolution::Unresolved == filter.resolution)
+  {
+    yy_mqtt::topic_tokenize_view(m_filter_levels, p_filter.filter);
+    filter.resolution = Resolution::None;
+
+    for(const auto & pattern : m_patterns)
+    {
+      if(pattern.levels.empty() || covers(pattern.levels, m_filter_levels))
+      {
+        filter.resolution = Resolution::Format;
+        filter.format = pattern.format.Resolve(m_filter_levels);
+        break;
+      }
+
+      if(overlaps(pattern.levels, m_filter_levels))
+      {
+        filter.resolution = Resolution::Topic;
+        break;
+      }
+    }
+  }
+
+  return filter;
+}
+
+} // namespace yafiyogi::mqtt_bridge::labels
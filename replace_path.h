@@ -0,0 +1,135 @@
+/*
+
+  MIT License
+
+  Copyright (c) 2025 Yafiyogi
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+
+#include "yy_cpp/yy_types.hpp"
+#include "yy_cpp/yy_vector.h"
+
+#include "yy_mqtt/yy_mqtt_types.h"
+
+#include "yy_values/yy_values_labels.hpp"
+
+#include "topic_match.h"
+
+namespace yafiyogi::mqtt_bridge::labels {
+
+// A 'replace-path' format, e.g. '\2:\3', compiled to text & the topic
+// levels it copies. '\N' is topic level N (from 1), '\\' is a '\'.
+class PathFormat final
+{
+  public:
+    PathFormat() noexcept = default;
+    explicit PathFormat(std::string_view p_format);
+
+    // References to levels that are literal in p_filter are replaced
+    // by the literal, so only the filter's wildcards are copied.
+    [[nodiscard]]
+    PathFormat Resolve(const yy_mqtt::TopicLevelsView & p_filter) const;
+
+    void Format(const yy_mqtt::TopicLevelsView & p_levels,
+                std::string & p_label) const;
+
+  private:
+    static constexpr size_type no_level = std::numeric_limits<size_type>::max();
+
+    struct Segment final
+    {
+        std::string text{};
+        size_type level = no_level;
+    };
+
+    void AddText(std::string_view p_text);
+
+    yy_quad::simple_vector<Segment> m_segments{};
+};
+
+// Sets the target label to the format of the first pattern a topic
+// matches. A replacement without a pattern matches every topic.
+//
+// Which replacement a topic uses is resolved once per filter, on the
+// filter's first topic: if every topic of the filter matches the same
+// pattern, its format is resolved against the filter & applied to the
+// filter's topics without matching. Only filters that overlap a
+// pattern without being covered by it match each topic.
+class ReplacePath final
+{
+  public:
+    using Labels = yy_values::Labels;
+
+    struct Replace final
+    {
+        std::string pattern{};
+        PathFormat format{};
+    };
+
+    using Replaces = yy_quad::simple_vector<Replace>;
+
+    explicit ReplacePath(std::string && p_target,
+                         Replaces && p_replaces);
+
+    ReplacePath() = delete;
+    ReplacePath(const ReplacePath &) = delete;
+    ReplacePath(ReplacePath &&) noexcept = default;
+
+    ReplacePath & operator=(const ReplacePath &) = delete;
+    ReplacePath & operator=(ReplacePath &&) noexcept = default;
+
+    void Apply(const TopicMatch & p_match,
+               Labels & p_labels);
+
+  private:
+    enum class Resolution:uint8_t {Unresolved, None, Format, Topic};
+
+    struct Pattern final
+    {
+        yy_quad::simple_vector<std::string> levels{};
+        PathFormat format{};
+    };
+
+    struct Filter final
+    {
+        Resolution resolution = Resolution::Unresolved;
+        PathFormat format{};
+    };
+
+    const Filter & Resolve(const TopicFilter & p_filter);
+
+    std::string m_target{};
+    yy_quad::simple_vector<Pattern> m_patterns{};
+    yy_quad::simple_vector<Filter> m_filters{};
+    yy_mqtt::TopicLevelsView m_filter_levels{};
+    std::string m_label{};
+};
+
+using ReplacePaths = yy_quad::simple_vector<ReplacePath>;
+
+} // namespace yafiyogi::mqtt_bridge::labels
@@ -0,0 +1,85 @@
+/*
+
+  MIT License
+
+  Copyright (c) 2025 Yafiyogi
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+#include <exception>
+#include <map>
+#include <mutex>
+#include <string_view>
+
+#include "spdlog/spdlog.h"
+
+#include "scrape_hooks.h"
+
+namespace yafiyogi::mqtt_bridge {
+namespace {
+
+using namespace std::string_view_literals;
+
+using ScrapeHooks = std::map<ScrapeHookId, ScrapeHook>;
+
+std::mutex g_hooks_mtx{};
+ScrapeHooks g_hooks{};
+ScrapeHookId g_next_hook_id = 0;
+
+} // anonymous namespace
+
+ScrapeHookId add_scrape_hook(ScrapeHook && p_hook)
+{
+  std::unique_lock lck{g_hooks_mtx};
+
+  const auto id = g_next_hook_id++;
+  g_hooks.emplace(id, std::move(p_hook));
+
+  return id;
+}
+
+void remove_scrape_hook(ScrapeHookId p_id) noexcept
+{
+  std::unique_lock lck{g_hooks_mtx};
+
+  g_hooks.erase(p_id);
+}
+
+void run_scrape_hooks()
+{
+  // Held while hooks run, so a hook can't be removed (and its owner
+  // destroyed) mid call.
+  std::unique_lock lck{g_hooks_mtx};
+
+  for(auto & [id, hook] : g_hooks)
+  {
+    try
+    {
+      hook();
+    }
+    catch(const std::exception & ex)
+    {
+      spdlog::error("Scrape hook [{}] failed: [{}]"sv, id, ex.what());
+    }
+  }
+}
+
+} // namespace yafiyogi::mqtt_bridge
@@ -0,0 +1,49 @@
+/*
+
+  MIT License
+
+  Copyright (c) 2025 Yafiyogi
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <functional>
+
+#include "yy_cpp/yy_types.hpp"
+
+namespace yafiyogi::mqtt_bridge {
+
+// Hooks run before metrics are scraped, e.g. to handle messages whose
+// handling was deferred until their metrics are needed.
+
+using ScrapeHook = std::function<void()>;
+using ScrapeHookId = size_type;
+
+[[nodiscard]]
+ScrapeHookId add_scrape_hook(ScrapeHook && p_hook);
+
+// Once removed, the hook won't be called again.
+void remove_scrape_hook(ScrapeHookId p_id) noexcept;
+
+void run_scrape_hooks();
+
+} // namespace yafiyogi::mqtt_bridge
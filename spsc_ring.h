@@ -0,0 +1,193 @@
+/*
+
+  MIT License
+
+  Copyright (c) 2025 Yafiyogi
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <memory>
+
+#include "yy_cpp/yy_types.hpp"
+
+namespace yafiyogi::mqtt_bridge {
+
+// Bounded single producer / single consumer ring.
+//
+// Slots are constructed once and re-used, so a producer that assigns
+// into a slot (e.g. std::string::assign()) doesn't allocate once the
+// slot's capacity has grown to fit.
+template<typename T>
+class SpscRing final
+{
+  public:
+    using value_type = T;
+
+    explicit SpscRing(size_type p_capacity):
+      m_mask(std::bit_ceil(std::max(p_capacity, size_type{2})) - 1),
+      m_slots(std::make_unique<value_type[]>(m_mask + 1))
+    {
+    }
+
+    SpscRing() = delete;
+    SpscRing(const SpscRing &) = delete;
+    SpscRing(SpscRing &&) = delete;
+
+    SpscRing & operator=(const SpscRing &) = delete;
+    SpscRing & operator=(SpscRing &&) = delete;
+
+    [[nodiscard]]
+    constexpr size_type capacity() const noexcept
+    {
+      return m_mask + 1;
+    }
+
+    [[nodiscard]]
+    size_type size() const noexcept
+    {
+      return m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_acquire);
+    }
+
+    // Position of the next slot to be published. Producer only.
+    [[nodiscard]]
+    size_type tail() const noexcept
+    {
+      return m_tail.load(std::memory_order_relaxed);
+    }
+
+    // Position of the oldest unconsumed slot.
+    [[nodiscard]]
+    size_type head() const noexcept
+    {
+      return m_head.load(std::memory_order_acquire);
+    }
+
+    // Slot at a position. Concurrent access to a published slot must
+    // be arbitrated by the caller.
+    [[nodiscard]]
+    value_type & slot(size_type p_pos) noexcept
+    {
+      return m_slots[p_pos & m_mask];
+    }
+
+    // Producer: slot to fill, or nullptr if the ring is full.
+    [[nodiscard]]
+    value_type * try_acquire() noexcept
+    {
+      const size_type tail = m_tail.load(std::memory_order_relaxed);
+
+      if((tail - m_head_cache) > m_mask)
+      {
+        m_head_cache = m_head.load(std::memory_order_acquire);
+
+        if((tail - m_head_cache) > m_mask)
+        {
+          return nullptr;
+        }
+      }
+
+      return &m_slots[tail & m_mask];
+    }
+
+    // Producer: slot to fill, waiting for the consumer if the ring is full.
+    [[nodiscard]]
+    value_type & acquire() noexcept
+    {
+      value_type * slot = try_acquire();
+
+      while(nullptr == slot)
+      {
+        m_head.wait(m_head_cache, std::memory_order_acquire);
+        slot = try_acquire();
+      }
+
+      return *slot;
+    }
+
+    // Producer: make the acquired slot visible to the consumer.
+    void publish() noexcept
+    {
+      m_tail.store(m_tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+      m_tail.notify_one();
+    }
+
+    // Consumer: oldest slot, or nullptr if the ring is empty.
+    [[nodiscard]]
+    value_type * front() noexcept
+    {
+      const size_type head = m_head.load(std::memory_order_relaxed);
+
+      if(head == m_tail_cache)
+      {
+        m_tail_cache = m_tail.load(std::memory_order_acquire);
+
+        if(head == m_tail_cache)
+        {
+          return nullptr;
+        }
+      }
+
+      return &m_slots[head & m_mask];
+    }
+
+    // Consumer: oldest slot, waiting for the producer if the ring is empty.
+    [[nodiscard]]
+    value_type & wait_front() noexcept
+    {
+      value_type * slot = front();
+
+      while(nullptr == slot)
+      {
+        m_tail.wait(m_tail_cache, std::memory_order_acquire);
+        slot = front();
+      }
+
+      return *slot;
+    }
+
+    // Consumer: release the slot returned by front().
+    void pop() noexcept
+    {
+      m_head.store(m_head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+      m_head.notify_one();
+    }
+
+  private:
+    static constexpr size_type cache_line_size = 64;
+
+    // Written by the consumer.
+    alignas(cache_line_size) std::atomic<size_type> m_head{0};
+    size_type m_tail_cache = 0;
+
+    // Written by the producer.
+    alignas(cache_line_size) std::atomic<size_type> m_tail{0};
+    size_type m_head_cache = 0;
+
+    alignas(cache_line_size) size_type m_mask = 0;
+    std::unique_ptr<value_type[]> m_slots{};
+};
+
+} // namespace yafiyogi::mqtt_bridge
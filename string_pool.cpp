@@ -0,0 +1,211 @@
+/*
+
+  MIT License
+
+  Copyright (c) 2025 Yafiyogi
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+#include <array>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+#include "bridge_stats.h"
+
+#include "string_pool.h"
+
+namespace yafiyogi::mqtt_bridge {
+namespace {
+
+using namespace std::string_view_literals;
+
+using Node = string_pool_detail::Node;
+
+// Keys are views of their node's value.
+using Nodes = std::unordered_map<std::string_view, std::unique_ptr<Node>>;
+
+struct PoolStats final
+{
+    stats::StatPtr strings = stats::add_stat("mqtt_bridge_string_pool_strings"sv,
+                                             "Distinct strings in the string pool."sv,
+                                             stats::StatType::Gauge);
+    stats::StatPtr bytes = stats::add_stat("mqtt_bridge_string_pool_bytes"sv,
+                                           "Bytes of string data held by the string pool."sv,
+                                           stats::StatType::Gauge);
+    stats::StatPtr referenced_bytes = stats::add_stat("mqtt_bridge_string_pool_referenced_bytes"sv,
+                                                      "Bytes of string data the route & label caches would hold without interning."sv,
+                                                      stats::StatType::Gauge);
+};
+
+struct Shard final
+{
+    std::mutex mtx{};
+    Nodes nodes{};
+};
+
+// Enough shards that workers filling their caches rarely contend.
+constexpr size_type g_shard_count = 64;
+
+std::array<Shard, g_shard_count> g_shards{};
+std::atomic<size_type> g_next_id{1};
+
+PoolStats & pool_stats()
+{
+  static PoolStats g_pool_stats{};
+
+  return g_pool_stats;
+}
+
+Node * intern(std::string_view p_str)
+{
+  auto & pool = pool_stats();
+  const size_type shard_idx = std::hash<std::string_view>{}(p_str) % g_shard_count;
+  auto & shard = g_shards[shard_idx];
+  std::unique_lock lck{shard.mtx};
+
+  auto node_iter = shard.nodes.find(p_str);
+  if(shard.nodes.end() == node_iter)
+  {
+    auto node = std::make_unique<Node>();
+    node->value.assign(p_str);
+    node->id = g_next_id.fetch_add(1, std::memory_order_relaxed);
+    node->shard = shard_idx;
+
+    const std::string_view key{node->value};
+    node_iter = shard.nodes.emplace(key, std::move(node)).first;
+
+    pool.strings->Add();
+    pool.bytes->Add(p_str.size());
+  }
+
+  auto node = node_iter->second.get();
+  node->refs.fetch_add(1, std::memory_order_relaxed);
+  pool.referenced_bytes->Add(p_str.size());
+
+  return node;
+}
+
+} // anonymous namespace
+
+InternedString::InternedString(std::string_view p_str):
+  m_node(p_str.empty() ? nullptr : intern(p_str))
+{
+}
+
+InternedString::InternedString(const InternedString & p_other) noexcept:
+  m_node(p_other.m_node)
+{
+  if(nullptr != m_node)
+  {
+    // The other handle holds a reference, so the node can't be
+    // released while this one is added.
+    m_node->refs.fetch_add(1, std::memory_order_relaxed);
+    pool_stats().referenced_bytes->Add(m_node->value.size());
+  }
+}
+
+InternedString::InternedString(InternedString && p_other) noexcept:
+  m_node(std::exchange(p_other.m_node, nullptr))
+{
+}
+
+InternedString::~InternedString() noexcept
+{
+  release();
+}
+
+InternedString & InternedString::operator=(const InternedString & p_other) noexcept
+{
+  if(this != &p_other)
+  {
+    InternedString tmp{p_other};
+    *this = std::move(tmp);
+  }
+
+  return *this;
+}
+
+InternedString & InternedString::operator=(InternedString && p_other) noexcept
+{
+  if(this != &p_other)
+  {
+    release();
+    m_node = std::exchange(p_other.m_node, nullptr);
+  }
+
+  return *this;
+}
+
+const std::string & InternedString::str() const noexcept
+{
+  static const std::string g_empty{};
+
+  return nullptr != m_node ? m_node->value : g_empty;
+}
+
+void InternedString::release() noexcept
+{
+  if(nullptr == m_node)
+  {
+    return;
+  }
+
+  auto & pool = pool_stats();
+  const auto size = m_node->value.size();
+
+  // Other handles keep the node, so their references are released
+  // without locking.
+  auto refs = m_node->refs.load(std::memory_order_relaxed);
+  while((refs > 1)
+        && !m_node->refs.compare_exchange_weak(refs,
+                                                refs - 1,
+                                                std::memory_order_acq_rel,
+                                                std::memory_order_relaxed))
+  {
+  }
+
+  if(refs <= 1)
+  {
+    // The last reference is released under the shard's lock, as is
+    // interning, so intern() can't hand out a node that is about to
+    // be freed.
+    auto & shard = g_shards[m_node->shard];
+    std::unique_lock lck{shard.mtx};
+
+    if(1 == m_node->refs.fetch_sub(1, std::memory_order_acq_rel))
+    {
+      pool.strings->Sub(1);
+      pool.bytes->Sub(size);
+      shard.nodes.erase(std::string_view{m_node->value});
+    }
+  }
+
+  pool.referenced_bytes->Sub(size);
+  m_node = nullptr;
+}
+
+} // namespace yafiyogi::mqtt_bridge
@@ -0,0 +1,113 @@
+/*
+
+  MIT License
+
+  Copyright (c) 2025 Yafiyogi
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <string_view>
+
+#include "yy_cpp/yy_types.hpp"
+
+namespace yafiyogi::mqtt_bridge {
+namespace string_pool_detail {
+
+struct Node final
+{
+    std::string value{};
+    size_type id = 0;
+    size_type shard = 0;
+    std::atomic<size_type> refs{0};
+};
+
+} // namespace string_pool_detail
+
+// Handle to a string in the process wide string pool.
+//
+// Equal strings share one copy, which is released when its last handle
+// is destroyed. The pool is sharded by string hash: interning locks the
+// string's shard, as does releasing the last handle. Copying a handle &
+// releasing other handles don't lock. The string's id is stable for as
+// long as the string is interned. The empty string isn't pooled and has
+// id 0.
+//
+// Strings are interned when the route & label caches are filled. The
+// series published from yy_prometheus' MetricDataCache keep their own
+// copies, so the pool's stats only cover the bridge's caches.
+class InternedString final
+{
+  public:
+    constexpr InternedString() noexcept = default;
+    explicit InternedString(std::string_view p_str);
+    InternedString(const InternedString & p_other) noexcept;
+    InternedString(InternedString && p_other) noexcept;
+    ~InternedString() noexcept;
+
+    InternedString & operator=(const InternedString & p_other) noexcept;
+    InternedString & operator=(InternedString && p_other) noexcept;
+
+    [[nodiscard]]
+    const std::string & str() const noexcept;
+
+    [[nodiscard]]
+    operator std::string_view() const noexcept
+    {
+      return str();
+    }
+
+    [[nodiscard]]
+    size_type id() const noexcept
+    {
+      return nullptr != m_node ? m_node->id : size_type{0};
+    }
+
+    [[nodiscard]]
+    bool empty() const noexcept
+    {
+      return nullptr == m_node;
+    }
+
+    [[nodiscard]]
+    friend bool operator==(const InternedString & p_lhs,
+                           const InternedString & p_rhs) noexcept
+    {
+      return p_lhs.m_node == p_rhs.m_node;
+    }
+
+    [[nodiscard]]
+    friend bool operator==(const InternedString & p_lhs,
+                           std::string_view p_rhs) noexcept
+    {
+      return p_lhs.str() == p_rhs;
+    }
+
+  private:
+    void release() noexcept;
+
+    string_pool_detail::Node * m_node = nullptr;
+};
+
+} // namespace yafiyogi::mqtt_bridge
@@ -0,0 +1,214 @@
+/*
+
+  MIT License
+
+  Copyright (c) 2025 Yafiyogi
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <cstdint>
+
+#include <algorithm>
+#include <bit>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "yy_cpp/yy_types.hpp"
+
+namespace yafiyogi::mqtt_bridge {
+
+// Bounded topic keyed cache.
+//
+// Set associative: a topic hashes to a set of 'ways' slots, and a miss
+// evicts the least recently used slot of that set. Hashes & usage ticks
+// are kept apart from the entries so a lookup only touches one or two
+// cache lines before comparing a key. Entries never move, so views into
+// an entry's key remain valid until the entry is evicted.
+//
+// Key is std::string, or a type constructible from & comparable with a
+// std::string_view (e.g. InternedString).
+//
+// Not thread safe.
+template<typename Value,
+         typename Key = std::string>
+class TopicCache final
+{
+  public:
+    using value_type = Value;
+    using key_type = Key;
+    using hash_type = std::size_t;
+
+    struct Entry final
+    {
+        key_type key{};
+        value_type value{};
+    };
+
+    static constexpr size_type ways = 4;
+
+    explicit TopicCache(size_type p_capacity):
+      m_set_mask(std::bit_ceil(std::max(p_capacity / ways, size_type{1})) - 1),
+      m_hashes(std::make_unique<hash_type[]>(capacity())),
+      m_ticks(std::make_unique<std::uint64_t[]>(capacity())),
+      m_entries(std::make_unique<Entry[]>(capacity()))
+    {
+    }
+
+    TopicCache() = delete;
+    TopicCache(const TopicCache &) = delete;
+    TopicCache(TopicCache &&) noexcept = default;
+
+    TopicCache & operator=(const TopicCache &) = delete;
+    TopicCache & operator=(TopicCache &&) noexcept = default;
+
+    [[nodiscard]]
+    static hash_type hash(std::string_view p_key) noexcept
+    {
+      return std::hash<std::string_view>{}(p_key);
+    }
+
+    [[nodiscard]]
+    constexpr size_type capacity() const noexcept
+    {
+      return (m_set_mask + 1) * ways;
+    }
+
+    [[nodiscard]]
+    size_type size() const noexcept
+    {
+      return m_size;
+    }
+
+    [[nodiscard]]
+    Entry * find(std::string_view p_key,
+                 hash_type p_hash) noexcept
+    {
+      const size_type first = set_begin(p_hash);
+
+      for(size_type idx = first; idx < first + ways; ++idx)
+      {
+        if((0 != m_ticks[idx])
+           && (p_hash == m_hashes[idx])
+           && (p_key == m_entries[idx].key))
+        {
+          m_ticks[idx] = ++m_tick;
+          return &m_entries[idx];
+        }
+      }
+
+      return nullptr;
+    }
+
+    [[nodiscard]]
+    Entry * find(std::string_view p_key) noexcept
+    {
+      return find(p_key, hash(p_key));
+    }
+
+    // Adds an entry for a key that isn't in the cache. If the set is
+    // full its least recently used entry is passed to p_evict() before
+    // being re-used. The returned entry's value is as it was left by
+    // the entry's previous key (if any) so its storage can be re-used.
+    template<typename Evict>
+    Entry & emplace(std::string_view p_key,
+                    hash_type p_hash,
+                    Evict && p_evict)
+    {
+      const size_type first = set_begin(p_hash);
+      size_type victim = first;
+
+      for(size_type idx = first; idx < first + ways; ++idx)
+      {
+        if(m_ticks[idx] < m_ticks[victim])
+        {
+          victim = idx;
+        }
+      }
+
+      auto & entry = m_entries[victim];
+      if(0 != m_ticks[victim])
+      {
+        p_evict(entry);
+      }
+      else
+      {
+        ++m_size;
+      }
+
+      if constexpr(std::is_same_v<key_type, std::string>)
+      {
+        entry.key.assign(p_key);
+      }
+      else
+      {
+        entry.key = key_type{p_key};
+      }
+      m_hashes[victim] = p_hash;
+      m_ticks[victim] = ++m_tick;
+
+      return entry;
+    }
+
+    Entry & emplace(std::string_view p_key,
+                    hash_type p_hash)
+    {
+      return emplace(p_key, p_hash, [](Entry &) {});
+    }
+
+    template<typename Visitor>
+    void visit(Visitor && p_visitor)
+    {
+      for(size_type idx = 0; idx < capacity(); ++idx)
+      {
+        if(0 != m_ticks[idx])
+        {
+          p_visitor(m_entries[idx]);
+        }
+      }
+    }
+
+    void clear() noexcept
+    {
+      std::fill_n(m_ticks.get(), capacity(), std::uint64_t{0});
+      m_size = 0;
+    }
+
+  private:
+    [[nodiscard]]
+    constexpr size_type set_begin(hash_type p_hash) const noexcept
+    {
+      return (static_cast<size_type>(p_hash) & m_set_mask) * ways;
+    }
+
+    size_type m_set_mask = 0;
+    std::unique_ptr<hash_type[]> m_hashes{};
+    std::unique_ptr<std::uint64_t[]> m_ticks{};
+    std::unique_ptr<Entry[]> m_entries{};
+    std::uint64_t m_tick = 0;
+    size_type m_size = 0;
+};
+
+} // namespace yafiyogi::mqtt_bridge
@@ -0,0 +1,54 @@
+/*
+
+  MIT License
+
+  Copyright (c) 2025 Yafiyogi
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <string>
+
+#include "yy_cpp/yy_types.hpp"
+
+#include "yy_mqtt/yy_mqtt_types.h"
+
+namespace yafiyogi::mqtt_bridge {
+
+// A subscription filter. Filters are numbered from 0, in the order
+// they are added to the Topics automaton.
+struct TopicFilter final
+{
+    size_type id = 0;
+    std::string filter{};
+};
+
+// A topic's levels, and the filter the Topics automaton matched it
+// with. Level N of the topic is wildcard capture N if the filter has
+// a wildcard at N, otherwise it is the filter's level.
+struct TopicMatch final
+{
+    const yy_mqtt::TopicLevelsView & levels;
+    const TopicFilter & filter;
+};
+
+} // namespace yafiyogi::mqtt_bridge
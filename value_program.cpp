@@ -0,0 +1,738 @@
+/*
+
+  MIT License
+
+  Copyright (c) 2025 Yafiyogi
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <system_error>
+#include <unordered_set>
+#include <vector>
+
+#include "fmt/format.h"
+
+#include "value_program.h"
+
+namespace yafiyogi::mqtt_bridge::values {
+
+using namespace std::string_view_literals;
+
+namespace {
+
+constexpr std::uint64_t max_seeds = 256;
+
+} // anonymous namespace
+
+// Recursive descent compiler:
+//   expr    : term (('+' | '-') term)*
+//   term    : unary (('*' | '/') unary)*
+//   unary   : '-' unary | primary
+//   primary : number | 'value' | function '(' args ')' | '(' expr ')'
+class Expression::Compiler final
+{
+  public:
+    explicit Compiler(std::string_view p_source) noexcept:
+      m_source(p_source)
+    {
+    }
+
+    bool compile(Code & p_code,
+                 std::string & p_error)
+    {
+      m_code = &p_code;
+
+      if(!expr())
+      {
+        p_error = std::move(m_error);
+        return false;
+      }
+
+      skip_space();
+      if(m_pos != m_source.size())
+      {
+        p_error = fmt::format("unexpected [{}] at {}", m_source.substr(m_pos), m_pos);
+        return false;
+      }
+
+      return true;
+    }
+
+  private:
+    struct Function final
+    {
+        std::string_view name{};
+        size_type arity = 0;
+        Op op = Op::Const;
+    };
+
+    static constexpr std::array<Function, 7> functions{{{"abs"sv, 1, Op::Abs},
+                                                         {"ceil"sv, 1, Op::Ceil},
+                                                         {"clamp"sv, 3, Op::Clamp},
+                                                         {"floor"sv, 1, Op::Floor},
+                                                         {"max"sv, 2, Op::Max},
+                                                         {"min"sv, 2, Op::Min},
+                                                         {"round"sv, 1, Op::Round}}};
+
+    void skip_space() noexcept
+    {
+      while((m_pos < m_source.size()) && std::isspace(static_cast<unsigned char>(m_source[m_pos])))
+      {
+        ++m_pos;
+      }
+    }
+
+    bool accept(char p_ch) noexcept
+    {
+      skip_space();
+      if((m_pos < m_source.size()) && (p_ch == m_source[m_pos]))
+      {
+        ++m_pos;
+        return true;
+      }
+
+      return false;
+    }
+
+    bool fail(std::string_view p_what)
+    {
+      if(m_error.empty())
+      {
+        m_error = fmt::format("{} at {}", p_what, m_pos);
+      }
+
+      return false;
+    }
+
+    // Emits p_op, folding it into a constant if its arguments are.
+    bool emit(Op p_op,
+              size_type p_arity,
+              double p_constant = 0.0)
+    {
+      auto & code = *m_code;
+
+      if((Op::Const == p_op) || (Op::Value == p_op))
+      {
+        ++m_depth;
+      }
+      else
+      {
+        m_depth = m_depth + 1 - p_arity;
+
+        if((code.size() >= p_arity)
+           && std::all_of(code.end() - static_cast<std::ptrdiff_t>(p_arity), code.end(), [](const auto & p_instruction) {
+             return Op::Const == p_instruction.op;
+           }))
+        {
+          std::array<double, 3> args{};
+          for(size_type idx = 0; idx < p_arity; ++idx)
+          {
+            args[idx] = code[code.size() - p_arity + idx].constant;
+          }
+
+          for(size_type idx = 0; idx < p_arity; ++idx)
+          {
+            code.pop_back();
+          }
+          code.emplace_back(Instruction{Op::Const, apply(p_op, args.data())});
+
+          return true;
+        }
+      }
+
+      m_max_depth = std::max(m_max_depth, m_depth);
+      if(m_max_depth > max_stack)
+      {
+        return fail("expression too deep"sv);
+      }
+
+      code.emplace_back(Instruction{p_op, p_constant});
+
+      return true;
+    }
+
+    bool expr()
+    {
+      if(!term())
+      {
+        return false;
+      }
+
+      while(true)
+      {
+        if(accept('+'))
+        {
+          if(!term() || !emit(Op::Add, 2))
+          {
+            return false;
+          }
+        }
+        else if(accept('-'))
+        {
+          if(!term() || !emit(Op::Sub, 2))
+          {
+            return false;
+          }
+        }
+        else
+        {
+          return true;
+        }
+      }
+    }
+
+    bool term()
+    {
+      if(!unary())
+      {
+        return false;
+      }
+
+      while(true)
+      {
+        if(accept('*'))
+        {
+          if(!unary() || !emit(Op::Mul, 2))
+          {
+            return false;
+          }
+        }
+        else if(accept('/'))
+        {
+          if(!unary() || !emit(Op::Div, 2))
+          {
+            return false;
+          }
+        }
+        else
+        {
+          return true;
+        }
+      }
+    }
+
+    bool unary()
+    {
+      if(accept('-'))
+      {
+        return unary() && emit(Op::Neg, 1);
+      }
+
+      return primary();
+    }
+
+    bool primary()
+    {
+      skip_space();
+      if(m_pos == m_source.size())
+      {
+        return fail("unexpected end"sv);
+      }
+
+      if(accept('('))
+      {
+        if(!expr())
+        {
+          return false;
+        }
+
+        return accept(')') || fail("expected ')'"sv);
+      }
+
+      const char ch = m_source[m_pos];
+      if(std::isdigit(static_cast<unsigned char>(ch)) || ('.' == ch))
+      {
+        double num = 0.0;
+        const char * begin = m_source.data() + m_pos;
+        auto [ptr, ec] = std::from_chars(begin, m_source.data() + m_source.size(), num);
+        if(std::errc{} != ec)
+        {
+          return fail("invalid number"sv);
+        }
+
+        m_pos += static_cast<size_type>(ptr - begin);
+        return emit(Op::Const, 0, num);
+      }
+
+      if(!std::isalpha(static_cast<unsigned char>(ch)))
+      {
+        return fail(fmt::format("unexpected '{}'", ch));
+      }
+
+      const size_type start = m_pos;
+      while((m_pos < m_source.size())
+            && (std::isalnum(static_cast<unsigned char>(m_source[m_pos])) || ('_' == m_source[m_pos])))
+      {
+        ++m_pos;
+      }
+      const auto name = m_source.substr(start, m_pos - start);
+
+      if("value"sv == name)
+      {
+        return emit(Op::Value, 0);
+      }
+
+      const auto function = std::find_if(functions.begin(), functions.end(), [name](const auto & p_function) {
+        return p_function.name == name;
+      });
+
+      if(functions.end() == function)
+      {
+        m_pos = start;
+        return fail(fmt::format("unknown name [{}]", name));
+      }
+
+      if(!accept('('))
+      {
+        return fail("expected '('"sv);
+      }
+
+      for(size_type arg = 0; arg < function->arity; ++arg)
+      {
+        if(((0 != arg) && !accept(','))
+           || !expr())
+        {
+          return fail(fmt::format("[{}] expects {} argument(s)", name, function->arity));
+        }
+      }
+
+      if(!accept(')'))
+      {
+        return fail(fmt::format("[{}] expects {} argument(s)", name, function->arity));
+      }
+
+      return emit(function->op, function->arity);
+    }
+
+    std::string_view m_source{};
+    size_type m_pos = 0;
+    Code * m_code = nullptr;
+    size_type m_depth = 0;
+    size_type m_max_depth = 0;
+    std::string m_error{};
+};
+
+std::optional<Expression> Expression::Compile(std::string_view p_source,
+                                              std::string & p_error)
+{
+  Expression expression{};
+  Compiler compiler{p_source};
+
+  if(!compiler.compile(expression.m_code, p_error))
+  {
+    return std::nullopt;
+  }
+
+  return expression;
+}
+
+double Expression::apply(Op p_op,
+                         const double * p_args) noexcept
+{
+  switch(p_op)
+  {
+    case Op::Add:
+      return p_args[0] + p_args[1];
+
+    case Op::Sub:
+      return p_args[0] - p_args[1];
+
+    case Op::Mul:
+      return p_args[0] * p_args[1];
+
+    case Op::Div:
+      return p_args[0] / p_args[1];
+
+    case Op::Neg:
+      return -p_args[0];
+
+    case Op::Abs:
+      return std::abs(p_args[0]);
+
+    case Op::Ceil:
+      return std::ceil(p_args[0]);
+
+    case Op::Floor:
+      return std::floor(p_args[0]);
+
+    case Op::Round:
+      return std::round(p_args[0]);
+
+    case Op::Min:
+      return std::min(p_args[0], p_args[1]);
+
+    case Op::Max:
+      return std::max(p_args[0], p_args[1]);
+
+    case Op::Clamp:
+      return std::clamp(p_args[0], p_args[1], std::max(p_args[1], p_args[2]));
+
+    default:
+      break;
+  }
+
+  return 0.0;
+}
+
+double Expression::Evaluate(double p_value) const noexcept
+{
+  std::array<double, max_stack> stack{};
+  size_type top = 0;
+
+  for(const auto & instruction : m_code)
+  {
+    switch(instruction.op)
+    {
+      case Op::Const:
+        stack[top++] = instruction.constant;
+        break;
+
+      case Op::Value:
+        stack[top++] = p_value;
+        break;
+
+      case Op::Add:
+        --top;
+        stack[top - 1] += stack[top];
+        break;
+
+      case Op::Sub:
+        --top;
+        stack[top - 1] -= stack[top];
+        break;
+
+      case Op::Mul:
+        --top;
+        stack[top - 1] *= stack[top];
+        break;
+
+      case Op::Div:
+        --top;
+        stack[top - 1] /= stack[top];
+        break;
+
+      case Op::Neg:
+      case Op::Abs:
+      case Op::Ceil:
+      case Op::Floor:
+      case Op::Round:
+        stack[top - 1] = apply(instruction.op, &stack[top - 1]);
+        break;
+
+      case Op::Min:
+      case Op::Max:
+        --top;
+        stack[top - 1] = apply(instruction.op, &stack[top - 1]);
+        break;
+
+      case Op::Clamp:
+        top -= 2;
+        stack[top - 1] = apply(instruction.op, &stack[top - 1]);
+        break;
+    }
+  }
+
+  return 0 != top ? stack[top - 1] : p_value;
+}
+
+Switch::Switch(const Mappings & p_mappings,
+               std::optional<std::string> p_default)
+{
+  std::vector<const std::tuple<std::string, std::string> *> mappings{};
+  mappings.reserve(p_mappings.size());
+  std::unordered_set<std::string_view> keys{};
+  keys.reserve(p_mappings.size());
+  for(const auto & mapping : p_mappings)
+  {
+    // The first of duplicate keys is used.
+    if(keys.emplace(std::get<0>(mapping)).second)
+    {
+      mappings.emplace_back(&mapping);
+    }
+  }
+
+  // Typed numbers are looked up by their shortest text, so a key
+  // written otherwise (e.g. '1.0' or '1e3') is also added in that
+  // form, unless it's a key itself.
+  std::vector<std::tuple<std::string, std::string>> aliases{};
+  aliases.reserve(mappings.size());
+  NumberBuffer buffer{};
+  for(size_type idx = 0, count = mappings.size(); idx < count; ++idx)
+  {
+    const auto & [key, text] = *mappings[idx];
+
+    if(auto number = NumericValue::Parse(key);
+       number.has_value())
+    {
+      if(const auto alias = number.value().Format(buffer);
+         !keys.contains(alias))
+      {
+        const auto & added = aliases.emplace_back(std::string{alias}, text);
+        keys.emplace(std::get<0>(added));
+        mappings.emplace_back(&added);
+      }
+    }
+  }
+
+  // Keys per bucket, and displacements tried per bucket before trying
+  // another seed.
+  constexpr std::uint64_t bucket_keys = 4;
+  constexpr std::uint32_t max_displacements = 1U << 16;
+
+  m_entries.reserve(mappings.size() + 1);
+  for(size_type idx = 0; idx <= mappings.size(); ++idx)
+  {
+    m_entries.emplace_back();
+  }
+  m_buckets = std::max(mappings.size() / bucket_keys, std::uint64_t{1});
+  m_displacements.reserve(m_buckets);
+  for(std::uint64_t idx = 0; idx < m_buckets; ++idx)
+  {
+    m_displacements.emplace_back(0);
+  }
+
+  std::vector<std::uint64_t> hashes(mappings.size());
+  std::vector<size_type> order(mappings.size());
+  std::vector<std::uint64_t> bucket_sizes{};
+
+  // Try seeds, growing the table if none is found.
+  for(std::uint64_t size = std::bit_ceil(std::max(mappings.size() + mappings.size() / 8, std::size_t{1})); ; size *= 2)
+  {
+    m_mask = size - 1;
+
+    for(std::uint64_t seed = 0; seed < max_seeds; ++seed)
+    {
+      m_seed = seed;
+      for(size_type idx = 0; idx < mappings.size(); ++idx)
+      {
+        hashes[idx] = hash(std::get<0>(*mappings[idx]), m_seed);
+      }
+
+      // Place the largest buckets first, while most slots are free.
+      bucket_sizes.assign(m_buckets, 0);
+      for(const auto key_hash : hashes)
+      {
+        ++bucket_sizes[bucket(key_hash)];
+      }
+
+      std::iota(order.begin(), order.end(), size_type{0});
+      std::sort(order.begin(), order.end(), [this, &hashes, &bucket_sizes](size_type p_lhs, size_type p_rhs) {
+        const auto lhs_bucket = bucket(hashes[p_lhs]);
+        const auto rhs_bucket = bucket(hashes[p_rhs]);
+
+        return bucket_sizes[lhs_bucket] != bucket_sizes[rhs_bucket]
+          ? bucket_sizes[lhs_bucket] > bucket_sizes[rhs_bucket]
+          : lhs_bucket < rhs_bucket;
+      });
+
+      m_slots.clear();
+      m_slots.reserve(size);
+      for(std::uint64_t idx = 0; idx < size; ++idx)
+      {
+        m_slots.emplace_back(no_entry);
+      }
+      std::fill(m_displacements.begin(), m_displacements.end(), 0);
+
+      bool perfect = true;
+      for(size_type first = 0; perfect && (first < order.size()); )
+      {
+        const auto key_bucket = bucket(hashes[order[first]]);
+        const size_type last = first + bucket_sizes[key_bucket];
+
+        auto place = [this, &hashes, &order, first, last](std::uint32_t p_displacement) {
+          for(size_type idx = first; idx < last; ++idx)
+          {
+            auto & entry = m_slots[slot(hashes[order[idx]], p_displacement)];
+            if(no_entry != entry)
+            {
+              // Free the bucket's keys placed so far.
+              for(size_type placed = first; placed < idx; ++placed)
+              {
+                m_slots[slot(hashes[order[placed]], p_displacement)] = no_entry;
+              }
+              return false;
+            }
+            entry = static_cast<std::uint32_t>(order[idx]);
+          }
+          return true;
+        };
+
+        std::uint32_t displacement = 0;
+        while((displacement < max_displacements) && !place(displacement))
+        {
+          ++displacement;
+        }
+
+        perfect = displacement < max_displacements;
+        m_displacements[key_bucket] = displacement;
+        first = last;
+      }
+
+      if(perfect)
+      {
+        for(size_type idx = 0; idx < mappings.size(); ++idx)
+        {
+          const auto & [key, text] = *mappings[idx];
+          set_entry(m_entries[idx], key, text);
+        }
+
+        if(p_default.has_value())
+        {
+          set_entry(m_entries.back(), std::string_view{}, p_default.value());
+        }
+
+        return;
+      }
+    }
+  }
+}
+
+void Switch::set_entry(Entry & p_entry,
+                       std::string_view p_key,
+                       std::string_view p_text)
+{
+  p_entry.key = p_key;
+  p_entry.text = p_text;
+  p_entry.used = true;
+
+  if(auto number = NumericValue::Parse(p_text);
+     number.has_value())
+  {
+    p_entry.value = Value{number.value()};
+  }
+  else
+  {
+    p_entry.value = Value{p_entry.text, yy_values::ValueType::String};
+  }
+}
+
+std::uint64_t Switch::hash(std::string_view p_key,
+                           std::uint64_t p_seed) noexcept
+{
+  // Mixes 8 bytes at a time, so most keys take one multiply. The
+  // last 1-7 bytes are read with fixed size (overlapping) loads.
+  constexpr std::uint64_t multiplier = 0x9e3779b97f4a7c15ULL;
+  std::uint64_t hash = (p_seed + p_key.size()) * multiplier;
+  const char * data = p_key.data();
+  size_type size = p_key.size();
+
+  auto mix = [&hash](std::uint64_t p_word) {
+    hash = (hash ^ p_word) * multiplier;
+    hash ^= hash >> 29;
+  };
+
+  for(; size >= 8; data += 8, size -= 8)
+  {
+    std::uint64_t word = 0;
+    std::memcpy(&word, data, sizeof(word));
+    mix(word);
+  }
+
+  if(size >= 4)
+  {
+    std::uint32_t first = 0;
+    std::uint32_t last = 0;
+    std::memcpy(&first, data, sizeof(first));
+    std::memcpy(&last, data + size - sizeof(last), sizeof(last));
+    mix((std::uint64_t{first} << 32) | last);
+  }
+  else if(size > 0)
+  {
+    mix((std::uint64_t{static_cast<std::uint8_t>(data[0])} << 16)
+        | (std::uint64_t{static_cast<std::uint8_t>(data[size / 2])} << 8)
+        | static_cast<std::uint8_t>(data[size - 1]));
+  }
+
+  return hash ^ (hash >> 32);
+}
+
+const Value * Switch::Find(std::string_view p_key) const noexcept
+{
+  const auto key_hash = hash(p_key, m_seed);
+
+  if(const auto idx = m_slots[slot(key_hash, m_displacements[bucket(key_hash)])];
+     no_entry != idx)
+  {
+    if(const auto & entry = m_entries[idx];
+       entry.key == p_key)
+    {
+      return &entry.value;
+    }
+  }
+
+  if(const auto & default_entry = m_entries.back();
+     default_entry.used)
+  {
+    return &default_entry.value;
+  }
+
+  return nullptr;
+}
+
+void ValueProgram::add_action(Expression && p_expression)
+{
+  m_actions.emplace_back(std::move(p_expression));
+}
+
+void ValueProgram::add_action(Switch && p_switch)
+{
+  m_actions.emplace_back(std::move(p_switch));
+}
+
+bool ValueProgram::Run(Value & p_value) const noexcept
+{
+  NumberBuffer buffer{};
+
+  for(const auto & action : m_actions)
+  {
+    if(const auto * expression = std::get_if<Expression>(&action);
+       nullptr != expression)
+    {
+      auto number = p_value.IsNumber()
+                    ? std::optional<NumericValue>{p_value.Number()}
+                    : NumericValue::Parse(p_value.Text(buffer));
+
+      if(!number.has_value())
+      {
+        return false;
+      }
+
+      p_value = Value{NumericValue{expression->Evaluate(number.value().AsDouble())}};
+    }
+    else if(const auto * replacement = std::get<Switch>(action).Find(p_value.Text(buffer));
+            nullptr != replacement)
+    {
+      p_value = *replacement;
+    }
+  }
+
+  return true;
+}
+
+} // namespace yafiyogi::mqtt_bridge::values
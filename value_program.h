@@ -0,0 +1,245 @@
+/*
+
+  MIT License
+
+  Copyright (c) 2025 Yafiyogi
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <variant>
+
+#include "yy_cpp/yy_types.hpp"
+#include "yy_cpp/yy_vector.h"
+
+#include "yy_values/yy_value_type.hpp"
+
+#include "numeric_value.h"
+
+namespace yafiyogi::mqtt_bridge::values {
+
+// A metric's value while value actions are applied: a number, or text.
+class Value final
+{
+  public:
+    constexpr Value() noexcept = default;
+
+    constexpr explicit Value(const NumericValue & p_number) noexcept:
+      m_number(p_number),
+      m_type(p_number.Type()),
+      m_is_number(true)
+    {
+    }
+
+    constexpr explicit Value(std::string_view p_text,
+                             yy_values::ValueType p_type) noexcept:
+      m_text(p_text),
+      m_type(p_type)
+    {
+    }
+
+    [[nodiscard]]
+    constexpr bool IsNumber() const noexcept
+    {
+      return m_is_number;
+    }
+
+    [[nodiscard]]
+    constexpr const NumericValue & Number() const noexcept
+    {
+      return m_number;
+    }
+
+    [[nodiscard]]
+    constexpr yy_values::ValueType Type() const noexcept
+    {
+      return m_type;
+    }
+
+    // The value's text. Numbers are formatted into p_buffer.
+    [[nodiscard]]
+    std::string_view Text(NumberBuffer & p_buffer) const noexcept
+    {
+      return m_is_number ? m_number.Format(p_buffer) : m_text;
+    }
+
+  private:
+    NumericValue m_number{};
+    std::string_view m_text{};
+    yy_values::ValueType m_type = yy_values::ValueType::Unknown;
+    bool m_is_number = false;
+};
+
+// Arithmetic on a numeric value, e.g. 'value * 0.1 - 40', compiled to
+// byte code for a small stack machine. Sub-expressions without 'value'
+// are folded to constants when compiled.
+//
+// Operators: + - * / ( ), unary -.
+// Functions: abs(x), ceil(x), floor(x), round(x), min(x, y),
+//            max(x, y) & clamp(x, lo, hi).
+class Expression final
+{
+  public:
+    static constexpr size_type max_stack = 16;
+
+    constexpr Expression() noexcept = default;
+
+    // Returns std::nullopt, with the reason in p_error, if p_source
+    // isn't a valid expression.
+    [[nodiscard]]
+    static std::optional<Expression> Compile(std::string_view p_source,
+                                             std::string & p_error);
+
+    [[nodiscard]]
+    double Evaluate(double p_value) const noexcept;
+
+  private:
+    enum class Op:uint8_t {Const, Value, Add, Sub, Mul, Div, Neg, Abs, Ceil, Floor, Round, Min, Max, Clamp};
+
+    struct Instruction final
+    {
+        Op op = Op::Const;
+        double constant = 0.0;
+    };
+
+    class Compiler;
+
+    [[nodiscard]]
+    static double apply(Op p_op,
+                        const double * p_args) noexcept;
+
+    using Code = yy_quad::simple_vector<Instruction>;
+
+    Code m_code{};
+};
+
+// Maps text values to replacement values. A perfect hash of the
+// mappings is found when configured, by hash & displace: keys are
+// hashed into buckets of about four keys, and each bucket has a
+// displacement that moves its keys to free slots. The slots take space
+// linear in the number of keys, and a lookup is one hash, two loads &
+// at most one compare. Values not mapped are replaced by the default,
+// if there is one, or else left unchanged.
+class Switch final
+{
+  public:
+    using Mappings = yy_quad::simple_vector<std::tuple<std::string, std::string>>;
+
+    explicit Switch(const Mappings & p_mappings,
+                    std::optional<std::string> p_default = std::nullopt);
+
+    Switch() = delete;
+    Switch(const Switch &) = delete;
+    Switch(Switch &&) noexcept = default;
+
+    Switch & operator=(const Switch &) = delete;
+    Switch & operator=(Switch &&) noexcept = default;
+
+    // The replacement of p_key, or nullptr to leave it unchanged.
+    [[nodiscard]]
+    const Value * Find(std::string_view p_key) const noexcept;
+
+  private:
+    // An entry's value may view its text, so entries are built in
+    // place & never copied.
+    struct Entry final
+    {
+        std::string key{};
+        std::string text{};
+        Value value{};
+        bool used = false;
+    };
+
+    static constexpr std::uint32_t no_entry = static_cast<std::uint32_t>(-1);
+
+    static void set_entry(Entry & p_entry,
+                          std::string_view p_key,
+                          std::string_view p_text);
+    [[nodiscard]]
+    static std::uint64_t hash(std::string_view p_key,
+                              std::uint64_t p_seed) noexcept;
+
+    [[nodiscard]]
+    constexpr std::uint64_t bucket(std::uint64_t p_hash) const noexcept
+    {
+      return ((p_hash >> 32) * m_buckets) >> 32;
+    }
+
+    [[nodiscard]]
+    constexpr std::uint64_t slot(std::uint64_t p_hash,
+                                 std::uint32_t p_displacement) const noexcept
+    {
+      std::uint64_t mixed = p_hash ^ (std::uint64_t{p_displacement} * 0x9e3779b97f4a7c15ULL);
+      mixed ^= mixed >> 32;
+      mixed *= 0xd6e8feb86659fd93ULL;
+      mixed ^= mixed >> 32;
+
+      return mixed & m_mask;
+    }
+
+    // The mappings, followed by the default.
+    yy_quad::simple_vector<Entry> m_entries{};
+    // Index into m_entries of each slot's mapping, or no_entry.
+    yy_quad::simple_vector<std::uint32_t> m_slots{};
+    yy_quad::simple_vector<std::uint32_t> m_displacements{};
+    std::uint64_t m_seed = 0;
+    std::uint64_t m_mask = 0;
+    std::uint64_t m_buckets = 1;
+};
+
+// A metric's compiled value actions, run in order.
+class ValueProgram final
+{
+  public:
+    constexpr ValueProgram() noexcept = default;
+    ValueProgram(const ValueProgram &) = delete;
+    ValueProgram(ValueProgram &&) noexcept = default;
+
+    ValueProgram & operator=(const ValueProgram &) = delete;
+    ValueProgram & operator=(ValueProgram &&) noexcept = default;
+
+    void add_action(Expression && p_expression);
+    void add_action(Switch && p_switch);
+
+    [[nodiscard]]
+    constexpr bool empty() const noexcept
+    {
+      return m_actions.empty();
+    }
+
+    // Returns false if an action can't be applied, i.e. an expression
+    // on text that isn't a number, so the value is dropped.
+    [[nodiscard]]
+    bool Run(Value & p_value) const noexcept;
+
+  private:
+    using Action = std::variant<Expression, Switch>;
+
+    yy_quad::simple_vector<Action> m_actions{};
+};
+
+} // namespace yafiyogi::mqtt_bridge::values
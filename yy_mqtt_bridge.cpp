@@ -29,6 +29,7 @@
 
 #include <exception>
 #include <memory>
+#include <thread>
 
 #include "boost/program_options.hpp"
 #include "fmt/ostream.h"
@@ -57,10 +58,11 @@ namespace yafiyogi {
 namespace {
 
 using ClientPtr = std::shared_ptr<mqtt_bridge::mqtt_client>;
+using Clients = yy_quad::simple_vector<ClientPtr>;
 
 struct MqttBridgeState
 {
-    ClientPtr client{};
+    Clients clients{};
     bool exit_program = false;
 };
 
@@ -74,9 +76,9 @@ LockableMqttBridgeState g_mqtt_bridge_state;
 auto do_exit_program = [](auto & p_mqtt_bridge_state) {
   p_mqtt_bridge_state.exit_program = true;
 
-  if(p_mqtt_bridge_state.client)
+  for(auto & client : p_mqtt_bridge_state.clients)
   {
-    p_mqtt_bridge_state.client->stop();
+    client->stop();
   }
 };
 
@@ -166,6 +168,7 @@ int main(int argc, char* argv[])
   }
 
   auto mqtt_config{mqtt_bridge::configure_mqtt(yaml_mqtt,
+                                               yaml_prometheus,
                                                prometheus_config)};
 
   if(!no_run)
@@ -216,21 +219,38 @@ int main(int argc, char* argv[])
 
     mosqpp::lib_init();
 
-    ClientPtr client;
-    auto do_create_client = [&client, &mqtt_config, &metric_cache](auto & p_mqtt_bridge_state) {
+    Clients clients;
+    auto do_create_clients = [&clients, &mqtt_config, &metric_cache](auto & p_mqtt_bridge_state) {
       if(!p_mqtt_bridge_state.exit_program)
       {
-        client = std::make_shared<mqtt_bridge::mqtt_client>(mqtt_config,
-                                                            metric_cache);
-        p_mqtt_bridge_state.client = client;
+        clients.reserve(mqtt_config.connections);
+        for(size_type connection = 0; connection < mqtt_config.connections; ++connection)
+        {
+          clients.emplace_back(std::make_shared<mqtt_bridge::mqtt_client>(mqtt_config,
+                                                                          connection,
+                                                                          metric_cache));
+        }
+        p_mqtt_bridge_state.clients = clients;
       }
     };
 
     try
     {
-      LockMqttBridgeState::visit(g_mqtt_bridge_state, do_create_client);
+      LockMqttBridgeState::visit(g_mqtt_bridge_state, do_create_clients);
+
+      // Each connection has its own network thread.
+      yy_quad::simple_vector<std::thread> client_threads{};
+      client_threads.reserve(clients.size());
+
+      for(auto & client : clients)
+      {
+        client_threads.emplace_back([client]() { client->run(); });
+      }
 
-      client->run();
+      for(auto & client_thread : client_threads)
+      {
+        client_thread.join();
+      }
     }
     catch(const std::exception & ex)
     {